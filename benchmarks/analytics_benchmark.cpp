@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/analytics.h"
+#include "support/market_data.h"
+
+/*
+ * Derived values read on every tick: recomputed by walking the levels of the book on every read
+ * against maintained by the book with EnabledAnalytics.
+ * Every iteration applies a depth update and then reads mid, spread, microprice, imbalance, depth to 5 levels
+ * and VWAP to size of both sides `state.range(0)` times.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    constexpr std::size_t MessagesCount = 1024;
+    constexpr std::size_t DepthLevels = 5;
+    constexpr double FillQuantity = 0.5;
+
+    struct Values {
+        double Mid = 0;
+        double Spread = 0;
+        double Microprice = 0;
+        double Imbalance = 0;
+        double BidsDepth = 0;
+        double AsksDepth = 0;
+        std::optional<double> BuyPrice;
+        std::optional<double> SellPrice;
+    };
+
+    // What every consumer does without the analytics: a walk over the levels of both sides.
+    template <typename TBook>
+    Values Recompute(const TBook& book) {
+        Values values;
+        const auto [bids, asks] = book.Levels();
+
+        auto walk = [](const auto& levels, double& best, double& bestQuantity, double& depth, std::optional<double>& vwap) {
+            double remaining = FillQuantity;
+            double notional = 0;
+            std::size_t index = 0;
+
+            for (auto level : levels) {
+                if (index == 0) {
+                    best = level.Price;
+                    bestQuantity = level.Quantity;
+                }
+                if (index < DepthLevels) {
+                    depth += level.Quantity;
+                }
+                if (remaining > 0) {
+                    const double taken = std::min(remaining, level.Quantity);
+                    notional += taken * level.Price;
+                    remaining -= taken;
+                }
+                ++index;
+            }
+
+            if (remaining <= 0) {
+                vwap = notional / FillQuantity;
+            }
+        };
+
+        double bid = 0, bidQuantity = 0, ask = 0, askQuantity = 0;
+        walk(bids, bid, bidQuantity, values.BidsDepth, values.SellPrice);
+        walk(asks, ask, askQuantity, values.AsksDepth, values.BuyPrice);
+
+        values.Mid = (bid + ask) / 2;
+        values.Spread = ask - bid;
+        values.Microprice = (bid * askQuantity + ask * bidQuantity) / (bidQuantity + askQuantity);
+        values.Imbalance = (bidQuantity - askQuantity) / (bidQuantity + askQuantity);
+
+        return values;
+    }
+
+    template <typename TBook>
+    Values Maintained(const TBook& book) {
+        const auto analytics = book.Analytics();
+
+        return {
+            .Mid = *analytics.Mid(),
+            .Spread = *analytics.Spread(),
+            .Microprice = *analytics.Microprice(),
+            .Imbalance = *analytics.Imbalance(),
+            .BidsDepth = analytics.CumulativeDepth(BookSide::Bids, DepthLevels),
+            .AsksDepth = analytics.CumulativeDepth(BookSide::Asks, DepthLevels),
+            .BuyPrice = analytics.VwapToSize(BookSide::Asks, FillQuantity),
+            .SellPrice = analytics.VwapToSize(BookSide::Bids, FillQuantity),
+        };
+    }
+
+    template <typename TAnalytics>
+    void BM_ReadAnalytics(benchmark::State& state) {
+        const auto readsPerUpdate = state.range(0);
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20, 42,
+                                                                                Support::Distribution::RecordedLike);
+
+        BinanceBook<double, double, 20, FlatMapStorage, DisabledInstrumentation, TAnalytics> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+
+            for (int64_t read = 0; read < readsPerUpdate; ++read) {
+                if constexpr (TAnalytics::Enabled) {
+                    benchmark::DoNotOptimize(Maintained(book));
+                } else {
+                    benchmark::DoNotOptimize(Recompute(book));
+                }
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * readsPerUpdate);
+    }
+
+}
+
+BENCHMARK_TEMPLATE(BM_ReadAnalytics, DisabledAnalytics)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK_TEMPLATE(BM_ReadAnalytics, EnabledAnalytics)->Arg(1)->Arg(4)->Arg(16);
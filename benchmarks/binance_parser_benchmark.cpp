@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/models/fixed_point.h"
+#include "src/parsers/binance_parser.h"
+#include "support/payloads.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TFixedPrice = Models::Price<2>;
+    using TFixedQuantity = Models::Quantity<8>;
+
+    template <typename TPrice, typename TQuantity>
+    void BM_ParseDepth(benchmark::State& state) {
+        for (auto _ : state) {
+            auto message = Parsers::ParseDepth<TPrice, TQuantity>(Support::DepthPayload);
+
+            for (auto level : message->Bids) {
+                benchmark::DoNotOptimize(level);
+            }
+            for (auto level : message->Asks) {
+                benchmark::DoNotOptimize(level);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * Support::DepthPayload.size());
+    }
+
+    template <typename TPrice, typename TQuantity>
+    void BM_ParseDepthIntoBook(benchmark::State& state) {
+        BinanceBook<TPrice, TQuantity, 20> book;
+
+        for (auto _ : state) {
+            auto message = Parsers::ParseDepth<TPrice, TQuantity>(Support::CombinedDepthPayload);
+            book.Replace(message->Bids, message->Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * Support::CombinedDepthPayload.size());
+    }
+
+    template <typename TPrice, typename TQuantity>
+    void BM_ParseBookTickerIntoBook(benchmark::State& state) {
+        BinanceBook<TPrice, TQuantity, 20> book;
+        book.BBOUpdate(Parsers::ParseBookTicker<TPrice, TQuantity>(Support::BookTickerPayload)->Ticker);
+
+        for (auto _ : state) {
+            auto message = Parsers::ParseBookTicker<TPrice, TQuantity>(Support::BookTickerPayload);
+            book.BBOUpdate(message->Ticker);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.SetBytesProcessed(state.iterations() * Support::BookTickerPayload.size());
+    }
+
+}
+
+// items_per_second is the number of messages per second, Time is ns per message.
+BENCHMARK_TEMPLATE(BM_ParseDepth, double, double);
+BENCHMARK_TEMPLATE(BM_ParseDepth, TFixedPrice, TFixedQuantity);
+BENCHMARK_TEMPLATE(BM_ParseDepthIntoBook, double, double);
+BENCHMARK_TEMPLATE(BM_ParseDepthIntoBook, TFixedPrice, TFixedQuantity);
+BENCHMARK_TEMPLATE(BM_ParseBookTickerIntoBook, double, double);
+BENCHMARK_TEMPLATE(BM_ParseBookTickerIntoBook, TFixedPrice, TFixedQuantity);
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/book_pool.h"
+#include "src/order_book.h"
+#include "src/utils/memory_region.h"
+#include "support/market_data.h"
+
+/*
+ * One core updating hundreds of books: books allocated one by one on the heap against books placed side by side
+ * in a BookPool with regular or huge pages. Heap books are interleaved with other allocations of the process,
+ * as they would be after a day of subscriptions, so every book is on its own pages.
+ * Every iteration applies a BBO update and a small depth update to every book in a random order.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+
+    constexpr std::size_t MessagesCount = 64;
+    constexpr std::size_t NoiseSize = 16 * 1024;
+
+    // Books visited in a fixed random order, so hardware prefetchers can't hide the misses.
+    std::vector<std::size_t> VisitOrder(std::size_t count) {
+        std::vector<std::size_t> order(count);
+        for (std::size_t index = 0; index < count; ++index) {
+            order[index] = index;
+        }
+
+        std::mt19937 random(42);
+        std::shuffle(order.begin(), order.end(), random);
+
+        return order;
+    }
+
+    template <typename TBooks>
+    void UpdateBooks(benchmark::State& state, TBooks&& bookAt, std::size_t count) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 5);
+        const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+        const auto order = VisitOrder(count);
+
+        std::size_t round = 0;
+        for (auto _ : state) {
+            for (std::size_t index : order) {
+                auto& book = bookAt(index);
+                const auto& message = messages[(index + round) % MessagesCount];
+
+                book.BBOUpdate(tickers[(index + round) % MessagesCount]);
+                book.DepthUpdate(message.Bids, message.Asks);
+            }
+
+            ++round;
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+
+    void BM_HeapBooks(benchmark::State& state) {
+        const auto count = static_cast<std::size_t>(state.range(0));
+
+        std::vector<std::unique_ptr<TBook>> books;
+        std::vector<std::unique_ptr<char[]>> noise;
+        for (std::size_t index = 0; index < count; ++index) {
+            books.push_back(std::make_unique<TBook>());
+            noise.push_back(std::make_unique<char[]>(NoiseSize));
+        }
+
+        UpdateBooks(state, [&](std::size_t index) -> TBook& { return *books[index]; }, count);
+    }
+
+    void BM_PooledBooks(benchmark::State& state) {
+        const auto count = static_cast<std::size_t>(state.range(0));
+        const bool useHugePages = state.range(1) != 0;
+
+        BookPool<TBook> pool(count, {
+            .UseHugePages = useHugePages,
+            .NumaNode = Utils::CurrentNumaNode(),
+        });
+
+        for (std::size_t index = 0; index < count; ++index) {
+            pool.Emplace();
+        }
+
+        UpdateBooks(state, [&](std::size_t index) -> TBook& { return pool.Book(index); }, count);
+
+        const auto footprint = pool.Footprint();
+        state.SetLabel(Utils::ToString(footprint.Pages));
+        state.counters["book_bytes"] = static_cast<double>(footprint.BookSize);
+        state.counters["stride"] = static_cast<double>(footprint.Stride);
+        state.counters["pages"] = static_cast<double>(footprint.PagesUsed());
+        state.counters["numa_bound"] = footprint.NumaNode >= 0;
+    }
+
+}
+
+BENCHMARK(BM_HeapBooks)->ArgName("books")->Arg(500)->Arg(2000)->Arg(8000);
+BENCHMARK(BM_PooledBooks)->ArgNames({"books", "huge"})->ArgsProduct({{500, 2000, 8000}, {0, 1}});
@@ -0,0 +1,48 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "src/book_registry.h"
+#include "src/order_book.h"
+#include "support/market_data.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    constexpr std::size_t MessagesCount = 64;
+    constexpr std::size_t Rounds = 10;
+
+    // Every shard applies `Rounds` depth updates to each of its books, threads run concurrently.
+    void BM_ShardedDepthUpdate(benchmark::State& state) {
+        const auto symbolsCount = static_cast<std::size_t>(state.range(0));
+        const auto threadsCount = static_cast<std::size_t>(state.range(1));
+
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+
+        BookRegistry<BinanceBook<>> registry(threadsCount);
+        for (std::size_t symbol = 0; symbol < symbolsCount; ++symbol) {
+            registry.Intern("SYMBOL" + std::to_string(symbol));
+        }
+
+        for (auto _ : state) {
+            registry.Run([&messages](auto& shard) {
+                for (std::size_t round = 0; round < Rounds; ++round) {
+                    for (SymbolId id : shard.Symbols()) {
+                        const auto& message = messages[(id + round) % MessagesCount];
+                        shard.Book(id).DepthUpdate(message.Bids, message.Asks);
+                    }
+                }
+            });
+        }
+
+        state.SetItemsProcessed(state.iterations() * symbolsCount * Rounds);
+    }
+
+}
+
+BENCHMARK(BM_ShardedDepthUpdate)
+    ->ArgsProduct({{2000}, {1, 2, 4, 8, 16}})
+    ->ArgNames({"symbols", "threads"})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,160 @@
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/capture/checkpoint_reader.h"
+#include "src/capture/checkpoint_writer.h"
+#include "src/order_book.h"
+#include "src/utils/checksum.h"
+#include "support/market_data.h"
+
+/*
+ * Checkpoint of 10k books of 20 levels: saving all of them into the mapped file with a commit, which writes the file
+ * to disk and renames it over the previous generation, and a warm restart, mapping the file and restoring every book.
+ * Before measuring the restore, the benchmark checks that restored books have the same content as the saved ones
+ * and that a damaged record is detected.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+
+    constexpr std::size_t BooksCount = 10'000;
+    constexpr std::size_t MessagesCount = 64;
+
+    std::string CheckpointPath() {
+        return (std::filesystem::temp_directory_path() / "binance_book_checkpoint.bin").string();
+    }
+
+    std::string SymbolOf(std::size_t index) {
+        return "SYM" + std::to_string(index) + "USDT";
+    }
+
+    std::vector<std::unique_ptr<TBook>> MakeBooks() {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        std::vector<std::unique_ptr<TBook>> books;
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            auto& book = *books.emplace_back(std::make_unique<TBook>());
+            for (std::size_t message = 0; message < 4; ++message) {
+                const auto& depth = messages[(index + message) % MessagesCount];
+                book.DepthUpdate(depth.Bids, depth.Asks);
+            }
+            book.BBOUpdate(tickers[index % MessagesCount]);
+        }
+
+        return books;
+    }
+
+    void SaveAll(Capture::CheckpointWriter<TBook>& writer, const std::vector<std::unique_ptr<TBook>>& books,
+                 const std::vector<std::string>& symbols) {
+        for (std::size_t index = 0; index < books.size(); ++index) {
+            writer.Save(index, symbols[index], *books[index], index);
+        }
+
+        writer.Commit();
+    }
+
+    // Restored books must be the same as the saved ones and a flipped byte must be detected.
+    bool RoundTripAndCorruption(const std::vector<std::unique_ptr<TBook>>& books, const std::string& path) {
+        std::vector<std::unique_ptr<TBook>> restored(books.size());
+        const auto counts = Capture::CheckpointReader<TBook>(path).RestoreAll([&](std::size_t index, std::string_view) -> TBook& {
+            return *(restored[index] = std::make_unique<TBook>());
+        });
+
+        if (counts.Restored != books.size()) {
+            return false;
+        }
+
+        for (std::size_t index = 0; index < books.size(); ++index) {
+            if (Utils::BookChecksum(*books[index]) != Utils::BookChecksum(*restored[index])) {
+                return false;
+            }
+        }
+
+        const auto damagedPath = path + ".damaged";
+        std::filesystem::copy_file(path, damagedPath, std::filesystem::copy_options::overwrite_existing);
+        {
+            std::fstream file(damagedPath, std::ios::in | std::ios::out | std::ios::binary);
+            const auto offset = static_cast<std::streamoff>(Capture::CheckpointRecordsOffset
+                                                            + Capture::CheckpointRecordSize<TBook::TState>() * 5 + 200);
+            char byte = 0;
+            file.seekg(offset);
+            file.read(&byte, 1);
+            byte ^= 0x01;
+            file.seekp(offset);
+            file.write(&byte, 1);
+        }
+
+        TBook book;
+        const auto status = Capture::CheckpointReader<TBook>(damagedPath).Restore(5, book);
+        std::filesystem::remove(damagedPath);
+
+        return status == Capture::RestoreStatus::Corrupted && book.IsEmpty();
+    }
+
+    void BM_CheckpointSave(benchmark::State& state) {
+        const auto books = MakeBooks();
+        std::vector<std::string> symbols;
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            symbols.push_back(SymbolOf(index));
+        }
+
+        const auto path = CheckpointPath();
+        Capture::CheckpointWriter<TBook> writer(path, BooksCount);
+
+        for (auto _ : state) {
+            SaveAll(writer, books, symbols);
+        }
+
+        state.SetItemsProcessed(state.iterations() * BooksCount);
+        state.counters["file_mb"] = static_cast<double>(writer.Size()) / (1 << 20);
+    }
+
+    void BM_CheckpointRestore(benchmark::State& state) {
+        const auto books = MakeBooks();
+        const auto path = CheckpointPath();
+        {
+            std::vector<std::string> symbols;
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                symbols.push_back(SymbolOf(index));
+            }
+
+            Capture::CheckpointWriter<TBook> writer(path, BooksCount);
+            SaveAll(writer, books, symbols);
+        }
+
+        if (!RoundTripAndCorruption(books, path)) {
+            state.SkipWithError("Checkpoint round trip failed");
+            return;
+        }
+
+        std::vector<std::unique_ptr<TBook>> restored;
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            restored.push_back(std::make_unique<TBook>());
+        }
+
+        // Includes mapping the file, as a process does on a warm restart.
+        for (auto _ : state) {
+            const Capture::CheckpointReader<TBook> reader(path);
+            const auto counts = reader.RestoreAll([&](std::size_t index, std::string_view) -> TBook& {
+                return *restored[index];
+            });
+            benchmark::DoNotOptimize(counts);
+        }
+
+        state.SetItemsProcessed(state.iterations() * BooksCount);
+        std::filesystem::remove(path);
+    }
+
+}
+
+BENCHMARK(BM_CheckpointSave)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CheckpointRestore)->Unit(benchmark::kMillisecond);
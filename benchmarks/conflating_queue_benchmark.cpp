@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/conflating_queue.h"
+#include "src/order_book.h"
+#include "src/update_queue.h"
+#include "support/market_data.h"
+
+/*
+ * Lag of the books during a burst, with updates queued one by one (UpdateQueue) against conflated (ConflatingQueue).
+ *
+ * Updates of SymbolsCount symbols arrive every ArrivalIntervalNs, faster than the consumer applies them.
+ * The producer thread pushes every update at its arrival time, or as soon as it can if it is already late
+ * (a full UpdateQueue makes it wait, as a full socket buffer would). The benchmark thread owns the books,
+ * and the lag is the time from the arrival of the latest update included into an applied book state
+ * to the moment it is applied. With UpdateQueue the lag grows with the length of the burst,
+ * with ConflatingQueue it stays bounded by a pass over the symbols.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    constexpr std::size_t MessagesCount = 1024;
+    constexpr std::size_t SymbolsCount = 16;
+    constexpr std::uint64_t ArrivalIntervalNs = 100;
+
+    using TBook = BinanceBook<>;
+
+    std::uint64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    double Percentile(const std::vector<std::uint64_t>& latencies, double percentile) {
+        const auto index = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(latencies.size() - 1));
+        return static_cast<double>(latencies[index]);
+    }
+
+    struct Feed {
+        std::vector<Support::DepthMessage<double, double>> Messages =
+            Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        std::vector<Models::BookTicker<double, double>> Tickers =
+            Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        // Every symbol gets depth and BBO updates in turn.
+        void Fill(std::size_t index, Models::BookUpdate<double, double, 20>& update) const {
+            update.SymbolId = static_cast<SymbolId>(index % SymbolsCount);
+
+            const std::size_t message = index / SymbolsCount;
+            if (message % 2 == 0) {
+                const auto& depth = Messages[message / 2 % MessagesCount];
+                update.SetDepth(depth.Bids, depth.Asks);
+            } else {
+                update.SetTicker(Tickers[message / 2 % MessagesCount]);
+            }
+        }
+    };
+
+    // Wait until the arrival time of the update, returns it as the timestamp.
+    std::uint64_t WaitArrival(std::uint64_t start, std::size_t index) {
+        const std::uint64_t arrival = start + index * ArrivalIntervalNs;
+        while (Now() < arrival) {
+        }
+
+        return arrival;
+    }
+
+    void ReportLag(benchmark::State& state, std::vector<std::uint64_t>& lags, std::size_t burst) {
+        std::sort(lags.begin(), lags.end());
+
+        state.SetItemsProcessed(state.iterations() * burst);
+        state.counters["lag_p50_us"] = Percentile(lags, 50) / 1000;
+        state.counters["lag_p99_us"] = Percentile(lags, 99) / 1000;
+        state.counters["lag_max_us"] = static_cast<double>(lags.back()) / 1000;
+    }
+
+    void BM_BurstLagQueued(benchmark::State& state) {
+        const auto burst = static_cast<std::size_t>(state.range(0));
+        const Feed feed;
+
+        auto queue = std::make_unique<UpdateQueue<double, double, 20, 1024>>();
+        std::vector<std::unique_ptr<TBook>> books;
+        for (std::size_t symbol = 0; symbol < SymbolsCount; ++symbol) {
+            books.push_back(std::make_unique<TBook>());
+        }
+
+        std::vector<std::uint64_t> lags;
+        lags.reserve(1 << 20);
+
+        for (auto _ : state) {
+            const std::uint64_t start = Now();
+
+            std::jthread producer([&]() {
+                for (std::size_t index = 0; index < burst; ++index) {
+                    const std::uint64_t arrival = WaitArrival(start, index);
+                    while (!queue->TryPushWith([&](auto& update) {
+                        feed.Fill(index, update);
+                        update.Timestamp = arrival;
+                    })) {
+                    }
+                }
+            });
+
+            for (std::size_t applied = 0; applied < burst;) {
+                applied += queue->ConsumeBatch([&](const auto& update) {
+                    ApplyUpdate(*books[update.SymbolId], update);
+                    if (lags.size() < lags.capacity()) {
+                        lags.push_back(Now() - update.Timestamp);
+                    }
+                }, 64);
+            }
+        }
+
+        ReportLag(state, lags, burst);
+    }
+
+    void BM_BurstLagConflated(benchmark::State& state) {
+        const auto burst = static_cast<std::size_t>(state.range(0));
+        const Feed feed;
+
+        auto queue = std::make_unique<ConflatingQueue<double, double, 20, SymbolsCount>>();
+        std::vector<std::unique_ptr<TBook>> books;
+        for (std::size_t symbol = 0; symbol < SymbolsCount; ++symbol) {
+            books.push_back(std::make_unique<TBook>());
+        }
+
+        std::vector<std::uint64_t> lags;
+        lags.reserve(1 << 20);
+
+        for (auto _ : state) {
+            const std::uint64_t start = Now();
+            std::atomic<bool> done = false;
+
+            std::jthread producer([&]() {
+                Models::BookUpdate<double, double, 20> update;
+                for (std::size_t index = 0; index < burst; ++index) {
+                    feed.Fill(index, update);
+                    update.Timestamp = WaitArrival(start, index);
+                    queue->Push(update);
+                }
+
+                done.store(true, std::memory_order_release);
+            });
+
+            auto bookOf = [&](SymbolId id) -> TBook& {
+                return *books[id];
+            };
+
+            auto onApplied = [&](SymbolId, std::uint64_t timestamp) {
+                if (lags.size() < lags.capacity()) {
+                    lags.push_back(Now() - timestamp);
+                }
+            };
+
+            while (!done.load(std::memory_order_acquire)) {
+                queue->Drain(bookOf, SymbolsCount, onApplied);
+            }
+
+            while (queue->Drain(bookOf, SymbolsCount, onApplied) != 0) {
+            }
+        }
+
+        const auto counters = queue->Counters();
+        ReportLag(state, lags, burst);
+        state.counters["conflated"] = benchmark::Counter(static_cast<double>(counters.Conflated())
+                                                         / static_cast<double>(counters.DepthReceived + counters.BBOReceived));
+    }
+
+}
+
+BENCHMARK(BM_BurstLagQueued)
+    ->ArgName("burst")
+    ->Arg(4096)
+    ->Arg(32768)
+    ->Arg(262144)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_BurstLagConflated)
+    ->ArgName("burst")
+    ->Arg(4096)
+    ->Arg(32768)
+    ->Arg(262144)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/consolidated_book.h"
+#include "support/market_data.h"
+
+/*
+ * Cost of a venue update for a consolidated book of K venues of the same symbol:
+ * the incremental ConsolidatedBook against merging the levels of all venues again after every update.
+ * Every venue replays its own stream around the same mid price, so most prices are quoted by several venues.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<double, double, 20>;
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    constexpr std::size_t MessagesCount = 1024;
+    constexpr std::size_t MaxVenues = 16;
+
+    struct Venues {
+        std::vector<std::unique_ptr<TBook>> Books;
+        std::vector<std::vector<Support::DepthMessage<double, double>>> Messages;
+
+        explicit Venues(std::size_t count) {
+            for (std::size_t venue = 0; venue < count; ++venue) {
+                Books.push_back(std::make_unique<TBook>());
+                Messages.push_back(Support::GenerateDepthMessages<double, double>(
+                    MessagesCount, 20, static_cast<std::uint32_t>(42 + venue), Support::Distribution::RecordedLike));
+            }
+        }
+    };
+
+    // The same result as ConsolidatedBook::Levels computed from scratch: all levels of all venues sorted and summed.
+    template <typename TKeyComparator>
+    void Merge(std::vector<TPriceQuantity>& merged, TKeyComparator comparator) {
+        std::ranges::sort(merged, comparator, &TPriceQuantity::Price);
+
+        auto last = merged.begin();
+        for (auto it = merged.begin(); it != merged.end(); ++it) {
+            if (last != it && last->Price == it->Price) {
+                last->Quantity += it->Quantity;
+            } else if (last != it) {
+                *++last = *it;
+            }
+        }
+
+        merged.erase(merged.empty() ? merged.end() : std::next(last), merged.end());
+    }
+
+    void BM_ConsolidatedUpdate(benchmark::State& state) {
+        const auto venuesCount = static_cast<std::size_t>(state.range(0));
+        Venues venues(venuesCount);
+
+        ConsolidatedBook<TBook, MaxVenues> book;
+        for (auto& venueBook : venues.Books) {
+            book.AddVenue(*venueBook);
+        }
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto venue = static_cast<VenueId>(index % venuesCount);
+            const auto& message = venues.Messages[venue][index / venuesCount % MessagesCount];
+            ++index;
+
+            book.DepthUpdate(venue, message.Bids, message.Asks);
+            benchmark::DoNotOptimize(book.Levels(BookSide::Bids).data());
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_RemergeUpdate(benchmark::State& state) {
+        const auto venuesCount = static_cast<std::size_t>(state.range(0));
+        Venues venues(venuesCount);
+
+        std::vector<TPriceQuantity> bids;
+        std::vector<TPriceQuantity> asks;
+        bids.reserve(venuesCount * 21);
+        asks.reserve(venuesCount * 21);
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto venue = index % venuesCount;
+            const auto& message = venues.Messages[venue][index / venuesCount % MessagesCount];
+            ++index;
+
+            venues.Books[venue]->DepthUpdate(message.Bids, message.Asks);
+
+            bids.clear();
+            asks.clear();
+            for (const auto& venueBook : venues.Books) {
+                auto [venueBids, venueAsks] = venueBook->Levels();
+                bids.insert(bids.end(), venueBids.begin(), venueBids.end());
+                asks.insert(asks.end(), venueAsks.begin(), venueAsks.end());
+            }
+
+            Merge(bids, std::greater<>());
+            Merge(asks, std::less<>());
+            benchmark::DoNotOptimize(bids.data());
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+BENCHMARK(BM_ConsolidatedUpdate)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(BM_RemergeUpdate)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <boost/container/flat_map.hpp>
+
+#include "src/diff_depth_book.h"
+#include "support/market_data.h"
+
+/*
+ * Full-depth books maintained from the diff stream: DiffDepthBook against the same rules applied to flat_map,
+ * which has to move the tail of the array on every insertion and removal.
+ * The book is filled by a snapshot of `state.range(0)` levels per side, then every iteration applies a diff
+ * of 20 levels spread over the whole depth, a third of them removing a level.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    constexpr std::size_t MessagesCount = 4096;
+    constexpr std::size_t LevelsPerDiff = 10;
+    constexpr std::int64_t MidTicks = 2007870;
+
+    struct Diff {
+        std::vector<TPriceQuantity> Bids;
+        std::vector<TPriceQuantity> Asks;
+    };
+
+    struct Stream {
+        std::vector<TPriceQuantity> SnapshotBids;
+        std::vector<TPriceQuantity> SnapshotAsks;
+        std::vector<Diff> Diffs;
+    };
+
+    Stream GenerateStream(std::size_t depth, std::uint32_t seed) {
+        using Support::FromUnits;
+
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<std::int64_t> offset(1, static_cast<std::int64_t>(depth));
+        std::uniform_int_distribution<int> lots(1, 100000);
+        std::uniform_int_distribution<int> action(0, 2);
+
+        auto level = [&](std::int64_t ticks, bool remove) -> TPriceQuantity {
+            return {
+                .Price = FromUnits<double>(ticks, Support::TicksPerUnit),
+                .Quantity = remove ? 0.0 : FromUnits<double>(lots(random), Support::LotsPerUnit),
+            };
+        };
+
+        Stream stream;
+        for (std::size_t i = 1; i <= depth; ++i) {
+            stream.SnapshotBids.push_back(level(MidTicks - static_cast<std::int64_t>(i), false));
+            stream.SnapshotAsks.push_back(level(MidTicks + static_cast<std::int64_t>(i), false));
+        }
+
+        // Removed levels are added back by later diffs, so the depth stays about the same.
+        stream.Diffs.resize(MessagesCount);
+        for (auto& diff : stream.Diffs) {
+            for (std::size_t i = 0; i < LevelsPerDiff; ++i) {
+                diff.Bids.push_back(level(MidTicks - offset(random), action(random) == 0));
+                diff.Asks.push_back(level(MidTicks + offset(random), action(random) == 0));
+            }
+        }
+
+        return stream;
+    }
+
+    // The same rules as DiffDepthBook applies to a synced book, with sorted arrays as the storage.
+    class FlatMapDiffBook {
+        boost::container::flat_map<double, double, std::greater<>> Bids_;
+        boost::container::flat_map<double, double, std::less<>> Asks_;
+        std::uint64_t LastUpdateId_ = 0;
+
+    public:
+        void ApplySnapshot(std::uint64_t lastUpdateId, const auto& bids, const auto& asks) {
+            Bids_.clear();
+            Asks_.clear();
+            for (const auto& level : bids) {
+                Bids_.insert_or_assign(level.Price, level.Quantity);
+            }
+            for (const auto& level : asks) {
+                Asks_.insert_or_assign(level.Price, level.Quantity);
+            }
+            LastUpdateId_ = lastUpdateId;
+        }
+
+        DiffStatus Update(std::uint64_t firstUpdateId, std::uint64_t finalUpdateId, const auto& bids, const auto& asks) {
+            if (finalUpdateId <= LastUpdateId_) {
+                return DiffStatus::Stale;
+            }
+            if (firstUpdateId > LastUpdateId_ + 1) {
+                return DiffStatus::Gap;
+            }
+
+            UpdateLevels(Bids_, bids);
+            UpdateLevels(Asks_, asks);
+            LastUpdateId_ = finalUpdateId;
+
+            return DiffStatus::Applied;
+        }
+
+    private:
+        static void UpdateLevels(auto& side, const auto& levels) {
+            for (const auto& level : levels) {
+                if (level.Quantity > 0) {
+                    side.insert_or_assign(level.Price, level.Quantity);
+                } else {
+                    side.erase(level.Price);
+                }
+            }
+        }
+    };
+
+    template <typename TBook>
+    void BM_DiffDepthUpdate(benchmark::State& state) {
+        const auto stream = GenerateStream(static_cast<std::size_t>(state.range(0)), 42);
+
+        TBook book;
+        book.ApplySnapshot(0, stream.SnapshotBids, stream.SnapshotAsks);
+
+        std::uint64_t updateId = 0;
+        for (auto _ : state) {
+            const auto& diff = stream.Diffs[updateId % MessagesCount];
+            benchmark::DoNotOptimize(book.Update(updateId + 1, updateId + 1, diff.Bids, diff.Asks));
+            ++updateId;
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Diffs received while the snapshot is being fetched, buffered and replayed once it arrives.
+    void BM_DiffDepthResync(benchmark::State& state) {
+        const auto stream = GenerateStream(static_cast<std::size_t>(state.range(0)), 42);
+        constexpr std::uint64_t BufferedCount = 64;
+
+        DiffDepthBook<> book;
+        for (auto _ : state) {
+            book.Clear();
+            for (std::uint64_t updateId = 1; updateId <= BufferedCount; ++updateId) {
+                const auto& diff = stream.Diffs[updateId];
+                (void)book.Update(updateId, updateId, diff.Bids, diff.Asks);
+            }
+
+            book.ApplySnapshot(BufferedCount / 2, stream.SnapshotBids, stream.SnapshotAsks);
+            benchmark::DoNotOptimize(book.LastUpdateId());
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+BENCHMARK_TEMPLATE(BM_DiffDepthUpdate, DiffDepthBook<>)->Arg(1000)->Arg(5000)->Arg(20000);
+BENCHMARK_TEMPLATE(BM_DiffDepthUpdate, FlatMapDiffBook)->Arg(1000)->Arg(5000)->Arg(20000);
+BENCHMARK(BM_DiffDepthResync)->Arg(1000)->Arg(5000);
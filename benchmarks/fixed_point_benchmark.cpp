@@ -0,0 +1,85 @@
+#include <charconv>
+#include <string_view>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/models/fixed_point.h"
+#include "support/market_data.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TFixedPrice = Models::Price<2>;
+    using TFixedQuantity = Models::Quantity<8>;
+
+    constexpr std::size_t MessagesCount = 1024;
+
+    template <typename TPrice, typename TQuantity>
+    void BM_DepthUpdate(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<TPrice, TQuantity>(MessagesCount, 20);
+        BinanceBook<TPrice, TQuantity, 20> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <typename TPrice, typename TQuantity>
+    void BM_BBOUpdate(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<TPrice, TQuantity>(1, 20);
+        const auto tickers = Support::GenerateBookTickers<TPrice, TQuantity>(MessagesCount);
+
+        BinanceBook<TPrice, TQuantity, 20> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            book.BBOUpdate(tickers[index++ % MessagesCount]);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    constexpr std::string_view Decimals[] = {
+        "20078.54000000", "0.00431000", "20077.39000000", "0.28882000", "20079.66000000", "0.00066000",
+    };
+
+    void BM_ParseDouble(benchmark::State& state) {
+        for (auto _ : state) {
+            for (auto text : Decimals) {
+                double value;
+                std::from_chars(text.data(), text.data() + text.size(), value);
+                benchmark::DoNotOptimize(value);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * std::size(Decimals));
+    }
+
+    void BM_ParseFixedPoint(benchmark::State& state) {
+        for (auto _ : state) {
+            for (auto text : Decimals) {
+                auto value = Models::Quantity<8>::Parse(text);
+                benchmark::DoNotOptimize(value);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * std::size(Decimals));
+    }
+
+}
+
+BENCHMARK_TEMPLATE(BM_DepthUpdate, double, double);
+BENCHMARK_TEMPLATE(BM_DepthUpdate, TFixedPrice, TFixedQuantity);
+BENCHMARK_TEMPLATE(BM_BBOUpdate, double, double);
+BENCHMARK_TEMPLATE(BM_BBOUpdate, TFixedPrice, TFixedQuantity);
+BENCHMARK(BM_ParseDouble);
+BENCHMARK(BM_ParseFixedPoint);
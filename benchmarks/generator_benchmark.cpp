@@ -0,0 +1,112 @@
+#include <memory>
+#include <memory_resource>
+#include <span>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/utils/frame_pool.h"
+#include "src/utils/generator.h"
+#include "support/market_data.h"
+
+/*
+ * Depth updates fed by generators: frames taken from the FramePool of the thread against frames allocated
+ * with the global operator new (through new_delete_resource, as every generator did before the pool),
+ * with plain spans as the baseline. The pooled variant fails if it reaches the global heap in the steady state.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    constexpr std::size_t MessagesCount = 1000;
+
+    Utils::Generator<TPriceQuantity> Yield(std::span<const TPriceQuantity> levels) {
+        for (const auto& level : levels) {
+            co_yield level;
+        }
+    }
+
+    Utils::Generator<TPriceQuantity> Yield(std::allocator_arg_t, std::pmr::polymorphic_allocator<>,
+                                           std::span<const TPriceQuantity> levels) {
+        for (const auto& level : levels) {
+            co_yield level;
+        }
+    }
+
+    template <typename TFeed>
+    void DepthUpdates(benchmark::State& state, TFeed&& feed) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        BinanceBook<> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            feed(book, message.Bids, message.Asks);
+            benchmark::DoNotOptimize(book);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_SpanDepthUpdate(benchmark::State& state) {
+        DepthUpdates(state, [](auto& book, const auto& bids, const auto& asks) {
+            book.DepthUpdate(std::span(bids), std::span(asks));
+        });
+    }
+
+    void BM_PooledGeneratorDepthUpdate(benchmark::State& state) {
+        const auto before = Utils::FramePool::Local().Counters();
+        std::uint64_t warmedUp = 0;
+
+        DepthUpdates(state, [&](auto& book, const auto& bids, const auto& asks) {
+            book.DepthUpdate(Yield(bids), Yield(asks));
+            if (warmedUp == 0) {
+                warmedUp = Utils::FramePool::Local().Counters().UpstreamAllocations;
+            }
+        });
+
+        const auto after = Utils::FramePool::Local().Counters();
+        if (after.UpstreamAllocations != warmedUp) {
+            state.SkipWithError("Generator frames reached the global heap in the steady state");
+        }
+
+        state.counters["frames_per_update"] = benchmark::Counter(static_cast<double>(after.Allocations - before.Allocations),
+                                                                 benchmark::Counter::kAvgIterations);
+        state.counters["upstream_allocations"] = static_cast<double>(after.UpstreamAllocations - before.UpstreamAllocations);
+    }
+
+    void BM_HeapGeneratorDepthUpdate(benchmark::State& state) {
+        const std::pmr::polymorphic_allocator<> heap(std::pmr::new_delete_resource());
+
+        DepthUpdates(state, [&](auto& book, const auto& bids, const auto& asks) {
+            book.DepthUpdate(Yield(std::allocator_arg, heap, bids), Yield(std::allocator_arg, heap, asks));
+        });
+    }
+
+    void BM_PooledExtract(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(1, 20);
+        BinanceBook<> book;
+        book.DepthUpdate(messages[0].Bids, messages[0].Asks);
+
+        for (auto _ : state) {
+            auto [bids, asks] = book.Extract();
+            for (auto level : bids) {
+                benchmark::DoNotOptimize(level);
+            }
+            for (auto level : asks) {
+                benchmark::DoNotOptimize(level);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+BENCHMARK(BM_SpanDepthUpdate);
+BENCHMARK(BM_PooledGeneratorDepthUpdate);
+BENCHMARK(BM_HeapGeneratorDepthUpdate);
+BENCHMARK(BM_PooledExtract);
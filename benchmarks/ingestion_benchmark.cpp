@@ -0,0 +1,185 @@
+#include <array>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/ingest/ingestion_engine.h"
+#include "src/parsers/binance_parser.h"
+#include "src/utils/task.h"
+#include "support/payloads.h"
+
+/*
+ * Ingestion of Binance payloads from local sockets standing in for the exchange: every source is
+ * a SOCK_SEQPACKET socket pair, the benchmark writes a batch of depth and book ticker messages into each of them
+ * (not timed) and measures receiving, parsing and applying them to the book of the source.
+ * IngestionEngine delivers the messages to a coroutine per source straight from the provided buffers,
+ * the baseline waits with epoll and reads every message with a non-blocking recv() into one buffer.
+ * Both fail if not every message has been applied.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+
+    constexpr std::size_t SourcesCount = 8;
+    constexpr std::size_t MessagesPerSource = 64; // half depth updates, half book tickers
+
+    bool Apply(TBook& book, std::string_view message) {
+        if (message.find("\"lastUpdateId\"") != std::string_view::npos) {
+            if (auto depth = Parsers::ParseDepth(message)) {
+                book.DepthUpdate(depth->Bids, depth->Asks);
+                return true;
+            }
+        } else if (auto ticker = Parsers::ParseBookTicker(message)) {
+            book.BBOUpdate(ticker->Ticker);
+            return true;
+        }
+
+        return false;
+    }
+
+    // Socket pairs of the sources: the exchange writes into the first socket, the book side reads the second one.
+    struct Sources {
+        std::array<std::array<int, 2>, SourcesCount> Sockets{};
+        std::vector<std::unique_ptr<TBook>> Books;
+
+        Sources() {
+            for (auto& pair : Sockets) {
+                if (::socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, pair.data()) != 0) {
+                    throw std::system_error(errno, std::generic_category(), "Failed to create a socket pair");
+                }
+                Books.push_back(std::make_unique<TBook>());
+            }
+        }
+
+        Sources(const Sources&) = delete;
+        Sources& operator=(const Sources&) = delete;
+
+        ~Sources() {
+            for (auto& pair : Sockets) {
+                ::close(pair[0]);
+                ::close(pair[1]);
+            }
+        }
+
+        void Send() const {
+            for (std::size_t message = 0; message < MessagesPerSource; ++message) {
+                const auto payload = message % 2 == 0 ? Support::DepthPayload : Support::BookTickerPayload;
+                for (const auto& pair : Sockets) {
+                    if (::write(pair[0], payload.data(), payload.size()) != static_cast<ssize_t>(payload.size())) {
+                        throw std::system_error(errno, std::generic_category(), "Failed to send a message");
+                    }
+                }
+            }
+        }
+    };
+
+    Utils::Task Feed(Ingest::IngestionEngine& engine, Ingest::SourceId source, TBook& book, std::size_t& applied) {
+        while (auto message = co_await engine.Next(source)) {
+            applied += Apply(book, *message);
+        }
+    }
+
+    void BM_IngestIoUring(benchmark::State& state) {
+        Sources sources;
+        Ingest::IngestionEngine engine({
+            .BufferSize = 2048,
+            .BuffersCount = 1024,
+            .MaxFiles = 1,
+        });
+
+        std::size_t applied = 0;
+        std::vector<Utils::Task> feeds;
+        for (std::size_t index = 0; index < SourcesCount; ++index) {
+            const auto source = engine.AddSocket(sources.Sockets[index][1]);
+            feeds.push_back(Feed(engine, source, *sources.Books[index], applied));
+        }
+
+        const std::size_t batch = SourcesCount * MessagesPerSource;
+        std::size_t expected = 0;
+        for (auto _ : state) {
+            state.PauseTiming();
+            sources.Send();
+            expected += batch;
+            state.ResumeTiming();
+
+            while (applied != expected) {
+                engine.Poll(true);
+            }
+        }
+
+        // Close the sockets of the exchange, so the feeds complete before the engine is destroyed.
+        for (auto& pair : sources.Sockets) {
+            ::shutdown(pair[0], SHUT_WR);
+        }
+        engine.Run();
+
+        if (engine.Counters().Dropped != 0 || engine.Counters().Messages != expected) {
+            state.SkipWithError("Not every message has been delivered");
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(expected));
+        state.counters["buffer_shortages"] = static_cast<double>(engine.Counters().BufferShortages);
+    }
+
+    void BM_IngestEpollRead(benchmark::State& state) {
+        Sources sources;
+
+        const int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        for (std::size_t index = 0; index < SourcesCount; ++index) {
+            epoll_event event{.events = EPOLLIN, .data = {.u64 = index}};
+            ::epoll_ctl(epoll, EPOLL_CTL_ADD, sources.Sockets[index][1], &event);
+        }
+
+        std::array<char, 2048> buffer{};
+        std::array<epoll_event, SourcesCount> events{};
+
+        const std::size_t batch = SourcesCount * MessagesPerSource;
+        std::size_t expected = 0;
+        std::size_t applied = 0;
+        for (auto _ : state) {
+            state.PauseTiming();
+            sources.Send();
+            expected += batch;
+            state.ResumeTiming();
+
+            while (applied != expected) {
+                const int ready = ::epoll_wait(epoll, events.data(), static_cast<int>(events.size()), -1);
+                for (int event = 0; event < ready; ++event) {
+                    const auto index = events[event].data.u64;
+                    while (true) {
+                        const ssize_t size = ::recv(sources.Sockets[index][1], buffer.data(), buffer.size(), MSG_DONTWAIT);
+                        if (size <= 0) {
+                            break;
+                        }
+                        applied += Apply(*sources.Books[index], std::string_view(buffer.data(), size));
+                    }
+                }
+            }
+        }
+
+        ::close(epoll);
+
+        if (applied != expected) {
+            state.SkipWithError("Not every message has been applied");
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(expected));
+    }
+
+}
+
+BENCHMARK(BM_IngestIoUring)->UseRealTime();
+BENCHMARK(BM_IngestEpollRead)->UseRealTime();
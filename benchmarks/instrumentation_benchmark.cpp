@@ -0,0 +1,77 @@
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/instrumentation.h"
+#include "support/market_data.h"
+
+/*
+ * Overhead of the book instrumentation: the same mix of depth and BBO updates is applied to books with disabled
+ * and enabled instrumentation. With enabled instrumentation the recorded latency percentiles and event counts
+ * are reported as counters.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    constexpr std::size_t MessagesCount = 1024;
+
+    template <typename TInstrumentation>
+    using TBook = BinanceBook<double, double, 20, FlatMapStorage, TInstrumentation>;
+
+    template <typename TInstrumentation>
+    void BM_Updates(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20, 42,
+                                                                                Support::Distribution::RecordedLike);
+        const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        TBook<TInstrumentation> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            book.BBOUpdate(tickers[index % MessagesCount]);
+            ++index;
+
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * 2);
+
+        if constexpr (TInstrumentation::Enabled) {
+            const auto statistics = book.Statistics();
+            const double ticksPerNanosecond = Utils::TscTicksPerNanosecond();
+
+            for (auto [name, operation] : {std::pair{"depth", BookOperation::DepthUpdate},
+                                           std::pair{"bbo", BookOperation::BBOUpdate}}) {
+                const auto& latency = statistics.Latency(operation);
+                state.counters[std::string(name) + "_p50_ns"] = latency.Percentile(50) / ticksPerNanosecond;
+                state.counters[std::string(name) + "_p99_ns"] = latency.Percentile(99) / ticksPerNanosecond;
+                state.counters[std::string(name) + "_p999_ns"] = latency.Percentile(99.9) / ticksPerNanosecond;
+            }
+
+            state.counters["best_changes"] = static_cast<double>(statistics.Count(BookEvent::BestLevelChanged));
+            state.counters["evictions"] = static_cast<double>(statistics.Count(BookEvent::Eviction));
+            state.counters["ignored_zero"] = static_cast<double>(statistics.Count(BookEvent::IgnoredZeroQuantity));
+        }
+    }
+
+    // Cost of reading the statistics from another thread, e.g. by a monitoring loop.
+    void BM_ReadStatistics(benchmark::State& state) {
+        TBook<EnabledInstrumentation> book;
+        StatisticsReader reader(book);
+
+        for (auto _ : state) {
+            auto statistics = reader.Read();
+            benchmark::DoNotOptimize(statistics);
+        }
+    }
+
+}
+
+BENCHMARK_TEMPLATE(BM_Updates, DisabledInstrumentation);
+BENCHMARK_TEMPLATE(BM_Updates, EnabledInstrumentation);
+BENCHMARK(BM_ReadStatistics);
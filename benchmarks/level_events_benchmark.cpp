@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "support/market_data.h"
+
+/*
+ * What a consumer pays to learn which levels were changed by a depth update: level events emitted by the book
+ * against copying the levels after every update and comparing them with the previous copy.
+ * Plain depth updates are the baseline.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+    using TLevelEvent = TBook::TLevelEventBuffer::TLevelEvent;
+
+    constexpr std::size_t MessagesCount = 1000;
+
+    template <typename TUpdate>
+    void DepthUpdates(benchmark::State& state, TUpdate&& update) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        TBook book;
+
+        std::size_t index = 0;
+        std::size_t changes = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            changes += update(book, message.Bids, message.Asks);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.counters["changes_per_update"] = benchmark::Counter(static_cast<double>(changes),
+                                                                  benchmark::Counter::kAvgIterations);
+    }
+
+    // Count the levels which differ between two copies of a side, both in the book order of TComparator.
+    template <typename TComparator>
+    std::size_t CountChanges(std::span<const TPriceQuantity> before, std::span<const TPriceQuantity> after) {
+        const TComparator comparator;
+        std::size_t changes = 0;
+
+        auto left = before.begin();
+        auto right = after.begin();
+        while (left != before.end() || right != after.end()) {
+            if (right == after.end() || (left != before.end() && comparator(left->Price, right->Price))) {
+                ++changes;
+                ++left;
+            } else if (left == before.end() || comparator(right->Price, left->Price)) {
+                ++changes;
+                ++right;
+            } else {
+                changes += left->Quantity != right->Quantity;
+                ++left;
+                ++right;
+            }
+        }
+
+        return changes;
+    }
+
+    void BM_DepthUpdate(benchmark::State& state) {
+        DepthUpdates(state, [](auto& book, const auto& bids, const auto& asks) {
+            book.DepthUpdate(bids, asks);
+            benchmark::DoNotOptimize(book);
+            return std::size_t{0};
+        });
+    }
+
+    void BM_DepthUpdateWithLevelEvents(benchmark::State& state) {
+        std::vector<TLevelEvent> storage(256);
+        TBook::TLevelEventBuffer buffer(storage);
+        bool overflowed = false;
+
+        DepthUpdates(state, [&](auto& book, const auto& bids, const auto& asks) {
+            book.EmitLevelEventsTo(&buffer);
+            buffer.Clear();
+            book.DepthUpdate(bids, asks);
+            overflowed |= buffer.NeedsResync();
+
+            return static_cast<std::size_t>(std::count_if(buffer.Events().begin(), buffer.Events().end(), [](const auto& event) {
+                return event.Type != LevelEventType::BestChanged;
+            }));
+        });
+
+        if (overflowed) {
+            state.SkipWithError("Level events overflowed the buffer");
+        }
+    }
+
+    void BM_DepthUpdateWithCopyDiff(benchmark::State& state) {
+        std::vector<TPriceQuantity> bids[2] = {std::vector<TPriceQuantity>(32), std::vector<TPriceQuantity>(32)};
+        std::vector<TPriceQuantity> asks[2] = {std::vector<TPriceQuantity>(32), std::vector<TPriceQuantity>(32)};
+        std::size_t counts[2][2] = {};
+        std::size_t current = 0;
+
+        DepthUpdates(state, [&](auto& book, const auto& bidUpdates, const auto& askUpdates) {
+            book.DepthUpdate(bidUpdates, askUpdates);
+
+            const std::size_t previous = current;
+            current ^= 1;
+            const auto [bidsCount, asksCount] = book.CopyTop(bids[current], asks[current]);
+            counts[current][0] = bidsCount;
+            counts[current][1] = asksCount;
+
+            return CountChanges<std::greater<>>(std::span(bids[previous]).first(counts[previous][0]),
+                                                std::span(bids[current]).first(bidsCount))
+                   + CountChanges<std::less<>>(std::span(asks[previous]).first(counts[previous][1]),
+                                               std::span(asks[current]).first(asksCount));
+        });
+    }
+
+}
+
+BENCHMARK(BM_DepthUpdate);
+BENCHMARK(BM_DepthUpdateWithLevelEvents);
+BENCHMARK(BM_DepthUpdateWithCopyDiff);
@@ -0,0 +1,384 @@
+#include <iterator>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <boost/format.hpp>
+
+#include "src/order_book.h"
+#include "support/market_data.h"
+
+/*
+ * Benchmarks of every BinanceBook operation.
+ * Depth updates are measured over the synthetic and the recorded-like distributions for several numbers of levels,
+ * run `make run_benchmarks` to get the machine-readable results in benchmarks.json.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Support::Distribution;
+
+    constexpr std::size_t MessagesCount = 1024;
+
+    // Books are expensive to refill, so operations consuming a book run over a pool of them,
+    // and the pool is restored with the timer paused once in PoolSize iterations.
+    constexpr std::size_t PoolSize = 256;
+
+    template <std::size_t PriceLevels>
+    using TBook = BinanceBook<double, double, PriceLevels>;
+
+    template <std::size_t PriceLevels>
+    auto Messages(Distribution distribution) {
+        return Support::GenerateDepthMessages<double, double>(MessagesCount, PriceLevels, 42, distribution);
+    }
+
+    // Depth update of an empty book.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_DepthUpdateFresh(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+        auto books = std::make_unique<TBook<PriceLevels>[]>(PoolSize);
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            if (index == PoolSize) [[unlikely]] {
+                state.PauseTiming();
+                for (std::size_t book = 0; book < PoolSize; ++book) {
+                    books[book].Clear();
+                }
+                index = 0;
+                state.ResumeTiming();
+            }
+
+            const auto& message = messages[index % MessagesCount];
+            books[index++].DepthUpdate(message.Bids, message.Asks);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Depth updates applied one after another to the same book.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_DepthUpdateSteady(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+        TBook<PriceLevels> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Full replacement of the book content by every message.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_Replace(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+        TBook<PriceLevels> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            book.Replace(message.Bids, message.Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <std::size_t PriceLevels>
+    void BM_Clear(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution::Synthetic);
+        auto books = std::make_unique<TBook<PriceLevels>[]>(PoolSize);
+
+        auto fill = [&]() {
+            for (std::size_t book = 0; book < PoolSize; ++book) {
+                books[book].DepthUpdate(messages[book].Bids, messages[book].Asks);
+            }
+        };
+
+        fill();
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            if (index == PoolSize) [[unlikely]] {
+                state.PauseTiming();
+                fill();
+                index = 0;
+                state.ResumeTiming();
+            }
+
+            books[index++].Clear();
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    enum class BBOCase {
+        Better,    // new best prices are better than the whole book
+        InBook,    // new best prices are in the middle of the book
+        BelowBook, // new best prices are worse than the whole book
+        SamePrice, // only quantities of the best levels change
+        EmptyBook, // the book is empty
+    };
+
+    // BBO update cases from main.cpp applied to books filled by a recorded-like depth update.
+    // Every update but SamePrice changes the book it is applied to, so each one goes to a fresh book of the pool.
+    template <std::size_t PriceLevels, BBOCase Case>
+    void BM_BBOUpdate(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution::RecordedLike);
+        const auto& bids = messages.front().Bids;
+        const auto& asks = messages.front().Asks;
+
+        auto books = std::make_unique<TBook<PriceLevels>[]>(PoolSize);
+        auto fill = [&]() {
+            for (std::size_t book = 0; book < PoolSize; ++book) {
+                books[book].Clear();
+                if constexpr (Case != BBOCase::EmptyBook) {
+                    books[book].DepthUpdate(bids, asks);
+                }
+            }
+        };
+
+        auto makeTicker = [&](double quantity) -> Models::BookTicker<double, double> {
+            switch (Case) {
+                case BBOCase::Better:
+                    return {bids.front().Price + 0.5, quantity, asks.front().Price - 0.5, quantity};
+                case BBOCase::InBook:
+                    return {bids[PriceLevels / 2].Price, quantity, asks[PriceLevels / 2].Price, quantity};
+                case BBOCase::BelowBook:
+                    return {bids.back().Price - 0.5, quantity, asks.back().Price + 0.5, quantity};
+                default:
+                    return {bids.front().Price, quantity, asks.front().Price, quantity};
+            }
+        };
+
+        // Alternate quantities, so same-price updates change the book as well.
+        const Models::BookTicker<double, double> tickers[2] = {makeTicker(0.001), makeTicker(0.002)};
+
+        fill();
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            if (index == PoolSize) [[unlikely]] {
+                state.PauseTiming();
+                fill();
+                index = 0;
+                state.ResumeTiming();
+            }
+
+            books[index].BBOUpdate(tickers[index & 1]);
+            ++index;
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Iteration over the whole book through the generators.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_Extract(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        for (auto _ : state) {
+            auto [bids, asks] = book.Extract();
+
+            for (auto level : bids) {
+                benchmark::DoNotOptimize(level);
+            }
+            for (auto level : asks) {
+                benchmark::DoNotOptimize(level);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Iteration over the whole book through the allocation-free views.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_Levels(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        for (auto _ : state) {
+            auto [bids, asks] = book.Levels();
+
+            for (auto level : bids) {
+                benchmark::DoNotOptimize(level);
+            }
+            for (auto level : asks) {
+                benchmark::DoNotOptimize(level);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Copy of the whole book into a caller-provided fixed array.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_CopyTop(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        typename TBook<PriceLevels>::TSnapshot top;
+
+        for (auto _ : state) {
+            book.CopyTop(top);
+            benchmark::DoNotOptimize(top);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // The formatting through boost::format and std::stringstream used before FormatBook, kept for comparison.
+    template <typename TBook>
+    std::string LegacyToString(const TBook& book) {
+        std::stringstream out;
+        if (book.IsEmpty()) {
+            out << "[]";
+        }
+
+        auto [bids, asks] = book.Extract();
+
+        int index = 1;
+        auto bidIt = bids.begin();
+        auto askIt = asks.begin();
+
+        {
+            boost::format formatter("[%2d] [%9s] %.3f | %.3f [%-9s]\n");
+            for (; bidIt != bids.end() && askIt != asks.end(); ++bidIt, ++askIt, ++index) {
+                out << formatter % index % (*bidIt).Quantity % (*bidIt).Price % (*askIt).Price % (*askIt).Quantity;
+            }
+        }
+        {
+            boost::format formatter("[%2d] [%9s] %.3f | %9s [%9s]\n");
+            for (; bidIt != bids.end(); ++bidIt, ++index) {
+                out << formatter % index % (*bidIt).Quantity % (*bidIt).Price % "" % "";
+            }
+        }
+        {
+            boost::format formatter("[%2d] [%9s] %9s | %.3f [%-9s]\n");
+            for (; askIt != asks.end(); ++askIt, ++index) {
+                out << formatter % index % "" % "" % (*askIt).Price % (*askIt).Quantity;
+            }
+        }
+
+        return out.str();
+    }
+
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_LegacyToString(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        for (auto _ : state) {
+            auto text = LegacyToString(book);
+            benchmark::DoNotOptimize(text);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_ToString(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        for (auto _ : state) {
+            auto text = book.ToString();
+            benchmark::DoNotOptimize(text);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // Formatting into a reused buffer, as done when dumping books into a log on every tick.
+    template <std::size_t PriceLevels, Distribution Distribution>
+    void BM_FormatBook(benchmark::State& state) {
+        const auto messages = Messages<PriceLevels>(Distribution);
+
+        TBook<PriceLevels> book;
+        book.DepthUpdate(messages.front().Bids, messages.front().Asks);
+
+        char buffer[FormattedLineSize * (PriceLevels + 1)];
+
+        for (auto _ : state) {
+            auto result = FormatBook(std::begin(buffer), std::end(buffer), book);
+            benchmark::DoNotOptimize(result);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // flat_map insertions and removals in the middle with the preallocated arena and with the heap.
+    template <typename TAllocator>
+    void BM_FlatMapInsertErase(benchmark::State& state) {
+        boost::container::flat_map<double, double, std::less<>, TAllocator> orders;
+        orders.reserve(21);
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> price(0, 100);
+
+        for (auto _ : state) {
+            orders.try_emplace(price(random), 1.0);
+            if (orders.size() > 20) {
+                orders.erase(orders.begin() + static_cast<long>(random() % orders.size()));
+            }
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+#define BENCHMARK_DISTRIBUTIONS(Function, PriceLevels) \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, Distribution::Synthetic); \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, Distribution::RecordedLike)
+
+#define BENCHMARK_LEVELS(Macro, Function) \
+    Macro(Function, 5); \
+    Macro(Function, 10); \
+    Macro(Function, 20); \
+    Macro(Function, 50)
+
+#define BENCHMARK_BBO_CASES(Function, PriceLevels) \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, BBOCase::Better); \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, BBOCase::InBook); \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, BBOCase::BelowBook); \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, BBOCase::SamePrice); \
+    BENCHMARK_TEMPLATE(Function, PriceLevels, BBOCase::EmptyBook)
+
+#define BENCHMARK_SINGLE(Function, PriceLevels) BENCHMARK_TEMPLATE(Function, PriceLevels)
+
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_DepthUpdateFresh);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_DepthUpdateSteady);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_Replace);
+BENCHMARK_LEVELS(BENCHMARK_SINGLE, BM_Clear);
+BENCHMARK_LEVELS(BENCHMARK_BBO_CASES, BM_BBOUpdate);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_Extract);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_Levels);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_CopyTop);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_LegacyToString);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_ToString);
+BENCHMARK_LEVELS(BENCHMARK_DISTRIBUTIONS, BM_FormatBook);
+BENCHMARK_TEMPLATE(BM_FlatMapInsertErase, StackMemoryAllocator<std::pair<double, double>, 21>);
+BENCHMARK_TEMPLATE(BM_FlatMapInsertErase, std::allocator<std::pair<double, double>>);
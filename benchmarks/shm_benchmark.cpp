@@ -0,0 +1,248 @@
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/shm/shm_publisher.h"
+#include "src/shm/shm_reader.h"
+#include "support/market_data.h"
+
+/*
+ * Books shared through POSIX shared memory: the cost of a depth update published into a slot and the ring,
+ * reading a slot in place or as a copy, and the round trip to a reader in another process, which takes
+ * the level events from the ring and acknowledges every update. The reader process rebuilds the books
+ * from the events and the benchmark fails if they differ from the slots at the end.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+    using TPublisher = Shm::ShmPublisher<double, double, 20>;
+    using TReader = Shm::ShmReader<double, double, 20>;
+    using TLevelEvent = TBook::TLevelEventBuffer::TLevelEvent;
+
+    constexpr std::size_t MessagesCount = 1000;
+    constexpr std::size_t BooksCount = 16;
+    const std::string SegmentName = "/binance_book_benchmark";
+
+    // State shared with the reader process through an anonymous shared mapping.
+    struct Handshake {
+        std::atomic<std::uint64_t> Attached;
+        std::atomic<std::uint64_t> Updates;      // updates published by the parent
+        std::atomic<std::uint64_t> Acknowledged; // updates seen by the reader
+        std::atomic<std::uint64_t> Done;
+    };
+
+    // Books of the publisher, attached to the slots and emitting level events.
+    struct PublishedBooks {
+        TPublisher Publisher{SegmentName, BooksCount};
+        std::vector<std::unique_ptr<TBook>> Books;
+        std::vector<TLevelEvent> Storage = std::vector<TLevelEvent>(256);
+        TBook::TLevelEventBuffer Events{Storage};
+
+        PublishedBooks() {
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                auto& book = *Books.emplace_back(std::make_unique<TBook>());
+                Publisher.Attach(index, "SYM" + std::to_string(index), book);
+                book.EmitLevelEventsTo(&Events);
+            }
+        }
+
+        void Update(std::size_t index, const auto& message) {
+            Events.Clear();
+            Books[index]->DepthUpdate(message.Bids, message.Asks);
+            Publisher.PublishEvents(index, Events.Events());
+        }
+    };
+
+    void BM_ShmPublishDepthUpdate(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        PublishedBooks published;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            published.Update(index % BooksCount, messages[index % MessagesCount]);
+            ++index;
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.counters["events_per_update"] = benchmark::Counter(static_cast<double>(published.Publisher.PublishedEvents()),
+                                                                 benchmark::Counter::kAvgIterations);
+    }
+
+    void BM_ShmTryView(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(1, 20);
+        PublishedBooks published;
+        published.Update(0, messages[0]);
+
+        const TReader reader(SegmentName);
+        for (auto _ : state) {
+            double spread = 0;
+            const bool consistent = reader.TryView(0, [&](auto bids, auto asks) {
+                spread = asks[0].Price - bids[0].Price;
+            });
+            benchmark::DoNotOptimize(consistent);
+            benchmark::DoNotOptimize(spread);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_ShmLoad(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(1, 20);
+        PublishedBooks published;
+        published.Update(0, messages[0]);
+
+        const TReader reader(SegmentName);
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(reader.Load(0));
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    // The reader process: follows the ring, acknowledges updates and finally compares its books with the slots.
+    int FollowBooks(Handshake& handshake) {
+        TReader reader(SegmentName);
+        std::vector<TReader::TRingEvent> events(1024);
+        std::map<double, double> books[BooksCount][2];
+
+        auto resync = [&]() {
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                const auto snapshot = reader.Load(index);
+                books[index][0].clear();
+                books[index][1].clear();
+                for (const auto& level : snapshot.GetBids()) {
+                    books[index][0][level.Price] = level.Quantity;
+                }
+                for (const auto& level : snapshot.GetAsks()) {
+                    books[index][1][level.Price] = level.Quantity;
+                }
+            }
+        };
+
+        auto drain = [&]() {
+            while (true) {
+                const auto result = reader.Poll(events);
+                if (result.Overrun) {
+                    resync();
+                }
+
+                for (std::size_t i = 0; i < result.Count; ++i) {
+                    const auto& event = events[i];
+                    if (event.Event.Type != LevelEventType::BestChanged) {
+                        auto& side = books[event.SlotIndex][event.Event.Side == BookSide::Bids ? 0 : 1];
+                        if (event.Event.NewQuantity == 0) {
+                            side.erase(event.Event.Price);
+                        } else {
+                            side[event.Event.Price] = event.Event.NewQuantity;
+                        }
+                    }
+
+                    if (event.LastOfUpdate) {
+                        handshake.Acknowledged.fetch_add(1, std::memory_order_release);
+                    }
+                }
+
+                if (result.Count == 0 && !result.Overrun) {
+                    return;
+                }
+            }
+        };
+
+        resync();
+        handshake.Attached.store(1, std::memory_order_release);
+
+        while (handshake.Done.load(std::memory_order_acquire) == 0) {
+            drain();
+            sched_yield();
+        }
+        drain();
+
+        // Slots keep 20 levels, the events may also describe the extra level kept by the book (see OrderMap).
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            const auto snapshot = reader.Load(index);
+            auto bid = books[index][0].rbegin();
+            auto ask = books[index][1].begin();
+
+            for (const auto& level : snapshot.GetBids()) {
+                if (bid == books[index][0].rend() || bid->first != level.Price || bid->second != level.Quantity) {
+                    return 1;
+                }
+                ++bid;
+            }
+            for (const auto& level : snapshot.GetAsks()) {
+                if (ask == books[index][1].end() || ask->first != level.Price || ask->second != level.Quantity) {
+                    return 1;
+                }
+                ++ask;
+            }
+        }
+
+        return 0;
+    }
+
+    void BM_ShmCrossProcessRoundTrip(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        PublishedBooks published;
+
+        void* shared = ::mmap(nullptr, sizeof(Handshake), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared == MAP_FAILED) {
+            state.SkipWithError("Failed to map the handshake");
+            return;
+        }
+        auto& handshake = *::new (shared) Handshake{};
+
+        const pid_t child = ::fork();
+        if (child == 0) {
+            ::_exit(FollowBooks(handshake));
+        }
+
+        while (handshake.Attached.load(std::memory_order_acquire) == 0) {
+            sched_yield();
+        }
+
+        std::size_t index = 0;
+        std::uint64_t expected = 0;
+        for (auto _ : state) {
+            // Updates without level changes are not acknowledged.
+            do {
+                published.Update(index % BooksCount, messages[index % MessagesCount]);
+                ++index;
+            } while (published.Events.Size() == 0);
+
+            ++expected;
+            while (handshake.Acknowledged.load(std::memory_order_acquire) < expected) {
+                sched_yield();
+            }
+        }
+
+        handshake.Done.store(1, std::memory_order_release);
+        int status = 0;
+        ::waitpid(child, &status, 0);
+        ::munmap(shared, sizeof(Handshake));
+
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            state.SkipWithError("The reader process rebuilt books different from the published ones");
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+BENCHMARK(BM_ShmPublishDepthUpdate);
+BENCHMARK(BM_ShmTryView);
+BENCHMARK(BM_ShmLoad);
+BENCHMARK(BM_ShmCrossProcessRoundTrip)->UseRealTime();
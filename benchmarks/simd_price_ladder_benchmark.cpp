@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/models/fixed_point.h"
+#include "support/market_data.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TFixedPrice = Models::Price<2>;
+    using TFixedQuantity = Models::Quantity<8>;
+
+    constexpr std::size_t MessagesCount = 1024;
+
+    template <typename TPrice, typename TQuantity, std::size_t PriceLevels,
+              template <typename, typename, typename, std::size_t> class TStorage>
+    void BM_DepthUpdate(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<TPrice, TQuantity>(MessagesCount, PriceLevels);
+        BinanceBook<TPrice, TQuantity, PriceLevels, TStorage> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    template <typename TPrice, typename TQuantity, std::size_t PriceLevels,
+              template <typename, typename, typename, std::size_t> class TStorage>
+    void BM_DepthAndBBOUpdate(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<TPrice, TQuantity>(MessagesCount, PriceLevels);
+        const auto tickers = Support::GenerateBookTickers<TPrice, TQuantity>(MessagesCount);
+        BinanceBook<TPrice, TQuantity, PriceLevels, TStorage> book;
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            book.BBOUpdate(tickers[index++ % MessagesCount]);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+#define BENCHMARK_STORAGES(Function, TPrice, TQuantity, PriceLevels) \
+    BENCHMARK_TEMPLATE(Function, TPrice, TQuantity, PriceLevels, FlatMapStorage); \
+    BENCHMARK_TEMPLATE(Function, TPrice, TQuantity, PriceLevels, SimdPriceLadder)
+
+BENCHMARK_STORAGES(BM_DepthUpdate, double, double, 5);
+BENCHMARK_STORAGES(BM_DepthUpdate, double, double, 10);
+BENCHMARK_STORAGES(BM_DepthUpdate, double, double, 20);
+BENCHMARK_STORAGES(BM_DepthUpdate, double, double, 50);
+BENCHMARK_STORAGES(BM_DepthUpdate, TFixedPrice, TFixedQuantity, 5);
+BENCHMARK_STORAGES(BM_DepthUpdate, TFixedPrice, TFixedQuantity, 10);
+BENCHMARK_STORAGES(BM_DepthUpdate, TFixedPrice, TFixedQuantity, 20);
+BENCHMARK_STORAGES(BM_DepthUpdate, TFixedPrice, TFixedQuantity, 50);
+
+BENCHMARK_STORAGES(BM_DepthAndBBOUpdate, double, double, 5);
+BENCHMARK_STORAGES(BM_DepthAndBBOUpdate, double, double, 10);
+BENCHMARK_STORAGES(BM_DepthAndBBOUpdate, double, double, 20);
+BENCHMARK_STORAGES(BM_DepthAndBBOUpdate, double, double, 50);
@@ -0,0 +1,85 @@
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "support/market_data.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+
+    constexpr std::size_t MessagesCount = 1024;
+
+    // Writer overhead: the same stream of depth and BBO updates with and without publishing.
+    template <bool Publishing>
+    void BM_UpdateWithPublishing(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        TBook book;
+        auto slot = std::make_unique<TBook::TSnapshotSlot>();
+        if (Publishing) {
+            book.PublishTo(slot.get());
+        }
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index % MessagesCount];
+            book.DepthUpdate(message.Bids, message.Asks);
+            book.BBOUpdate(tickers[index++ % MessagesCount]);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * 2);
+    }
+
+    /*
+     * Reader throughput under contention: thread 0 keeps updating the book while the other threads
+     * copy the published snapshot. Items are successful reads for readers and updates for the writer.
+    */
+    TBook ContendedBook;
+    TBook::TSnapshotSlot ContendedSlot;
+
+    void BM_ContendedSnapshotReads(benchmark::State& state) {
+        static const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        static const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        if (state.thread_index() == 0) {
+            ContendedBook.PublishTo(&ContendedSlot);
+
+            std::size_t index = 0;
+            for (auto _ : state) {
+                const auto& message = messages[index % MessagesCount];
+                ContendedBook.DepthUpdate(message.Bids, message.Asks);
+                ContendedBook.BBOUpdate(tickers[index++ % MessagesCount]);
+            }
+
+            state.SetItemsProcessed(state.iterations() * 2);
+            return;
+        }
+
+        std::size_t reads = 0;
+        std::size_t retries = 0;
+        TBook::TSnapshot snapshot;
+
+        for (auto _ : state) {
+            if (ContendedSlot.TryLoad(snapshot)) {
+                benchmark::DoNotOptimize(snapshot);
+                ++reads;
+            } else {
+                ++retries;
+            }
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(reads));
+        state.counters["retries"] = benchmark::Counter(static_cast<double>(retries), benchmark::Counter::kAvgThreads);
+    }
+
+}
+
+BENCHMARK_TEMPLATE(BM_UpdateWithPublishing, false);
+BENCHMARK_TEMPLATE(BM_UpdateWithPublishing, true);
+BENCHMARK(BM_ContendedSnapshotReads)->ThreadRange(2, 8)->UseRealTime();
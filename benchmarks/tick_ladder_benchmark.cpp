@@ -0,0 +1,120 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "support/market_data.h"
+
+/*
+ * TickLadder against the sorted array of FlatMapStorage on books from 20 to 5000 levels deep.
+ * Prices of the generated streams are in ticks of 0.01, the ladders are sized to cover the whole depth in ticks.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    template <std::size_t Slots>
+    using TLadder = TickLadderStorage<DecimalTicks<static_cast<std::int64_t>(Support::TicksPerUnit)>, Slots>;
+
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity>
+    using TickLadder256 = TLadder<256>::Type<TPrice, TQuantity, TKeyComparator, Capacity>;
+
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity>
+    using TickLadder4K = TLadder<4096>::Type<TPrice, TQuantity, TKeyComparator, Capacity>;
+
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity>
+    using TickLadder32K = TLadder<32768>::Type<TPrice, TQuantity, TKeyComparator, Capacity>;
+
+    // Deep books don't need as many distinct messages to defeat the caches, but take a lot of memory.
+    constexpr std::size_t MessagesCount(std::size_t levels) {
+        return std::max<std::size_t>(16, 32768 / levels);
+    }
+
+    // Full depth messages: every level of the book is sent in every message.
+    template <std::size_t PriceLevels, template <typename, typename, typename, std::size_t> class TStorage,
+              Support::Distribution Distribution>
+    void BM_LadderDepthUpdate(benchmark::State& state) {
+        const std::size_t count = MessagesCount(PriceLevels);
+        const auto messages = Support::GenerateDepthMessages<double, double>(count, PriceLevels, 42, Distribution);
+        auto book = std::make_unique<BinanceBook<double, double, PriceLevels, TStorage>>();
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const auto& message = messages[index++ % count];
+            book->DepthUpdate(message.Bids, message.Asks);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * PriceLevels * 2);
+    }
+
+    /*
+     * Small diffs hitting the top of a full book: 4 levels per side within 16 ticks of the best price,
+     * a third of them removing the level. Every insertion near the top shifts the whole array of flat_map.
+    */
+    template <std::size_t PriceLevels, template <typename, typename, typename, std::size_t> class TStorage>
+    void BM_LadderTopUpdate(benchmark::State& state) {
+        using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+        constexpr std::size_t UpdatesCount = 4096;
+        constexpr std::int64_t MidTicks = 2007870;
+
+        std::vector<TPriceQuantity> bids;
+        std::vector<TPriceQuantity> asks;
+        for (std::size_t level = 1; level <= PriceLevels; ++level) {
+            bids.push_back({Support::FromUnits<double>(MidTicks - 2 * level, Support::TicksPerUnit), 1.0});
+            asks.push_back({Support::FromUnits<double>(MidTicks + 2 * level, Support::TicksPerUnit), 1.0});
+        }
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<std::int64_t> offset(1, 16);
+        std::uniform_int_distribution<int> action(0, 2);
+
+        auto level = [&](std::int64_t ticks) -> TPriceQuantity {
+            return {
+                .Price = Support::FromUnits<double>(ticks, Support::TicksPerUnit),
+                .Quantity = action(random) == 0 ? 0.0 : 2.0,
+            };
+        };
+
+        std::vector<std::vector<TPriceQuantity>> bidUpdates(UpdatesCount);
+        std::vector<std::vector<TPriceQuantity>> askUpdates(UpdatesCount);
+        for (std::size_t i = 0; i < UpdatesCount; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                bidUpdates[i].push_back(level(MidTicks - offset(random)));
+                askUpdates[i].push_back(level(MidTicks + offset(random)));
+            }
+
+            std::ranges::sort(bidUpdates[i], std::greater<>(), &TPriceQuantity::Price);
+            std::ranges::sort(askUpdates[i], std::less<>(), &TPriceQuantity::Price);
+        }
+
+        auto book = std::make_unique<BinanceBook<double, double, PriceLevels, TStorage>>();
+        book->DepthUpdate(bids, asks);
+
+        std::size_t index = 0;
+        for (auto _ : state) {
+            const std::size_t i = index++ % UpdatesCount;
+            book->DepthUpdate(bidUpdates[i], askUpdates[i]);
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+}
+
+#define BENCHMARK_LADDER(PriceLevels, TLadderStorage) \
+    BENCHMARK_TEMPLATE(BM_LadderDepthUpdate, PriceLevels, FlatMapStorage, Support::Distribution::Synthetic); \
+    BENCHMARK_TEMPLATE(BM_LadderDepthUpdate, PriceLevels, TLadderStorage, Support::Distribution::Synthetic); \
+    BENCHMARK_TEMPLATE(BM_LadderDepthUpdate, PriceLevels, FlatMapStorage, Support::Distribution::RecordedLike); \
+    BENCHMARK_TEMPLATE(BM_LadderDepthUpdate, PriceLevels, TLadderStorage, Support::Distribution::RecordedLike); \
+    BENCHMARK_TEMPLATE(BM_LadderTopUpdate, PriceLevels, FlatMapStorage); \
+    BENCHMARK_TEMPLATE(BM_LadderTopUpdate, PriceLevels, TLadderStorage)
+
+BENCHMARK_LADDER(20, TickLadder256);
+BENCHMARK_LADDER(500, TickLadder4K);
+BENCHMARK_LADDER(5000, TickLadder32K);
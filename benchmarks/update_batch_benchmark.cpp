@@ -0,0 +1,162 @@
+#include <memory>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/update_batch.h"
+#include "support/market_data.h"
+
+/*
+ * A burst of updates spread over many books: applying every message as it arrives against collecting the burst
+ * into an UpdateBatch and applying it grouped by book with the next books prefetched.
+ * Books are allocated one by one on the heap, interleaved with other allocations, so every book is a cache miss
+ * and usually a TLB miss. BM_BatchedUpdates includes the time of filling the batch, BM_BatchedApply shows
+ * the application alone.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+    using TBatch = UpdateBatch<double, double>;
+
+    constexpr std::size_t BurstSize = 4096;
+    constexpr std::size_t MessagesCount = 64;
+    constexpr std::size_t NoiseSize = 16 * 1024;
+
+    struct Message {
+        SymbolId Book;
+        bool IsBBO;
+        std::size_t Payload;
+    };
+
+    class Fixture {
+        std::vector<std::unique_ptr<char[]>> Noise_;
+
+    public:
+        std::vector<std::unique_ptr<TBook>> Books;
+        std::vector<Message> Burst;
+        std::vector<Support::DepthMessage<double, double>> Depths = Support::GenerateDepthMessages<double, double>(MessagesCount, 5);
+        std::vector<Models::BookTicker<double, double>> Tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        explicit Fixture(std::size_t count) {
+            for (std::size_t index = 0; index < count; ++index) {
+                Books.push_back(std::make_unique<TBook>());
+                Noise_.push_back(std::make_unique<char[]>(NoiseSize));
+            }
+
+            std::mt19937 random(42);
+            std::uniform_int_distribution<std::size_t> books(0, count - 1);
+            std::uniform_int_distribution<std::size_t> payloads(0, MessagesCount - 1);
+            for (std::size_t index = 0; index < BurstSize; ++index) {
+                Burst.push_back({
+                    .Book = static_cast<SymbolId>(books(random)),
+                    .IsBBO = index % 2 != 0,
+                    .Payload = payloads(random),
+                });
+            }
+        }
+
+        TBook& BookOf(SymbolId id) {
+            return *Books[id];
+        }
+
+        void Apply(const Message& message) {
+            auto& book = BookOf(message.Book);
+            if (message.IsBBO) {
+                book.BBOUpdate(Tickers[message.Payload]);
+            } else {
+                book.DepthUpdate(Depths[message.Payload].Bids, Depths[message.Payload].Asks);
+            }
+        }
+
+        void Fill(TBatch& batch) const {
+            batch.Clear();
+            for (const auto& message : Burst) {
+                if (message.IsBBO) {
+                    batch.AddBBO(message.Book, Tickers[message.Payload]);
+                } else {
+                    batch.AddDepth(message.Book, Depths[message.Payload].Bids, Depths[message.Payload].Asks);
+                }
+            }
+        }
+    };
+
+    // Batched application must leave every book in the same state as applying the messages one by one.
+    bool SameAsSequential(std::size_t count) {
+        Fixture sequential(count);
+        Fixture batched(count);
+
+        for (const auto& message : sequential.Burst) {
+            sequential.Apply(message);
+        }
+
+        TBatch batch;
+        batched.Fill(batch);
+        batch.ApplyTo([&](SymbolId id) -> TBook& { return batched.BookOf(id); });
+
+        for (std::size_t index = 0; index < count; ++index) {
+            if (sequential.Books[index]->ToString() != batched.Books[index]->ToString()) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    void BM_SequentialUpdates(benchmark::State& state) {
+        Fixture fixture(static_cast<std::size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            for (const auto& message : fixture.Burst) {
+                fixture.Apply(message);
+            }
+
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * BurstSize);
+    }
+
+    // `fill` includes collecting the burst into the batch, otherwise the same batch is applied again and again.
+    void BatchedUpdates(benchmark::State& state, bool fill) {
+        const auto count = static_cast<std::size_t>(state.range(0));
+        const auto prefetchDistance = static_cast<std::size_t>(state.range(1));
+
+        if (!SameAsSequential(count)) {
+            state.SkipWithError("Batched updates differ from sequential ones");
+            return;
+        }
+
+        Fixture fixture(count);
+        TBatch batch;
+        fixture.Fill(batch);
+
+        for (auto _ : state) {
+            if (fill) {
+                fixture.Fill(batch);
+            }
+            batch.ApplyTo([&](SymbolId id) -> TBook& { return fixture.BookOf(id); }, prefetchDistance);
+
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * BurstSize);
+    }
+
+    void BM_BatchedUpdates(benchmark::State& state) {
+        BatchedUpdates(state, true);
+    }
+
+    void BM_BatchedApply(benchmark::State& state) {
+        BatchedUpdates(state, false);
+    }
+
+}
+
+BENCHMARK(BM_SequentialUpdates)->ArgName("books")->Arg(100)->Arg(1000)->Arg(10000);
+BENCHMARK(BM_BatchedUpdates)->ArgNames({"books", "prefetch"})->ArgsProduct({{100, 1000, 10000}, {0, 4, 8}});
+BENCHMARK(BM_BatchedApply)->ArgNames({"books", "prefetch"})->ArgsProduct({{100, 1000, 10000}, {0, 4, 8}});
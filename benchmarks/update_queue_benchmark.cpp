@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/update_queue.h"
+#include "support/market_data.h"
+
+namespace {
+
+    using namespace OrderBook;
+
+    constexpr std::size_t MessagesCount = 1024;
+    constexpr std::size_t UpdatesPerIteration = 1 << 16;
+
+    std::uint64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Percentile of sorted latencies.
+    double Percentile(const std::vector<std::uint64_t>& latencies, double percentile) {
+        const auto index = static_cast<std::size_t>(percentile / 100.0 * static_cast<double>(latencies.size() - 1));
+        return static_cast<double>(latencies[index]);
+    }
+
+    /*
+     * The producer thread pushes a mix of depth and BBO updates stamped with the push time,
+     * the benchmark thread owns the book, drains the queue and measures the time from push to applied update.
+    */
+    void BM_QueueToApplyLatency(benchmark::State& state) {
+        const auto batchSize = static_cast<std::size_t>(state.range(0));
+
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        const auto tickers = Support::GenerateBookTickers<double, double>(MessagesCount);
+
+        auto queue = std::make_unique<UpdateQueue<double, double, 20, 1024>>();
+        BinanceBook<> book;
+
+        std::vector<std::uint64_t> latencies;
+        latencies.reserve(UpdatesPerIteration * 16);
+
+        for (auto _ : state) {
+            std::jthread producer([&]() {
+                for (std::size_t index = 0; index < UpdatesPerIteration; ++index) {
+                    while (!queue->TryPushWith([&](auto& update) {
+                        if (index % 2 == 0) {
+                            const auto& message = messages[index / 2 % MessagesCount];
+                            update.SetDepth(message.Bids, message.Asks);
+                        } else {
+                            update.SetTicker(tickers[index / 2 % MessagesCount]);
+                        }
+                        update.Timestamp = Now();
+                    })) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+
+            for (std::size_t applied = 0; applied < UpdatesPerIteration;) {
+                const auto count = DrainUpdates(*queue, book, batchSize, [&](const auto& update) {
+                    if (latencies.size() < latencies.capacity()) {
+                        latencies.push_back(Now() - update.Timestamp);
+                    }
+                });
+
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+
+                applied += count;
+            }
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+
+        state.SetItemsProcessed(state.iterations() * UpdatesPerIteration);
+        state.counters["p50_ns"] = Percentile(latencies, 50);
+        state.counters["p90_ns"] = Percentile(latencies, 90);
+        state.counters["p99_ns"] = Percentile(latencies, 99);
+        state.counters["p99.9_ns"] = Percentile(latencies, 99.9);
+        state.counters["max_ns"] = static_cast<double>(latencies.back());
+    }
+
+}
+
+BENCHMARK(BM_QueueToApplyLatency)
+    ->ArgName("batch")
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(64)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,246 @@
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/ingest/websocket_decoder.h"
+#include "src/ingest/websocket_stream.h"
+#include "src/parsers/binance_parser.h"
+#include "support/payloads.h"
+
+/*
+ * Decoding a recorded WebSocket stream of Binance market data: combined stream depth updates and book tickers
+ * in unmasked text frames as the server sends them, every 64th message split into three fragments
+ * and a ping every 100 messages. The decoder alone, the decoder copying every payload into a string as
+ * generic WebSocket libraries do, the decoder feeding a book, and the whole client reading the stream
+ * from a loopback server stand-in over a Unix stream socket, answering its pings.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using namespace OrderBook::Ingest;
+
+    using TBook = BinanceBook<>;
+
+    constexpr std::size_t MessagesCount = 1000;
+    constexpr std::size_t FragmentedEvery = 64;
+    constexpr std::size_t PingEvery = 100;
+    constexpr std::size_t PingsCount = MessagesCount / PingEvery;
+
+    void AddFrame(std::vector<std::byte>& stream, WebSocketOpcode opcode, std::string_view payload, bool final = true) {
+        const std::size_t size = stream.size();
+        stream.resize(size + MaxWebSocketHeaderSize + payload.size());
+        const auto written = EncodeWebSocketFrame(stream.data() + size, opcode, std::as_bytes(std::span(payload)), final);
+        stream.resize(size + written);
+    }
+
+    std::vector<std::byte> RecordStream() {
+        std::vector<std::byte> stream;
+
+        for (std::size_t index = 0; index < MessagesCount; ++index) {
+            const auto payload = index % 2 == 0 ? Support::CombinedDepthPayload : Support::BookTickerPayload;
+
+            if (index % FragmentedEvery == 0) {
+                const std::size_t third = payload.size() / 3;
+                AddFrame(stream, WebSocketOpcode::Text, payload.substr(0, third), false);
+                AddFrame(stream, WebSocketOpcode::Continuation, payload.substr(third, third), false);
+                AddFrame(stream, WebSocketOpcode::Continuation, payload.substr(2 * third), true);
+            } else {
+                AddFrame(stream, WebSocketOpcode::Text, payload);
+            }
+
+            if (index % PingEvery == 0) {
+                AddFrame(stream, WebSocketOpcode::Ping, std::to_string(index));
+            }
+        }
+
+        return stream;
+    }
+
+    bool Apply(TBook& book, std::string_view message) {
+        if (message.find("\"lastUpdateId\"") != std::string_view::npos) {
+            if (auto depth = Parsers::ParseDepth(message)) {
+                book.DepthUpdate(depth->Bids, depth->Asks);
+                return true;
+            }
+        } else if (auto ticker = Parsers::ParseBookTicker(message)) {
+            book.BBOUpdate(ticker->Ticker);
+            return true;
+        }
+
+        return false;
+    }
+
+    // Decode the recorded stream once per iteration, `handler(message)` gets the data messages.
+    template <typename THandler>
+    void DecodeRecorded(benchmark::State& state, THandler&& handler) {
+        auto stream = RecordStream();
+        std::vector<std::byte> fragments(1 << 16);
+        WebSocketDecoder decoder(fragments);
+
+        std::size_t messages = 0;
+        for (auto _ : state) {
+            const auto result = decoder.Decode(stream, [&](const WebSocketMessage& message) {
+                if (message.Opcode == WebSocketOpcode::Text) {
+                    handler(message);
+                    ++messages;
+                }
+            });
+
+            if (result.Consumed != stream.size() || result.Error != WebSocketError::None) [[unlikely]] {
+                state.SkipWithError("Failed to decode the recorded stream");
+                break;
+            }
+        }
+
+        if (messages != MessagesCount * state.iterations()) {
+            state.SkipWithError("Not every message has been decoded");
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(messages));
+        state.SetBytesProcessed(static_cast<std::int64_t>(stream.size() * state.iterations()));
+    }
+
+    void BM_WebSocketDecode(benchmark::State& state) {
+        DecodeRecorded(state, [](const WebSocketMessage& message) {
+            benchmark::DoNotOptimize(message.Payload.data());
+        });
+    }
+
+    void BM_WebSocketDecodeCopyingPayloads(benchmark::State& state) {
+        DecodeRecorded(state, [](const WebSocketMessage& message) {
+            std::string payload(message.Text());
+            benchmark::DoNotOptimize(payload.data());
+        });
+    }
+
+    void BM_WebSocketDecodeIntoBook(benchmark::State& state) {
+        auto book = std::make_unique<TBook>();
+        DecodeRecorded(state, [&](const WebSocketMessage& message) {
+            Apply(*book, message.Text());
+        });
+    }
+
+    // Sends the recorded stream `copies` times followed by a Close, and counts the pongs of the client.
+    class LoopbackServer {
+        int Fd_;
+        std::vector<std::byte> Input_ = std::vector<std::byte>(1 << 16);
+        std::size_t InputSize_ = 0;
+        std::vector<std::byte> Fragments_ = std::vector<std::byte>(1 << 10);
+        WebSocketDecoder Decoder_{Fragments_};
+
+    public:
+        std::size_t Pongs = 0;
+        std::optional<std::uint16_t> CloseCode;
+
+        explicit LoopbackServer(int fd) : Fd_(fd) {
+        }
+
+        void Run(const std::vector<std::byte>& stream, std::size_t copies) {
+            for (std::size_t copy = 0; copy < copies; ++copy) {
+                Write(stream);
+                Receive(false);
+            }
+
+            std::vector<std::byte> close;
+            AddFrame(close, WebSocketOpcode::Close, std::string_view("\x03\xe8", 2));
+            Write(close);
+
+            while (!CloseCode && Receive(true)) {
+            }
+        }
+
+    private:
+        void Write(const std::vector<std::byte>& data) const {
+            std::size_t written = 0;
+            while (written != data.size()) {
+                const ssize_t size = ::send(Fd_, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+                if (size < 0) {
+                    throw std::system_error(errno, std::generic_category(), "Loopback server failed to send");
+                }
+                written += static_cast<std::size_t>(size);
+            }
+        }
+
+        // Read the frames of the client, returns false once the client has closed the socket.
+        bool Receive(bool wait) {
+            const ssize_t size = ::recv(Fd_, Input_.data() + InputSize_, Input_.size() - InputSize_, wait ? 0 : MSG_DONTWAIT);
+            if (size <= 0) {
+                return size < 0 && errno == EAGAIN;
+            }
+            InputSize_ += static_cast<std::size_t>(size);
+
+            const auto result = Decoder_.Decode(std::span(Input_).first(InputSize_), [&](const WebSocketMessage& message) {
+                if (message.Opcode == WebSocketOpcode::Pong) {
+                    ++Pongs;
+                } else if (message.Opcode == WebSocketOpcode::Close) {
+                    CloseCode = message.CloseCode();
+                }
+            });
+
+            InputSize_ -= result.Consumed;
+            std::memmove(Input_.data(), Input_.data() + result.Consumed, InputSize_);
+            return true;
+        }
+    };
+
+    void BM_WebSocketLoopbackIntoBook(benchmark::State& state) {
+        int sockets[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0) {
+            state.SkipWithError("Failed to create a socket pair");
+            return;
+        }
+
+        const auto stream = RecordStream();
+        LoopbackServer server(sockets[0]);
+        std::thread serverThread([&, copies = static_cast<std::size_t>(state.max_iterations)] {
+            server.Run(stream, copies);
+        });
+
+        auto book = std::make_unique<TBook>();
+        WebSocketStream client(sockets[1], 1 << 16);
+
+        std::size_t applied = 0;
+        std::size_t expected = 0;
+        for (auto _ : state) {
+            expected += MessagesCount;
+            while (applied != expected && client.Poll([&](const WebSocketMessage& message) {
+                applied += Apply(*book, message.Text());
+            })) {
+            }
+        }
+
+        // Take the Close of the server, the client answers it.
+        while (client.Poll([&](const WebSocketMessage&) {})) {
+        }
+
+        serverThread.join();
+        ::close(sockets[0]);
+        ::close(sockets[1]);
+
+        if (applied != expected || server.Pongs != PingsCount * state.iterations() || server.CloseCode != 1000) {
+            state.SkipWithError("The loopback session didn't complete");
+        }
+
+        state.SetItemsProcessed(static_cast<std::int64_t>(applied));
+        state.SetBytesProcessed(static_cast<std::int64_t>(stream.size() * state.iterations()));
+    }
+
+}
+
+BENCHMARK(BM_WebSocketDecode);
+BENCHMARK(BM_WebSocketDecodeCopyingPayloads);
+BENCHMARK(BM_WebSocketDecodeIntoBook);
+BENCHMARK(BM_WebSocketLoopbackIntoBook)->UseRealTime();
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "src/order_book.h"
+#include "src/tick_ladder.h"
+#include "src/wire/wire_decoder.h"
+#include "src/wire/wire_encoder.h"
+#include "support/market_data.h"
+
+/*
+ * Wire encoding of a 20 level book: snapshots and deltas of depth updates (from level events), encoding
+ * and decoding straight into a consumer book. The bytes_per_update counter is the size of the messages,
+ * the decoding benchmarks fail if the consumer book differs from the encoded one.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+
+    using TBook = BinanceBook<>;
+    // The consumer keeps one level more, see WireDecoder.
+    using TConsumerBook = BinanceBook<double, double, 21>;
+    using TPriceTicks = DecimalTicks<100>;
+    using TQuantityLots = DecimalTicks<100'000'000>;
+    using TEncoder = Wire::WireEncoder<double, double, TPriceTicks, TQuantityLots>;
+    using TDecoder = Wire::WireDecoder<double, double, TPriceTicks, TQuantityLots>;
+
+    constexpr std::size_t MessagesCount = 1000;
+
+    // Encoded messages of a stream: a snapshot followed by the deltas of the depth updates.
+    struct Stream {
+        std::vector<std::vector<std::byte>> Messages;
+        std::size_t Bytes = 0;
+        TBook Book; // the book after the last message
+    };
+
+    // Books can't be moved, so the stream is filled in place.
+    void EncodeStream(Stream& stream) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+
+        std::vector<TBook::TLevelEventBuffer::TLevelEvent> storage(256);
+        TBook::TLevelEventBuffer events(storage);
+        TEncoder encoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(256));
+
+        stream.Book.DepthUpdate(messages[0].Bids, messages[0].Asks);
+        stream.Book.EmitLevelEventsTo(&events);
+        const auto snapshotSize = encoder.EncodeSnapshot(stream.Book, buffer);
+        stream.Messages.emplace_back(buffer.begin(), buffer.begin() + snapshotSize);
+
+        for (std::size_t index = 1; index < MessagesCount; ++index) {
+            events.Clear();
+            stream.Book.DepthUpdate(messages[index].Bids, messages[index].Asks);
+
+            const auto size = encoder.EncodeDelta(stream.Book, events.Events(), buffer);
+            stream.Messages.emplace_back(buffer.begin(), buffer.begin() + size);
+            stream.Bytes += size;
+        }
+
+        stream.Book.EmitLevelEventsTo(nullptr);
+    }
+
+    bool SameLevels(const auto& lhs, const auto& rhs) {
+        const auto [lhsBids, lhsAsks] = lhs.Levels();
+        const auto [rhsBids, rhsAsks] = rhs.Levels();
+
+        auto same = [](const auto& left, const auto& right) {
+            return std::ranges::equal(left, right, [](const auto& a, const auto& b) {
+                return a.Price == b.Price && a.Quantity == b.Quantity;
+            });
+        };
+
+        return same(lhsBids, rhsBids) && same(lhsAsks, rhsAsks);
+    }
+
+    void BM_EncodeSnapshot(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(1, 20);
+        TBook book;
+        book.DepthUpdate(messages[0].Bids, messages[0].Asks);
+
+        TEncoder encoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(64));
+        std::size_t size = 0;
+
+        for (auto _ : state) {
+            size = encoder.EncodeSnapshot(book, buffer);
+            benchmark::DoNotOptimize(buffer.data());
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.counters["bytes_per_update"] = static_cast<double>(size);
+        state.counters["raw_bytes"] = static_cast<double>(40 * sizeof(Models::PriceQuantity<double, double>));
+    }
+
+    void BM_DecodeSnapshot(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(1, 20);
+        TBook book;
+        book.DepthUpdate(messages[0].Bids, messages[0].Asks);
+
+        TEncoder encoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(64));
+        buffer.resize(encoder.EncodeSnapshot(book, buffer));
+
+        TConsumerBook consumer;
+        for (auto _ : state) {
+            TDecoder decoder;
+            benchmark::DoNotOptimize(decoder.Apply(buffer, consumer));
+        }
+
+        if (!SameLevels(book, consumer)) {
+            state.SkipWithError("The decoded book differs from the encoded one");
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void BM_EncodeDelta(benchmark::State& state) {
+        const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+        TBook book;
+        std::vector<TBook::TLevelEventBuffer::TLevelEvent> storage(256);
+        TBook::TLevelEventBuffer events(storage);
+        book.EmitLevelEventsTo(&events);
+
+        // Events of every update are recorded up front, all of them are encoded against the last state of the book.
+        std::vector<std::vector<TBook::TLevelEventBuffer::TLevelEvent>> updates;
+        for (const auto& message : messages) {
+            events.Clear();
+            book.DepthUpdate(message.Bids, message.Asks);
+            updates.emplace_back(events.Events().begin(), events.Events().end());
+        }
+
+        TEncoder encoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(256));
+        std::size_t bytes = 0;
+        std::size_t index = 0;
+
+        for (auto _ : state) {
+            bytes += encoder.EncodeDelta(book, updates[index++ % MessagesCount], buffer);
+            benchmark::DoNotOptimize(buffer.data());
+        }
+
+        state.SetItemsProcessed(state.iterations());
+        state.counters["bytes_per_update"] = benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+    }
+
+    void BM_DecodeDeltas(benchmark::State& state) {
+        Stream stream;
+        EncodeStream(stream);
+        TConsumerBook consumer;
+        bool synced = true;
+
+        for (auto _ : state) {
+            TDecoder decoder;
+            for (const auto& message : stream.Messages) {
+                synced &= decoder.Apply(message, consumer) == Wire::DecodeStatus::Applied;
+            }
+        }
+
+        if (!synced || !SameLevels(stream.Book, consumer)) {
+            state.SkipWithError("The decoded book differs from the encoded one");
+        }
+
+        state.SetItemsProcessed(state.iterations() * MessagesCount);
+        state.counters["bytes_per_update"] = static_cast<double>(stream.Bytes) / (MessagesCount - 1);
+    }
+
+}
+
+BENCHMARK(BM_EncodeSnapshot);
+BENCHMARK(BM_DecodeSnapshot);
+BENCHMARK(BM_EncodeDelta);
+BENCHMARK(BM_DecodeDeltas);
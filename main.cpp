@@ -1,4 +1,8 @@
+#include <iostream>
 #include <ostream>
+#include <sstream>
+
+#include <boost/format.hpp>
 
 #include "src/order_book.h"
 #include "src/models/book_ticker.h"
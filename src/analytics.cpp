@@ -0,0 +1 @@
+#include "analytics.h"
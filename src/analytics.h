@@ -0,0 +1,352 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+namespace OrderBook {
+
+    enum class BookSide : std::uint8_t {
+        Bids,
+        Asks,
+    };
+
+    namespace Details {
+
+        // Analytics are computed in doubles for any price/quantity representation.
+        template <typename T>
+        double ToDouble(const T& value) noexcept {
+            if constexpr (std::is_arithmetic_v<T>) {
+                return static_cast<double>(value);
+            } else {
+                return value.ToDouble();
+            }
+        }
+
+    }
+
+    /*
+     * Running sums of one side of the book, kept up to date by OrderMap (with EnabledAnalytics) on every change
+     * of its orders, so reading derived values never walks the book.
+     *
+     * Mirrors the stored orders of the side in the book order together with the prefix sums of their quantities
+     * and notionals, and keeps the best order as it is. A change of an order shifts the mirror like the flat storage
+     * and recomputes the sums from that order to the end, so the sums never accumulate rounding errors of deltas.
+     * The visible levels (see OrderMap::Levels) are the best order followed by the stored orders from First_ on.
+    */
+    template <typename TPrice, typename TKeyComparator, std::size_t MaxLevels>
+    class SideAnalytics {
+        struct Level {
+            TPrice Price{};
+            double PriceValue = 0;
+            double Quantity = 0;
+        };
+
+        std::array<Level, MaxLevels> Levels_{};
+        std::array<double, MaxLevels + 1> CumulativeQuantity_{}; // sum of quantities of stored levels [0, i)
+        std::array<double, MaxLevels + 1> CumulativeNotional_{}; // sum of price * quantity of stored levels [0, i)
+        std::size_t Count_ = 0;
+        std::size_t First_ = 0; // the first stored level under the best order
+        TPrice Best_{};
+        double BestPrice_ = 0;
+        double BestQuantity_ = 0;
+        [[no_unique_address]] TKeyComparator Comparator_;
+
+    public:
+        // Insert the stored order at the price or replace its quantity.
+        void Set(const TPrice& price, double quantity) noexcept {
+            const std::size_t position = Find(price);
+
+            if (position == Count_ || Levels_[position].Price != price) {
+                assert(Count_ < MaxLevels);
+                std::copy_backward(Levels_.begin() + position, Levels_.begin() + Count_, Levels_.begin() + Count_ + 1);
+                Levels_[position].Price = price;
+                Levels_[position].PriceValue = Details::ToDouble(price);
+                ++Count_;
+            }
+
+            Levels_[position].Quantity = quantity;
+            Recompute(position);
+        }
+
+        // Remove the stored order at the price if there is one.
+        void Erase(const TPrice& price) noexcept {
+            const std::size_t position = Find(price);
+            if (position == Count_ || Levels_[position].Price != price) {
+                return;
+            }
+
+            std::copy(Levels_.begin() + position + 1, Levels_.begin() + Count_, Levels_.begin() + position);
+            --Count_;
+            Recompute(position);
+        }
+
+        // Remove the last stored order, evicted by OrderMap to keep its size.
+        void EraseWorst() noexcept {
+            assert(Count_ != 0);
+            --Count_;
+            UpdateFirst();
+        }
+
+        void SetBest(const TPrice& price, double quantity) noexcept {
+            Best_ = price;
+            BestPrice_ = Details::ToDouble(price);
+            BestQuantity_ = quantity;
+            UpdateFirst();
+        }
+
+        void Clear() noexcept {
+            Count_ = 0;
+            First_ = 0;
+        }
+
+        // Take the stored orders and the best order as they are, e.g. after a restore of the side.
+        void Rebuild(const TPrice& bestPrice, double bestQuantity, const auto& orders) noexcept {
+            Count_ = 0;
+            for (const auto& [price, quantity] : orders) {
+                if (Count_ == MaxLevels) {
+                    break;
+                }
+
+                Levels_[Count_++] = {price, Details::ToDouble(price), Details::ToDouble(quantity)};
+            }
+
+            Recompute(0);
+            SetBest(bestPrice, bestQuantity);
+        }
+
+        // Rebuild if the storage has dropped orders on its own (TickLadder moving its window).
+        void Follow(const TPrice& bestPrice, double bestQuantity, const auto& orders) noexcept {
+            if (orders.size() != Count_) [[unlikely]] {
+                Rebuild(bestPrice, bestQuantity, orders);
+            }
+        }
+
+        [[nodiscard]]
+        bool IsEmpty() const noexcept {
+            return Count_ == 0;
+        }
+
+        [[nodiscard]]
+        double BestPrice() const noexcept {
+            return BestPrice_;
+        }
+
+        [[nodiscard]]
+        double BestQuantity() const noexcept {
+            return BestQuantity_;
+        }
+
+        // Total quantity of the top visible levels.
+        [[nodiscard]]
+        double Depth(std::size_t levels) const noexcept {
+            if (IsEmpty() || levels == 0) {
+                return 0;
+            }
+
+            const std::size_t last = First_ + std::min(levels - 1, Count_ - First_);
+            return BestQuantity_ + (CumulativeQuantity_[last] - CumulativeQuantity_[First_]);
+        }
+
+        // See BookAnalytics::VwapToSize.
+        [[nodiscard]]
+        std::optional<double> VwapToSize(double quantity) const noexcept {
+            if (IsEmpty() || quantity <= 0) {
+                return std::nullopt;
+            }
+
+            if (quantity <= BestQuantity_) {
+                return BestPrice_;
+            }
+
+            // Quantity to fill from the stored levels under the best one, in terms of the prefix sums.
+            const double target = quantity - BestQuantity_ + CumulativeQuantity_[First_];
+            const auto* begin = CumulativeQuantity_.data() + First_ + 1;
+            const auto* end = CumulativeQuantity_.data() + Count_ + 1;
+            const auto* filled = std::lower_bound(begin, end, target);
+            if (filled == end) {
+                return std::nullopt;
+            }
+
+            // The level at which the quantity is filled and the levels before it.
+            const auto last = static_cast<std::size_t>(filled - CumulativeQuantity_.data()) - 1;
+            const double filledQuantity = BestQuantity_ + (CumulativeQuantity_[last] - CumulativeQuantity_[First_]);
+            const double filledNotional = BestPrice_ * BestQuantity_
+                                          + (CumulativeNotional_[last] - CumulativeNotional_[First_]);
+
+            return (filledNotional + (quantity - filledQuantity) * Levels_[last].PriceValue) / quantity;
+        }
+
+    private:
+        // Position of the first stored level at the price or under it.
+        [[nodiscard]]
+        std::size_t Find(const TPrice& price) const noexcept {
+            const auto it = std::lower_bound(Levels_.begin(), Levels_.begin() + Count_, price,
+                                             [this](const Level& level, const TPrice& value) {
+                                                 return Comparator_(level.Price, value);
+                                             });
+            return static_cast<std::size_t>(it - Levels_.begin());
+        }
+
+        void Recompute(std::size_t position) noexcept {
+            for (std::size_t index = position; index < Count_; ++index) {
+                CumulativeQuantity_[index + 1] = CumulativeQuantity_[index] + Levels_[index].Quantity;
+                CumulativeNotional_[index + 1] = CumulativeNotional_[index]
+                                                 + Levels_[index].PriceValue * Levels_[index].Quantity;
+            }
+
+            UpdateFirst();
+        }
+
+        // Usually the best order is the first stored one, unless a BBO update has moved it down the book.
+        void UpdateFirst() noexcept {
+            First_ = 0;
+            if (Count_ == 0 || Comparator_(Best_, Levels_[0].Price)) {
+                return;
+            }
+
+            if (Comparator_(Levels_[0].Price, Best_)) [[unlikely]] {
+                First_ = Find(Best_);
+            }
+
+            if (First_ != Count_ && !Comparator_(Best_, Levels_[First_].Price)) {
+                ++First_;
+            }
+        }
+    };
+
+    /*
+     * Derived values of a book: mid, spread, microprice, imbalance, cumulative depth and the average price
+     * to fill a given quantity (VWAP to size).
+     *
+     * A view over the SideAnalytics of both sides, which are maintained by the sides on every update,
+     * so every query is O(1) (or O(log MaxLevels) for VWAP to size) and always reflects the current book.
+    */
+    template <typename TBids, typename TAsks>
+    class BookAnalytics {
+        const TBids& Bids_;
+        const TAsks& Asks_;
+
+    public:
+        BookAnalytics(const TBids& bids, const TAsks& asks) noexcept : Bids_(bids), Asks_(asks) {
+        }
+
+        // All the values below which need both sides are std::nullopt if either side is empty.
+
+        [[nodiscard]]
+        std::optional<double> Mid() const noexcept {
+            if (!HasBothSides()) {
+                return std::nullopt;
+            }
+
+            return (Bids_.BestPrice() + Asks_.BestPrice()) / 2;
+        }
+
+        [[nodiscard]]
+        std::optional<double> Spread() const noexcept {
+            if (!HasBothSides()) {
+                return std::nullopt;
+            }
+
+            return Asks_.BestPrice() - Bids_.BestPrice();
+        }
+
+        // Mid weighted by the opposite quantities of the best levels, it leans towards the side
+        // which is likely to be consumed first. std::nullopt if both best levels have no quantity.
+        [[nodiscard]]
+        std::optional<double> Microprice() const noexcept {
+            if (!HasBothSides()) {
+                return std::nullopt;
+            }
+
+            const double bidQuantity = Bids_.BestQuantity();
+            const double askQuantity = Asks_.BestQuantity();
+            if (bidQuantity + askQuantity == 0) {
+                return std::nullopt;
+            }
+
+            return (Bids_.BestPrice() * askQuantity + Asks_.BestPrice() * bidQuantity) / (bidQuantity + askQuantity);
+        }
+
+        // (bids - asks) / (bids + asks) for the quantities of the top levels of each side, in [-1, 1].
+        // std::nullopt if these levels have no quantity.
+        [[nodiscard]]
+        std::optional<double> Imbalance(std::size_t levels = 1) const noexcept {
+            if (!HasBothSides()) {
+                return std::nullopt;
+            }
+
+            const double bids = Bids_.Depth(levels);
+            const double asks = Asks_.Depth(levels);
+            if (bids + asks == 0) {
+                return std::nullopt;
+            }
+
+            return (bids - asks) / (bids + asks);
+        }
+
+        // Total quantity of the top levels of the side.
+        [[nodiscard]]
+        double CumulativeDepth(BookSide side, std::size_t levels) const noexcept {
+            return side == BookSide::Bids ? Bids_.Depth(levels) : Asks_.Depth(levels);
+        }
+
+        /*
+         * Average price of filling the quantity by consuming levels of the side starting from the best one,
+         * e.g. the price of a market buy order of this quantity for the asks.
+         * std::nullopt if the levels of the side are not enough to fill it.
+        */
+        [[nodiscard]]
+        std::optional<double> VwapToSize(BookSide side, double quantity) const noexcept {
+            return side == BookSide::Bids ? Bids_.VwapToSize(quantity) : Asks_.VwapToSize(quantity);
+        }
+
+    private:
+        [[nodiscard]]
+        bool HasBothSides() const noexcept {
+            return !Bids_.IsEmpty() && !Asks_.IsEmpty();
+        }
+    };
+
+    // Analytics policy of BinanceBook without any analytics, the sides keep nothing and every update is a no-op.
+    struct DisabledAnalytics {
+        static constexpr bool Enabled = false;
+
+        template <typename TPrice, typename TKeyComparator, std::size_t MaxLevels>
+        struct TSide {
+            void Set(const TPrice&, double) noexcept {
+            }
+
+            void Erase(const TPrice&) noexcept {
+            }
+
+            void EraseWorst() noexcept {
+            }
+
+            void SetBest(const TPrice&, double) noexcept {
+            }
+
+            void Clear() noexcept {
+            }
+
+            void Rebuild(const TPrice&, double, const auto&) noexcept {
+            }
+
+            void Follow(const TPrice&, double, const auto&) noexcept {
+            }
+        };
+    };
+
+    // Analytics policy of BinanceBook keeping SideAnalytics in both sides, see BinanceBook::Analytics.
+    struct EnabledAnalytics {
+        static constexpr bool Enabled = true;
+
+        template <typename TPrice, typename TKeyComparator, std::size_t MaxLevels>
+        using TSide = SideAnalytics<TPrice, TKeyComparator, MaxLevels>;
+    };
+
+}
@@ -0,0 +1,277 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "utils/decimal.h"
+
+namespace OrderBook {
+
+    namespace Details {
+
+        // Width of the price and quantity columns.
+        inline constexpr int ColumnWidth = 9;
+
+        inline std::to_chars_result Append(char* first, char* last, std::string_view text) noexcept {
+            if (static_cast<std::size_t>(last - first) < text.size()) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            std::memcpy(first, text.data(), text.size());
+            return {first + text.size(), std::errc()};
+        }
+
+        inline std::to_chars_result AppendSpaces(char* first, char* last, int count) noexcept {
+            if (last - first < count) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            std::memset(first, ' ', count);
+            return {first + count, std::errc()};
+        }
+
+        inline constexpr double Powers10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8};
+
+        // Exchange prices and quantities are short decimals. If the double is the nearest one to units / 10^decimals,
+        // printf would print the digits of exactly this decimal, so they can be written with integer arithmetic,
+        // which is several times faster than std::to_chars with precision.
+        // Returns std::nullopt if the value is not such a decimal or is too large for the shortcut.
+        inline std::optional<std::int64_t> ToDecimalUnits(double value, unsigned decimals) noexcept {
+            // Below 2^51 units the distance between neighbouring doubles is at most half a unit,
+            // so the decimal is the only candidate printf could round the exact value of the double to.
+            constexpr double MaxUnits = 2251799813685248.0;
+
+            const double scale = Powers10[decimals];
+            const double scaled = value * scale;
+            if (!(std::fabs(scaled) < MaxUnits)) {
+                return std::nullopt;
+            }
+
+            // Any nearby candidate works, it is verified below.
+            const auto units = static_cast<std::int64_t>(scaled + (scaled < 0 ? -0.5 : 0.5));
+            if (static_cast<double>(units) / scale != value || (units == 0 && std::signbit(value))) {
+                return std::nullopt;
+            }
+
+            return units;
+        }
+
+        // Write units / 10^decimals with exactly `decimals` fractional digits.
+        inline std::to_chars_result FormatUnits(char* first, char* last, std::int64_t units, unsigned decimals) noexcept {
+            const auto absolute = units < 0 ? -static_cast<std::uint64_t>(units) : static_cast<std::uint64_t>(units);
+
+            // All digits are written at once and the point is inserted between them,
+            // which avoids dividing by the runtime power of 10.
+            char digits[20];
+            const auto count = static_cast<unsigned>(std::to_chars(std::begin(digits), std::end(digits), absolute).ptr - digits);
+            const unsigned integralCount = count > decimals ? count - decimals : 0;
+            const unsigned leadingZeros = decimals - (count - integralCount);
+
+            const std::size_t size = (units < 0) + std::max(integralCount, 1u) + (decimals != 0) + decimals;
+            if (static_cast<std::size_t>(last - first) < size) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            if (units < 0) {
+                *first++ = '-';
+            }
+
+            if (integralCount == 0) {
+                *first++ = '0';
+            } else {
+                first = std::copy_n(digits, integralCount, first);
+            }
+
+            if (decimals != 0) {
+                *first++ = '.';
+                first = std::fill_n(first, leadingZeros, '0');
+                first = std::copy(digits + integralCount, digits + count, first);
+            }
+
+            return {first, std::errc()};
+        }
+
+        // printf("%.<precision>f", value).
+        inline std::to_chars_result FormatFixed(char* first, char* last, double value, int precision) noexcept {
+            if (const auto units = ToDecimalUnits(value, precision)) [[likely]] {
+                return FormatUnits(first, last, *units, precision);
+            }
+
+            return std::to_chars(first, last, value, std::chars_format::fixed, precision);
+        }
+
+        // printf("%.<precision>g", value).
+        inline std::to_chars_result FormatGeneral(char* first, char* last, double value, int precision) noexcept {
+            // Enough for the quantities of any exchange, the magnitude is limited by ToDecimalUnits anyway.
+            constexpr unsigned MaxDecimals = 8;
+
+            if (auto units = ToDecimalUnits(value, MaxDecimals)) [[likely]] {
+                // %g drops the trailing zeros of the fraction.
+                unsigned decimals = MaxDecimals;
+                while (decimals != 0 && *units % 10 == 0) {
+                    *units /= 10;
+                    --decimals;
+                }
+
+                if (*units == 0) {
+                    return Append(first, last, "0");
+                }
+
+                int digits = 0;
+                for (auto rest = *units; rest != 0; rest /= 10) {
+                    ++digits;
+                }
+
+                // %g uses the fixed notation if the exponent of the value is in [-4, precision).
+                const int exponent = digits - static_cast<int>(decimals) - 1;
+                if (digits <= precision && exponent >= -4 && exponent < precision) {
+                    return FormatUnits(first, last, *units, decimals);
+                }
+            }
+
+            return std::to_chars(first, last, value, std::chars_format::general, precision);
+        }
+
+        // Floating-point values are written the same way as printf with the given format and precision,
+        // integral values as they are, other types (e.g. Models::FixedPoint) by their own ToChars.
+        template <typename T>
+        std::to_chars_result FormatNumber(char* first, char* last, const T& value,
+                                          std::chars_format format, int precision) noexcept {
+            if constexpr (std::is_same_v<T, double>) {
+                return format == std::chars_format::fixed ? FormatFixed(first, last, value, precision)
+                                                          : FormatGeneral(first, last, value, precision);
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return std::to_chars(first, last, value, format, precision);
+            } else if constexpr (std::is_integral_v<T>) {
+                return std::to_chars(first, last, value);
+            } else {
+                return ToChars(first, last, value);
+            }
+        }
+
+        // Write the number padded with spaces up to `width` characters, aligned to the right unless `left` is set.
+        template <typename T>
+        std::to_chars_result FormatAligned(char* first, char* last, const T& value, std::chars_format format,
+                                           int precision, int width, bool left) noexcept {
+            auto result = FormatNumber(first, last, value, format, precision);
+            if (result.ec != std::errc()) [[unlikely]] {
+                return result;
+            }
+
+            const int padding = width - static_cast<int>(result.ptr - first);
+            if (padding <= 0) {
+                return result;
+            }
+
+            if (last - result.ptr < padding) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            if (!left) {
+                std::memmove(first + padding, first, result.ptr - first);
+                std::memset(first, ' ', padding);
+            } else {
+                std::memset(result.ptr, ' ', padding);
+            }
+
+            return {result.ptr + padding, std::errc()};
+        }
+
+        // Prices are printed with 3 fractional digits ("%.3f"), quantities in the shortest form
+        // with 6 significant digits (the default stream formatting).
+        template <typename TPrice>
+        std::to_chars_result FormatPrice(char* first, char* last, const TPrice& price) noexcept {
+            return FormatNumber(first, last, price, std::chars_format::fixed, 3);
+        }
+
+        template <typename TQuantity>
+        std::to_chars_result FormatQuantity(char* first, char* last, const TQuantity& quantity, bool left) noexcept {
+            return FormatAligned(first, last, quantity, std::chars_format::general, 6, ColumnWidth, left);
+        }
+
+        // Write a single line of the book: "[ 1] [  0.00431] 20078.540 | 20078.910 [0.03437  ]\n".
+        // A missing side is replaced by empty columns.
+        template <typename TPriceQuantity>
+        std::to_chars_result FormatLine(char* first, char* last, int index,
+                                        const TPriceQuantity* bid, const TPriceQuantity* ask) noexcept {
+            auto result = Append(first, last, "[");
+
+            auto step = [&](auto&& write) {
+                if (result.ec == std::errc()) [[likely]] {
+                    result = write(result.ptr);
+                }
+            };
+
+            step([&](char* it) { return FormatAligned(it, last, index, std::chars_format::general, 0, 2, false); });
+            step([&](char* it) { return Append(it, last, "] ["); });
+            step([&](char* it) {
+                return bid != nullptr ? FormatQuantity(it, last, bid->Quantity, false) : AppendSpaces(it, last, ColumnWidth);
+            });
+            step([&](char* it) { return Append(it, last, "] "); });
+            step([&](char* it) {
+                return bid != nullptr ? FormatPrice(it, last, bid->Price) : AppendSpaces(it, last, ColumnWidth);
+            });
+            step([&](char* it) { return Append(it, last, " | "); });
+            step([&](char* it) {
+                return ask != nullptr ? FormatPrice(it, last, ask->Price) : AppendSpaces(it, last, ColumnWidth);
+            });
+            step([&](char* it) { return Append(it, last, " ["); });
+            step([&](char* it) {
+                return ask != nullptr ? FormatQuantity(it, last, ask->Quantity, true) : AppendSpaces(it, last, ColumnWidth);
+            });
+            step([&](char* it) { return Append(it, last, "]\n"); });
+
+            return result;
+        }
+
+    }
+
+    // Size of a formatted line with typical prices (up to 6 integral digits), the buffer of
+    // FormattedLineSize * (PriceLevels + 1) characters is usually enough for the whole book.
+    inline constexpr std::size_t FormattedLineSize = 64;
+
+    /*
+     * Writes the book into [first, last) in the manner of std::to_chars, without allocations:
+     * one line per level with bids on the left and asks on the right, the same layout as printed by operator<<.
+     * An empty book is written as "[]".
+     *
+     * On success returns the pointer past the last written character. If the buffer is too small,
+     * returns {last, std::errc::value_too_large} and the contents of the buffer are unspecified.
+    */
+    template <typename TBook>
+    std::to_chars_result FormatBook(char* first, char* last, const TBook& book) noexcept {
+        if (book.IsEmpty()) {
+            return Details::Append(first, last, "[]");
+        }
+
+        auto [bids, asks] = book.Levels();
+
+        auto bidIt = bids.begin();
+        auto askIt = asks.begin();
+        std::to_chars_result result{first, std::errc()};
+
+        for (int index = 1; bidIt != bids.end() || askIt != asks.end(); ++index) {
+            const auto bid = bidIt != bids.end() ? std::optional(*bidIt++) : std::nullopt;
+            const auto ask = askIt != asks.end() ? std::optional(*askIt++) : std::nullopt;
+
+            result = Details::FormatLine(result.ptr, last, index,
+                                         bid ? &*bid : nullptr,
+                                         ask ? &*ask : nullptr);
+            if (result.ec != std::errc()) [[unlikely]] {
+                return result;
+            }
+        }
+
+        return result;
+    }
+
+}
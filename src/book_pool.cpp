@@ -0,0 +1 @@
+#include "book_pool.h"
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "utils/memory_region.h"
+
+namespace OrderBook {
+
+    struct BookPoolOptions {
+        bool UseHugePages = true;
+        int NumaNode = -1; // node to bind the memory to, -1 keeps the default placement
+    };
+
+    // Memory used by the books of a BookPool.
+    struct BookPoolFootprint {
+        std::size_t BookSize{};   // sizeof the book, both sides with their inline storage
+        std::size_t Stride{};     // distance between neighbouring books, the size rounded up to the cache line
+        std::size_t Capacity{};   // number of books the region can hold
+        std::size_t Size{};       // number of books created
+        std::size_t RegionSize{}; // mapped bytes, rounded up to the page size
+        Utils::PageKind Pages{};
+        int NumaNode = -1;        // node the region is bound to, -1 if it is not bound
+
+        // Mapped bytes per created book, including the unused tail of the region.
+        [[nodiscard]]
+        std::size_t BytesPerBook() const noexcept {
+            return Size != 0 ? RegionSize / Size : 0;
+        }
+
+        // Number of pages touched by the created books.
+        [[nodiscard]]
+        std::size_t PagesUsed() const noexcept {
+            const std::size_t pageSize = Pages == Utils::PageKind::Regular ? 4096 : Utils::HugePageSize;
+            return (Size * Stride + pageSize - 1) / pageSize;
+        }
+    };
+
+    /*
+     * Places many books side by side in one contiguous region, preferably backed by 2MB pages
+     * and bound to the NUMA node of the thread which updates them.
+     *
+     * The storage of a book lives inside of it (StackMemoryAllocator arenas of both sides), so books can't be
+     * moved and end up wherever they are allocated. A thread updating hundreds of books allocated one by one
+     * touches a separate 4KB page for almost every book, and the TLB can't cover them all. Books of a pool
+     * are constructed in place in a single region, each one on its own cache lines, so a 2MB page holds
+     * about 1800 books of 20 levels.
+     *
+     * Books are created in order and live until the pool is destroyed. A pool is meant to be owned by one
+     * shard: create it on the thread serving the shard after pinning it, so the node is known
+     * (see Utils::CurrentNumaNode) and the pages are touched first by that thread.
+    */
+    template <typename TBook>
+    class BookPool {
+        static constexpr std::size_t CacheLineSize = 64;
+        static constexpr std::size_t Alignment = alignof(TBook) > CacheLineSize ? alignof(TBook) : CacheLineSize;
+
+    public:
+        static constexpr std::size_t Stride = (sizeof(TBook) + Alignment - 1) / Alignment * Alignment;
+
+    private:
+        Utils::MemoryRegion Region_;
+        std::size_t Capacity_ = 0;
+        std::size_t Size_ = 0;
+        int NumaNode_ = -1;
+
+    public:
+        // Throws std::system_error if the memory can't be mapped.
+        explicit BookPool(std::size_t capacity, BookPoolOptions options = {})
+            : Region_(capacity * Stride, options.UseHugePages), Capacity_(Region_.Size() / Stride) {
+            if (options.NumaNode >= 0 && Region_.BindToNumaNode(options.NumaNode)) {
+                NumaNode_ = options.NumaNode;
+            }
+        }
+
+        // Books are referenced by their owners.
+        BookPool(const BookPool&) = delete;
+        BookPool& operator=(const BookPool&) = delete;
+
+        ~BookPool() {
+            for (std::size_t index = Size_; index-- > 0; ) {
+                Book(index).~TBook();
+            }
+        }
+
+        // Construct the next book in place. Throws std::length_error if the pool is full.
+        template <typename... TArgs>
+        TBook& Emplace(TArgs&&... args) {
+            if (Size_ == Capacity_) [[unlikely]] {
+                throw std::length_error("BookPool is full");
+            }
+
+            auto* book = ::new (Address(Size_)) TBook(std::forward<TArgs>(args)...);
+            ++Size_;
+
+            return *book;
+        }
+
+        [[nodiscard]]
+        TBook& Book(std::size_t index) noexcept {
+            return *std::launder(reinterpret_cast<TBook*>(Address(index)));
+        }
+
+        [[nodiscard]]
+        const TBook& Book(std::size_t index) const noexcept {
+            return *std::launder(reinterpret_cast<const TBook*>(Address(index)));
+        }
+
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Size_;
+        }
+
+        [[nodiscard]]
+        std::size_t Capacity() const noexcept {
+            return Capacity_;
+        }
+
+        [[nodiscard]]
+        BookPoolFootprint Footprint() const noexcept {
+            return {
+                .BookSize = sizeof(TBook),
+                .Stride = Stride,
+                .Capacity = Capacity_,
+                .Size = Size_,
+                .RegionSize = Region_.Size(),
+                .Pages = Region_.Kind(),
+                .NumaNode = NumaNode_,
+            };
+        }
+
+    private:
+        [[nodiscard]]
+        std::byte* Address(std::size_t index) const noexcept {
+            return static_cast<std::byte*>(Region_.Data()) + index * Stride;
+        }
+    };
+
+}
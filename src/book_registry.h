@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/thread_affinity.h"
+
+namespace OrderBook {
+
+    // Dense identifier of a symbol, assigned in the order of registration.
+    using SymbolId = std::uint32_t;
+
+    // Spreads symbols over shards evenly in the order of registration.
+    struct RoundRobinSharding {
+        std::size_t operator()(SymbolId id, std::size_t shardsCount) const noexcept {
+            return id % shardsCount;
+        }
+    };
+
+    /*
+     * Owns the books of many symbols and splits them between shards, each shard being served by a single thread
+     * pinned to its own core.
+     *
+     * Symbols are interned once at subscription time, after that everything is addressed by a dense SymbolId,
+     * which is an index in the vector of books, so a lookup on the hot path is a single indexed load.
+     *
+     * A book is only ever updated by the thread of the shard owning it, so books are not synchronized at all,
+     * the same as a single BinanceBook. Symbols must be registered before shards are started,
+     * the registry itself is not modified while Run is in progress.
+    */
+    template <typename TBook, typename TShardingPolicy = RoundRobinSharding>
+    class BookRegistry {
+        struct TransparentHash {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view symbol) const noexcept {
+                return std::hash<std::string_view>()(symbol);
+            }
+        };
+
+    public:
+        /*
+         * A view of the registry available to the thread serving the shard.
+         * Gives access only to the books owned by the shard.
+        */
+        class Shard {
+            friend class BookRegistry;
+
+            BookRegistry* Registry_;
+            std::size_t Index_;
+            std::vector<SymbolId> Symbols_;
+
+            Shard(BookRegistry* registry, std::size_t index) : Registry_(registry), Index_(index) {
+            }
+
+        public:
+            [[nodiscard]]
+            std::size_t Index() const noexcept {
+                return Index_;
+            }
+
+            // Symbols owned by the shard.
+            [[nodiscard]]
+            std::span<const SymbolId> Symbols() const noexcept {
+                return Symbols_;
+            }
+
+            [[nodiscard]]
+            bool Owns(SymbolId id) const noexcept {
+                return Registry_->ShardOf(id) == Index_;
+            }
+
+            [[nodiscard]]
+            TBook& Book(SymbolId id) noexcept {
+                assert(Owns(id));
+                return Registry_->Book(id);
+            }
+        };
+
+    private:
+        std::unordered_map<std::string, SymbolId, TransparentHash, std::equal_to<>> Ids_;
+        std::vector<std::string> Symbols_;            // SymbolId -> symbol
+        std::vector<std::unique_ptr<TBook>> Books_;   // SymbolId -> book
+        std::vector<std::uint32_t> Owners_;           // SymbolId -> shard
+        std::vector<Shard> Shards_;
+        TShardingPolicy ShardingPolicy_;
+
+    public:
+        explicit BookRegistry(std::size_t shardsCount = 1, TShardingPolicy shardingPolicy = {})
+            : ShardingPolicy_(std::move(shardingPolicy)) {
+            assert(shardsCount > 0);
+
+            Shards_.reserve(shardsCount);
+            for (std::size_t index = 0; index < shardsCount; ++index) {
+                Shards_.push_back(Shard(this, index));
+            }
+        }
+
+        // Shards keep a pointer to the registry.
+        BookRegistry(const BookRegistry&) = delete;
+        BookRegistry& operator=(const BookRegistry&) = delete;
+
+        // Return the id of the symbol registering a new book for it if the symbol is seen for the first time.
+        SymbolId Intern(std::string_view symbol) {
+            if (auto it = Ids_.find(symbol); it != Ids_.end()) {
+                return it->second;
+            }
+
+            const auto id = static_cast<SymbolId>(Books_.size());
+            const auto shard = ShardingPolicy_(id, Shards_.size());
+            assert(shard < Shards_.size());
+
+            Ids_.emplace(symbol, id);
+            Symbols_.emplace_back(symbol);
+            Books_.push_back(std::make_unique<TBook>());
+            Owners_.push_back(static_cast<std::uint32_t>(shard));
+            Shards_[shard].Symbols_.push_back(id);
+
+            return id;
+        }
+
+        [[nodiscard]]
+        std::optional<SymbolId> Find(std::string_view symbol) const {
+            if (auto it = Ids_.find(symbol); it != Ids_.end()) {
+                return it->second;
+            }
+
+            return std::nullopt;
+        }
+
+        [[nodiscard]]
+        std::string_view Symbol(SymbolId id) const noexcept {
+            return Symbols_[id];
+        }
+
+        [[nodiscard]]
+        TBook& Book(SymbolId id) noexcept {
+            return *Books_[id];
+        }
+
+        [[nodiscard]]
+        const TBook& Book(SymbolId id) const noexcept {
+            return *Books_[id];
+        }
+
+        [[nodiscard]]
+        std::size_t ShardOf(SymbolId id) const noexcept {
+            return Owners_[id];
+        }
+
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Books_.size();
+        }
+
+        [[nodiscard]]
+        std::size_t ShardsCount() const noexcept {
+            return Shards_.size();
+        }
+
+        [[nodiscard]]
+        Shard& GetShard(std::size_t index) noexcept {
+            return Shards_[index];
+        }
+
+        /*
+         * Run `worker(shard)` for every shard on its own thread pinned to a core and wait until all of them return.
+         * Shard i is pinned to cores[i] if cores are given, otherwise to core i modulo the number of cores.
+        */
+        template <typename TWorker>
+        void Run(TWorker&& worker, std::span<const std::size_t> cores = {}) {
+            std::vector<std::jthread> threads;
+            threads.reserve(Shards_.size());
+
+            for (auto& shard : Shards_) {
+                const std::size_t core = shard.Index_ < cores.size() ? cores[shard.Index_]
+                                                                     : shard.Index_ % Utils::CoresCount();
+
+                threads.emplace_back([&worker, &shard, core]() {
+                    Utils::PinCurrentThread(core);
+                    worker(shard);
+                });
+            }
+        }
+    };
+
+}
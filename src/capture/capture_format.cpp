@@ -0,0 +1 @@
+#include "capture_format.h"
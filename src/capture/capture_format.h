@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../models/book_update.h"
+#include "../models/price_quantity.h"
+
+namespace OrderBook::Capture {
+
+    /*
+     * Binary log of book updates, written by CaptureWriter and replayed by CaptureReader.
+     *
+     * The file starts with a FileHeader followed by records one after another. Every record is a fixed-width
+     * RecordHeader followed by BidsCount bid levels and AsksCount ask levels stored as PriceQuantity arrays
+     * exactly as they are laid out in memory, so a mapped file can be read without any decoding.
+     * A BBO update is stored as a single bid and a single ask level.
+     *
+     * Values are stored in the byte order of the writing host, the header records the sizes of the types
+     * to reject logs written with a different price/quantity representation.
+    */
+
+    inline constexpr std::uint32_t Magic = 0x50414342; // "BCAP"
+    inline constexpr std::uint16_t Version = 1;
+
+    // All records start at this alignment, so levels can be accessed in place.
+    inline constexpr std::size_t RecordAlignment = 8;
+
+    struct FileHeader {
+        std::uint32_t Magic{};
+        std::uint16_t Version{};
+        std::uint8_t PriceSize{};
+        std::uint8_t QuantitySize{};
+    };
+
+    struct RecordHeader {
+        std::uint64_t Timestamp{}; // receive time in the clock chosen by the producer
+        std::uint32_t SymbolId{};
+        std::uint16_t BidsCount{};
+        std::uint16_t AsksCount{};
+        Models::UpdateType Type{};
+        std::uint8_t Reserved[7]{}; // explicit padding, so no uninitialized bytes are written
+    };
+
+    static_assert(sizeof(FileHeader) % RecordAlignment == 0);
+    static_assert(sizeof(RecordHeader) == 24);
+    static_assert(std::is_trivially_copyable_v<RecordHeader>);
+
+    template <typename TPrice, typename TQuantity>
+    constexpr FileHeader MakeFileHeader() noexcept {
+        return {
+            .Magic = Magic,
+            .Version = Version,
+            .PriceSize = sizeof(TPrice),
+            .QuantitySize = sizeof(TQuantity),
+        };
+    }
+
+    // Size of the levels of a record rounded up to the record alignment.
+    template <typename TPrice, typename TQuantity>
+    constexpr std::size_t LevelsSize(std::size_t count) noexcept {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        static_assert(std::is_trivially_copyable_v<TPriceQuantity>, "levels are stored as raw bytes");
+        static_assert(RecordAlignment % alignof(TPriceQuantity) == 0, "levels must be aligned in the mapped file");
+
+        return (count * sizeof(TPriceQuantity) + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+    }
+
+}
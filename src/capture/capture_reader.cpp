@@ -0,0 +1 @@
+#include "capture_reader.h"
@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "capture_format.h"
+#include "../models/book_ticker.h"
+#include "../models/book_update.h"
+#include "../models/price_quantity.h"
+
+namespace OrderBook::Capture {
+
+    // A single record of the capture, the levels point directly into the mapped file.
+    template <typename TPrice, typename TQuantity>
+    struct CaptureRecord {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        std::uint64_t Timestamp{};
+        std::uint32_t SymbolId{};
+        Models::UpdateType Type{};
+        std::span<const TPriceQuantity> Bids;
+        std::span<const TPriceQuantity> Asks;
+
+        // Book ticker of a BBO record, CaptureReader yields BBO records only with one level per side.
+        [[nodiscard]]
+        Models::BookTicker<TPrice, TQuantity> Ticker() const noexcept {
+            assert(Type == Models::UpdateType::BBO && Bids.size() == 1 && Asks.size() == 1);
+
+            return {
+                .BestBidPrice = Bids.front().Price,
+                .BestBidQty = Bids.front().Quantity,
+                .BestAskPrice = Asks.front().Price,
+                .BestAskQty = Asks.front().Quantity,
+            };
+        }
+    };
+
+    /*
+     * Maps a capture file (see capture_format.h) into memory and iterates over its records without copying:
+     * the levels of every record are spans over the mapping, so they can be fed straight into
+     * BinanceBook::DepthUpdate. The reader must outlive the records taken from it.
+     *
+     * Throws std::system_error if the file can't be mapped and std::runtime_error if it is not a capture
+     * of the given price/quantity types. A truncated record at the end of the file (e.g. the writer was killed)
+     * terminates the range, the records before it remain valid. So does a damaged record: one of an unknown type
+     * or a BBO record without exactly one level per side, the sizes of the records after it can't be trusted.
+    */
+    template <typename TPrice, typename TQuantity>
+    class CaptureReader {
+        using TRecord = CaptureRecord<TPrice, TQuantity>;
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        struct Sentinel {};
+
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = TRecord;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const TRecord*;
+            using reference = const TRecord&;
+
+        private:
+            const std::byte* Position_ = nullptr; // nullptr marks the end of the range
+            const std::byte* End_ = nullptr;
+            TRecord Current_;
+
+        public:
+            Iterator() = default;
+
+            Iterator(const std::byte* position, const std::byte* end) : Position_(position), End_(end) {
+                ReadNext();
+            }
+
+            reference operator*() const {
+                return Current_;
+            }
+
+            pointer operator->() const {
+                return &Current_;
+            }
+
+            Iterator& operator++() {
+                ReadNext();
+                return *this;
+            }
+
+            void operator++(int) {
+                (void)operator++();
+            }
+
+            bool operator==(Sentinel) const {
+                return Position_ == nullptr;
+            }
+
+        private:
+            void ReadNext() {
+                if (static_cast<std::size_t>(End_ - Position_) < sizeof(RecordHeader)) {
+                    Position_ = nullptr;
+                    return;
+                }
+
+                RecordHeader header;
+                std::memcpy(&header, Position_, sizeof(header));
+
+                if (!IsValid(header)) [[unlikely]] {
+                    Position_ = nullptr;
+                    return;
+                }
+
+                const std::byte* const levels = Position_ + sizeof(header);
+                const std::size_t levelsSize = LevelsSize<TPrice, TQuantity>(header.BidsCount + header.AsksCount);
+                if (static_cast<std::size_t>(End_ - levels) < levelsSize) [[unlikely]] {
+                    Position_ = nullptr;
+                    return;
+                }
+
+                const auto* bids = reinterpret_cast<const TPriceQuantity*>(levels);
+
+                Current_ = {
+                    .Timestamp = header.Timestamp,
+                    .SymbolId = header.SymbolId,
+                    .Type = header.Type,
+                    .Bids = {bids, header.BidsCount},
+                    .Asks = {bids + header.BidsCount, header.AsksCount},
+                };
+                Position_ = levels + levelsSize;
+            }
+
+            static bool IsValid(const RecordHeader& header) noexcept {
+                switch (header.Type) {
+                    case Models::UpdateType::Depth:
+                        return true;
+                    case Models::UpdateType::BBO:
+                        return header.BidsCount == 1 && header.AsksCount == 1;
+                }
+
+                return false;
+            }
+        };
+
+        const std::byte* Data_ = nullptr;
+        std::size_t Size_ = 0;
+
+    public:
+        explicit CaptureReader(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to open capture file " + path);
+            }
+
+            struct stat status{};
+            if (::fstat(fd, &status) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Failed to stat capture file " + path);
+            }
+
+            Size_ = static_cast<std::size_t>(status.st_size);
+            if (Size_ < sizeof(FileHeader)) {
+                ::close(fd);
+                throw std::runtime_error("Not a capture file " + path);
+            }
+
+            void* data = ::mmap(nullptr, Size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            const int error = errno;
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                throw std::system_error(error, std::generic_category(), "Failed to map capture file " + path);
+            }
+
+            ::madvise(data, Size_, MADV_SEQUENTIAL);
+            Data_ = static_cast<const std::byte*>(data);
+
+            FileHeader header;
+            std::memcpy(&header, Data_, sizeof(header));
+
+            const auto expected = MakeFileHeader<TPrice, TQuantity>();
+            if (header.Magic != expected.Magic || header.Version != expected.Version
+                || header.PriceSize != expected.PriceSize || header.QuantitySize != expected.QuantitySize) {
+                Unmap();
+                throw std::runtime_error("Unsupported capture file " + path);
+            }
+        }
+
+        CaptureReader(CaptureReader&& rhs) noexcept
+            : Data_(std::exchange(rhs.Data_, nullptr)), Size_(std::exchange(rhs.Size_, 0)) {
+        }
+
+        CaptureReader& operator=(CaptureReader&& rhs) noexcept {
+            if (this != &rhs) {
+                Unmap();
+                Data_ = std::exchange(rhs.Data_, nullptr);
+                Size_ = std::exchange(rhs.Size_, 0);
+            }
+
+            return *this;
+        }
+
+        ~CaptureReader() {
+            Unmap();
+        }
+
+        [[nodiscard]]
+        Iterator begin() const {
+            return Data_ != nullptr ? Iterator(Data_ + sizeof(FileHeader), Data_ + Size_) : Iterator();
+        }
+
+        [[nodiscard]]
+        Sentinel end() const {
+            return {};
+        }
+
+        // Size of the mapped file in bytes.
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Size_;
+        }
+
+    private:
+        void Unmap() noexcept {
+            if (Data_ != nullptr) {
+                ::munmap(const_cast<std::byte*>(Data_), Size_);
+                Data_ = nullptr;
+            }
+        }
+    };
+
+    // Apply a single captured update to the book.
+    template <typename TBook, typename TPrice, typename TQuantity>
+    void ApplyRecord(TBook& book, const CaptureRecord<TPrice, TQuantity>& record) {
+        switch (record.Type) {
+            case Models::UpdateType::Depth:
+                book.DepthUpdate(record.Bids, record.Asks);
+                break;
+            case Models::UpdateType::BBO:
+                book.BBOUpdate(record.Ticker());
+                break;
+        }
+    }
+
+}
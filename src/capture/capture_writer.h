@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <ios>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "capture_format.h"
+#include "../models/book_ticker.h"
+#include "../models/book_update.h"
+#include "../models/price_quantity.h"
+
+namespace OrderBook::Capture {
+
+    /*
+     * Appends book updates to a capture file (see capture_format.h).
+     * Depth levels may come from any input range, including lazy parser views, they are collected into
+     * a reusable buffer first, since the counts have to be written before the levels.
+     *
+     * The writer throws std::runtime_error if the file can't be created or written.
+    */
+    template <typename TPrice, typename TQuantity>
+    class CaptureWriter {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        std::ofstream Out_;
+        std::vector<TPriceQuantity> Levels_; // bids followed by asks of the record being written
+        std::uint64_t RecordsCount_ = 0;
+
+    public:
+        explicit CaptureWriter(const std::string& path) : Out_(path, std::ios::binary | std::ios::trunc) {
+            if (!Out_) {
+                throw std::runtime_error("Failed to create capture file " + path);
+            }
+
+            const auto header = MakeFileHeader<TPrice, TQuantity>();
+            WriteBytes(&header, sizeof(header));
+        }
+
+        void WriteDepth(std::uint64_t timestamp, std::uint32_t symbolId, auto&& bids, auto&& asks) {
+            Levels_.clear();
+            const auto bidsCount = AppendLevels(bids);
+            const auto asksCount = AppendLevels(asks);
+
+            WriteRecord({
+                .Timestamp = timestamp,
+                .SymbolId = symbolId,
+                .BidsCount = bidsCount,
+                .AsksCount = asksCount,
+                .Type = Models::UpdateType::Depth,
+            });
+        }
+
+        void WriteBBO(std::uint64_t timestamp, std::uint32_t symbolId, Models::BookTicker<TPrice, TQuantity> ticker) {
+            Levels_.clear();
+            Levels_.push_back({.Price = ticker.BestBidPrice, .Quantity = ticker.BestBidQty});
+            Levels_.push_back({.Price = ticker.BestAskPrice, .Quantity = ticker.BestAskQty});
+
+            WriteRecord({
+                .Timestamp = timestamp,
+                .SymbolId = symbolId,
+                .BidsCount = 1,
+                .AsksCount = 1,
+                .Type = Models::UpdateType::BBO,
+            });
+        }
+
+        // Record an update taken from the update queue.
+        template <std::size_t PriceLevels>
+        void Write(const Models::BookUpdate<TPrice, TQuantity, PriceLevels>& update) {
+            switch (update.Type) {
+                case Models::UpdateType::Depth:
+                    WriteDepth(update.Timestamp, update.SymbolId, update.GetBids(), update.GetAsks());
+                    break;
+                case Models::UpdateType::BBO:
+                    WriteBBO(update.Timestamp, update.SymbolId, update.Ticker);
+                    break;
+            }
+        }
+
+        void Flush() {
+            Out_.flush();
+            if (!Out_) {
+                throw std::runtime_error("Failed to write capture file");
+            }
+        }
+
+        [[nodiscard]]
+        std::uint64_t RecordsCount() const noexcept {
+            return RecordsCount_;
+        }
+
+    private:
+        std::uint16_t AppendLevels(auto&& levels) {
+            std::uint16_t count = 0;
+
+            for (auto&& level : levels) {
+                if (count == UINT16_MAX) [[unlikely]] {
+                    throw std::runtime_error("Too many levels in a single capture record");
+                }
+
+                Levels_.push_back(level);
+                ++count;
+            }
+
+            return count;
+        }
+
+        void WriteRecord(const RecordHeader& header) {
+            static constexpr char Zeros[RecordAlignment] = {};
+
+            const std::size_t levelsBytes = Levels_.size() * sizeof(TPriceQuantity);
+            const std::size_t paddedBytes = LevelsSize<TPrice, TQuantity>(Levels_.size());
+
+            WriteBytes(&header, sizeof(header));
+            WriteBytes(Levels_.data(), levelsBytes);
+            WriteBytes(Zeros, paddedBytes - levelsBytes);
+
+            ++RecordsCount_;
+        }
+
+        void WriteBytes(const void* data, std::size_t size) {
+            Out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            if (!Out_) [[unlikely]] {
+                throw std::runtime_error("Failed to write capture file");
+            }
+        }
+    };
+
+}
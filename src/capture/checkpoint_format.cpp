@@ -0,0 +1 @@
+#include "checkpoint_format.h"
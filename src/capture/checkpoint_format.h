@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../utils/checksum.h"
+
+namespace OrderBook::Capture {
+
+    /*
+     * Checkpoint of the state of many books, written by CheckpointWriter and restored by CheckpointReader.
+     *
+     * The file starts with a CheckpointHeader followed by one fixed-size record per book slot, so a record
+     * is found by its index. A record is a CheckpointRecordHeader followed by the BookState of the book
+     * (see BinanceBook::SaveState) exactly as it is laid out in memory, so a book is restored straight
+     * from the mapped file.
+     *
+     * Every record has its own checksum of the symbol, the time and the state: a record torn by a crash
+     * in the middle of a save or damaged on disk is detected and only that book is lost. A record which
+     * was never saved has a zero checksum.
+     *
+     * Values are stored in the byte order of the writing host, the header records the sizes of the types
+     * and the number of levels of a side to reject checkpoints of differently configured books.
+    */
+
+    inline constexpr std::uint32_t CheckpointMagic = 0x504b4342; // "BCKP"
+    inline constexpr std::uint16_t CheckpointVersion = 1;
+
+    // Maximum length of a symbol stored in a record.
+    inline constexpr std::size_t CheckpointSymbolSize = 32;
+
+    // Records start at this alignment, so the states can be accessed in place.
+    inline constexpr std::size_t CheckpointRecordAlignment = 64;
+
+    struct CheckpointHeader {
+        std::uint32_t Magic{};
+        std::uint16_t Version{};
+        std::uint8_t PriceSize{};
+        std::uint8_t QuantitySize{};
+        std::uint32_t LevelsPerSide{};
+        std::uint32_t BooksCount{};  // number of record slots
+        std::uint64_t RecordSize{};  // distance between records, including the padding
+        std::uint64_t Generation{};  // number of commits, 0 if the checkpoint was never committed
+        std::uint64_t Timestamp{};   // of the last commit in the clock chosen by the writer
+        std::uint64_t Checksum{};    // of the fields above
+    };
+
+    struct CheckpointRecordHeader {
+        char Symbol[CheckpointSymbolSize]{}; // not terminated if it takes the whole array
+        std::uint64_t Timestamp{};           // when the book was saved
+        std::uint64_t Checksum{};            // of the symbol, the time and the state, 0 if never saved
+    };
+
+    static_assert(std::is_trivially_copyable_v<CheckpointHeader>);
+    static_assert(std::is_trivially_copyable_v<CheckpointRecordHeader>);
+
+    // Records follow the header at the record alignment.
+    inline constexpr std::size_t CheckpointRecordsOffset =
+        (sizeof(CheckpointHeader) + CheckpointRecordAlignment - 1) / CheckpointRecordAlignment * CheckpointRecordAlignment;
+
+    template <typename TState>
+    constexpr std::size_t CheckpointRecordSize() noexcept {
+        static_assert(std::is_trivially_copyable_v<TState>, "states are stored as raw bytes");
+        static_assert(sizeof(CheckpointRecordHeader) % alignof(TState) == 0, "states must be aligned in the mapped file");
+
+        return (sizeof(CheckpointRecordHeader) + sizeof(TState) + CheckpointRecordAlignment - 1)
+               / CheckpointRecordAlignment * CheckpointRecordAlignment;
+    }
+
+    template <typename TState>
+    constexpr CheckpointHeader MakeCheckpointHeader(std::uint32_t booksCount) noexcept {
+        return {
+            .Magic = CheckpointMagic,
+            .Version = CheckpointVersion,
+            .PriceSize = sizeof(decltype(TState::TPriceQuantity::Price)),
+            .QuantitySize = sizeof(decltype(TState::TPriceQuantity::Quantity)),
+            .LevelsPerSide = static_cast<std::uint32_t>(std::tuple_size_v<decltype(TState::Bids)>),
+            .BooksCount = booksCount,
+            .RecordSize = CheckpointRecordSize<TState>(),
+        };
+    }
+
+    inline std::uint64_t HeaderChecksum(const CheckpointHeader& header) noexcept {
+        return Utils::Fnv1aWords(&header, offsetof(CheckpointHeader, Checksum));
+    }
+
+    // Checksum of a record, never 0 so it can't be confused with a record which was never saved.
+    template <typename TState>
+    std::uint64_t RecordChecksum(const CheckpointRecordHeader& header, const TState& state) noexcept {
+        std::uint64_t hash = Utils::Fnv1aWords(&header, offsetof(CheckpointRecordHeader, Checksum));
+        hash = Utils::Fnv1aWords(&state, sizeof(state), hash);
+
+        return hash != 0 ? hash : 1;
+    }
+
+}
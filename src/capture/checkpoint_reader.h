@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint_format.h"
+
+namespace OrderBook::Capture {
+
+    enum class RestoreStatus : std::uint8_t {
+        Restored,
+        Empty,     // the record was never saved, the book is left as it is
+        Corrupted, // the checksum doesn't match, the book is left as it is
+    };
+
+    // Outcome of CheckpointReader::RestoreAll.
+    struct RestoreCounts {
+        std::size_t Restored{};
+        std::size_t Empty{};
+        std::size_t Corrupted{};
+    };
+
+    /*
+     * Maps a checkpoint file (see checkpoint_format.h) and restores books from it. The states are read
+     * straight from the mapping and every record is checked against its checksum before it is applied.
+     *
+     * Throws std::system_error if the file can't be mapped and std::runtime_error if it is not a checkpoint
+     * of books of the same type or the header is damaged.
+    */
+    template <typename TBook>
+    class CheckpointReader {
+        using TState = typename TBook::TState;
+
+        static constexpr std::size_t RecordSize = CheckpointRecordSize<TState>();
+
+        const std::byte* Data_ = nullptr;
+        std::size_t Size_ = 0;
+        CheckpointHeader Header_;
+
+    public:
+        explicit CheckpointReader(const std::string& path) {
+            const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to open checkpoint file " + path);
+            }
+
+            struct stat status{};
+            if (::fstat(fd, &status) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Failed to stat checkpoint file " + path);
+            }
+
+            Size_ = static_cast<std::size_t>(status.st_size);
+            if (Size_ < CheckpointRecordsOffset) {
+                ::close(fd);
+                throw std::runtime_error("Not a checkpoint file " + path);
+            }
+
+            void* data = ::mmap(nullptr, Size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            const int error = errno;
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                throw std::system_error(error, std::generic_category(), "Failed to map checkpoint file " + path);
+            }
+
+            Data_ = static_cast<const std::byte*>(data);
+            std::memcpy(&Header_, Data_, sizeof(Header_));
+
+            auto expected = MakeCheckpointHeader<TState>(Header_.BooksCount);
+            if (Header_.Magic != expected.Magic || Header_.Version != expected.Version
+                || Header_.PriceSize != expected.PriceSize || Header_.QuantitySize != expected.QuantitySize
+                || Header_.LevelsPerSide != expected.LevelsPerSide || Header_.RecordSize != expected.RecordSize) {
+                Unmap();
+                throw std::runtime_error("Unsupported checkpoint file " + path);
+            }
+
+            if (Header_.Checksum != HeaderChecksum(Header_)
+                || Size_ < CheckpointRecordsOffset + Header_.BooksCount * RecordSize) {
+                Unmap();
+                throw std::runtime_error("Damaged checkpoint file " + path);
+            }
+        }
+
+        CheckpointReader(CheckpointReader&& rhs) noexcept
+            : Data_(std::exchange(rhs.Data_, nullptr)), Size_(std::exchange(rhs.Size_, 0)), Header_(rhs.Header_) {
+        }
+
+        CheckpointReader& operator=(CheckpointReader&& rhs) noexcept {
+            if (this != &rhs) {
+                Unmap();
+                Data_ = std::exchange(rhs.Data_, nullptr);
+                Size_ = std::exchange(rhs.Size_, 0);
+                Header_ = rhs.Header_;
+            }
+
+            return *this;
+        }
+
+        ~CheckpointReader() {
+            Unmap();
+        }
+
+        // Number of record slots, including the ones which were never saved.
+        [[nodiscard]]
+        std::size_t BooksCount() const noexcept {
+            return Header_.BooksCount;
+        }
+
+        // Number of commits made by the writer, 0 if it never committed.
+        [[nodiscard]]
+        std::uint64_t Generation() const noexcept {
+            return Header_.Generation;
+        }
+
+        // Time of the last commit.
+        [[nodiscard]]
+        std::uint64_t Timestamp() const noexcept {
+            return Header_.Timestamp;
+        }
+
+        // Symbol of the record, empty if the record was never saved. Check the status of Restore before trusting it.
+        [[nodiscard]]
+        std::string_view Symbol(std::size_t index) const noexcept {
+            const auto& header = RecordHeader(index);
+            return {header.Symbol, strnlen(header.Symbol, CheckpointSymbolSize)};
+        }
+
+        // Time when the book of the record was saved.
+        [[nodiscard]]
+        std::uint64_t SaveTimestamp(std::size_t index) const noexcept {
+            return RecordHeader(index).Timestamp;
+        }
+
+        // Check the record and restore the book from it if the record is valid.
+        RestoreStatus Restore(std::size_t index, TBook& book) const noexcept {
+            const auto& header = RecordHeader(index);
+            if (header.Checksum == 0) {
+                return RestoreStatus::Empty;
+            }
+
+            const auto& state = State(index);
+            if (header.Checksum != RecordChecksum(header, state) || !IsValid(state)) [[unlikely]] {
+                return RestoreStatus::Corrupted;
+            }
+
+            book.RestoreState(state);
+            return RestoreStatus::Restored;
+        }
+
+        // Restore every saved book, `bookOf(index, symbol)` returns the book of the record.
+        template <typename TBookOf>
+        RestoreCounts RestoreAll(TBookOf&& bookOf) const {
+            RestoreCounts counts;
+
+            for (std::size_t index = 0; index < BooksCount(); ++index) {
+                const auto& header = RecordHeader(index);
+                if (header.Checksum == 0) {
+                    ++counts.Empty;
+                    continue;
+                }
+
+                switch (Restore(index, bookOf(index, Symbol(index)))) {
+                    case RestoreStatus::Restored:
+                        ++counts.Restored;
+                        break;
+                    case RestoreStatus::Empty:
+                        ++counts.Empty;
+                        break;
+                    case RestoreStatus::Corrupted:
+                        ++counts.Corrupted;
+                        break;
+                }
+            }
+
+            return counts;
+        }
+
+    private:
+        const std::byte* Record(std::size_t index) const noexcept {
+            assert(index < BooksCount());
+            return Data_ + CheckpointRecordsOffset + index * RecordSize;
+        }
+
+        const CheckpointRecordHeader& RecordHeader(std::size_t index) const noexcept {
+            return *reinterpret_cast<const CheckpointRecordHeader*>(Record(index));
+        }
+
+        const TState& State(std::size_t index) const noexcept {
+            return *reinterpret_cast<const TState*>(Record(index) + sizeof(CheckpointRecordHeader));
+        }
+
+        // A state with a matching checksum may still come from a writer with a bug, never restore out of bounds.
+        static bool IsValid(const TState& state) noexcept {
+            return state.BidsCount <= state.Bids.size() && state.AsksCount <= state.Asks.size();
+        }
+
+        void Unmap() noexcept {
+            if (Data_ != nullptr) {
+                ::munmap(const_cast<std::byte*>(Data_), Size_);
+                Data_ = nullptr;
+            }
+        }
+    };
+
+}
@@ -0,0 +1 @@
+#include "checkpoint_writer.h"
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "checkpoint_format.h"
+
+namespace OrderBook::Capture {
+
+    /*
+     * Writes the state of books into a checkpoint file (see checkpoint_format.h).
+     *
+     * Saving a book copies its state straight into its record in a mapped working file (<path>.tmp),
+     * well under a microsecond for a book of 20 levels, so the thread owning the books can checkpoint them
+     * a few at a time between updates instead of stopping to write all of them. Threads of different shards
+     * may save their own books concurrently, records don't share anything.
+     *
+     * Commit, called by one thread while nobody saves, marks a new generation, waits until the working file
+     * is on disk and renames it over <path>. The file at <path> is never modified in place, so a crash at
+     * any moment leaves the last committed generation intact, and saves become visible to readers only
+     * after a commit. The working file then continues from a copy of the committed one.
+     *
+     * An existing checkpoint of books of the same type and count at <path> is continued: its records are
+     * taken into the working file, so books which aren't saved again keep their last committed state.
+     * Restore from it before creating the writer. Other files at <path> are replaced by the first commit.
+     * Throws std::system_error if the files can't be created, mapped or renamed.
+    */
+    template <typename TBook>
+    class CheckpointWriter {
+        using TState = typename TBook::TState;
+
+        static constexpr std::size_t RecordSize = CheckpointRecordSize<TState>();
+
+        std::string Path_;
+        std::string WorkingPath_;
+        std::byte* Data_ = nullptr;
+        std::size_t Size_ = 0;
+        std::size_t BooksCount_ = 0;
+
+    public:
+        // Start a checkpoint of `booksCount` records, books are saved by their index, e.g. SymbolId.
+        CheckpointWriter(const std::string& path, std::size_t booksCount)
+            : Path_(path), WorkingPath_(path + ".tmp"), Size_(CheckpointRecordsOffset + booksCount * RecordSize),
+              BooksCount_(booksCount) {
+            Data_ = CreateWorkingFile();
+
+            if (!ContinueCommitted()) {
+                WriteHeader(0, 0);
+            }
+        }
+
+        CheckpointWriter(CheckpointWriter&& rhs) noexcept
+            : Path_(std::move(rhs.Path_)), WorkingPath_(std::move(rhs.WorkingPath_)), Data_(std::exchange(rhs.Data_, nullptr)),
+              Size_(std::exchange(rhs.Size_, 0)), BooksCount_(std::exchange(rhs.BooksCount_, 0)) {
+        }
+
+        CheckpointWriter& operator=(CheckpointWriter&& rhs) noexcept {
+            if (this != &rhs) {
+                Discard();
+                Path_ = std::move(rhs.Path_);
+                WorkingPath_ = std::move(rhs.WorkingPath_);
+                Data_ = std::exchange(rhs.Data_, nullptr);
+                Size_ = std::exchange(rhs.Size_, 0);
+                BooksCount_ = std::exchange(rhs.BooksCount_, 0);
+            }
+
+            return *this;
+        }
+
+        // Saves made after the last commit are discarded.
+        ~CheckpointWriter() {
+            Discard();
+        }
+
+        /*
+         * Save the state of the book into the record `index`, replacing the previous one.
+         * Throws std::length_error if the symbol doesn't fit into the record.
+        */
+        void Save(std::size_t index, std::string_view symbol, const TBook& book, std::uint64_t timestamp = 0) {
+            assert(index < BooksCount_);
+
+            if (symbol.size() > CheckpointSymbolSize) [[unlikely]] {
+                throw std::length_error("Symbol is too long for a checkpoint: " + std::string(symbol));
+            }
+
+            auto* record = Data_ + CheckpointRecordsOffset + index * RecordSize;
+            auto* header = reinterpret_cast<CheckpointRecordHeader*>(record);
+            auto* state = reinterpret_cast<TState*>(record + sizeof(CheckpointRecordHeader));
+
+            std::memset(header->Symbol, 0, sizeof(header->Symbol));
+            std::memcpy(header->Symbol, symbol.data(), symbol.size());
+            header->Timestamp = timestamp;
+            book.SaveState(*state);
+            header->Checksum = RecordChecksum(*header, *state);
+        }
+
+        /*
+         * Complete a generation: write the working file to disk and atomically replace the checkpoint with it.
+         * Takes as long as writing the whole file, commit every few seconds rather than after every save.
+        */
+        void Commit(std::uint64_t timestamp = 0) {
+            WriteHeader(Generation() + 1, timestamp);
+
+            if (::msync(Data_, Size_, MS_SYNC) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to write checkpoint file " + WorkingPath_);
+            }
+
+            if (::rename(WorkingPath_.c_str(), Path_.c_str()) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to replace checkpoint file " + Path_);
+            }
+            SyncDirectory();
+
+            // The committed mapping now belongs to <path>, the next generation starts from its copy.
+            std::byte* committed = std::exchange(Data_, nullptr);
+            try {
+                Data_ = CreateWorkingFile();
+            } catch (...) {
+                ::munmap(committed, Size_);
+                throw;
+            }
+
+            std::memcpy(Data_, committed, Size_);
+            ::munmap(committed, Size_);
+        }
+
+        // Number of the last committed generation, 0 if nothing was committed yet.
+        [[nodiscard]]
+        std::uint64_t Generation() const noexcept {
+            CheckpointHeader header;
+            std::memcpy(&header, Data_, sizeof(header));
+            return header.Generation;
+        }
+
+        [[nodiscard]]
+        std::size_t BooksCount() const noexcept {
+            return BooksCount_;
+        }
+
+        // Size of the file in bytes.
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Size_;
+        }
+
+    private:
+        std::byte* CreateWorkingFile() const {
+            const int fd = ::open(WorkingPath_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to create checkpoint file " + WorkingPath_);
+            }
+
+            if (::ftruncate(fd, static_cast<off_t>(Size_)) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Failed to resize checkpoint file " + WorkingPath_);
+            }
+
+            void* data = ::mmap(nullptr, Size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            const int error = errno;
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                throw std::system_error(error, std::generic_category(), "Failed to map checkpoint file " + WorkingPath_);
+            }
+
+            return static_cast<std::byte*>(data);
+        }
+
+        // Copy the committed checkpoint into the working file if it is a checkpoint of the same books.
+        bool ContinueCommitted() noexcept {
+            const int fd = ::open(Path_.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+
+            const bool continued = ::pread(fd, Data_, Size_, 0) == static_cast<ssize_t>(Size_) && IsCompatible();
+            ::close(fd);
+
+            if (!continued) {
+                std::memset(Data_, 0, Size_);
+            }
+
+            return continued;
+        }
+
+        bool IsCompatible() const noexcept {
+            CheckpointHeader header;
+            std::memcpy(&header, Data_, sizeof(header));
+
+            const auto expected = MakeCheckpointHeader<TState>(static_cast<std::uint32_t>(BooksCount_));
+            return header.Magic == expected.Magic && header.Version == expected.Version
+                   && header.PriceSize == expected.PriceSize && header.QuantitySize == expected.QuantitySize
+                   && header.LevelsPerSide == expected.LevelsPerSide && header.BooksCount == expected.BooksCount
+                   && header.RecordSize == expected.RecordSize && header.Checksum == HeaderChecksum(header);
+        }
+
+        // Make the rename durable.
+        void SyncDirectory() const {
+            const auto separator = Path_.rfind('/');
+            const std::string directory = separator == std::string::npos ? "." : separator == 0 ? "/" : Path_.substr(0, separator);
+
+            const int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+            if (fd < 0 || ::fsync(fd) != 0) {
+                const int error = errno;
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                throw std::system_error(error, std::generic_category(), "Failed to sync checkpoint directory " + directory);
+            }
+
+            ::close(fd);
+        }
+
+        void WriteHeader(std::uint64_t generation, std::uint64_t timestamp) noexcept {
+            auto header = MakeCheckpointHeader<TState>(static_cast<std::uint32_t>(BooksCount_));
+            header.Generation = generation;
+            header.Timestamp = timestamp;
+            header.Checksum = HeaderChecksum(header);
+
+            std::memcpy(Data_, &header, sizeof(header));
+        }
+
+        void Discard() noexcept {
+            if (Data_ != nullptr) {
+                ::munmap(Data_, Size_);
+                ::unlink(WorkingPath_.c_str());
+                Data_ = nullptr;
+            }
+        }
+    };
+
+}
@@ -0,0 +1 @@
+#include "conflating_queue.h"
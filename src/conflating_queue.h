@@ -0,0 +1,234 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+#include "book_registry.h"
+#include "models/book_ticker.h"
+#include "models/book_update.h"
+#include "utils/seq_lock.h"
+#include "utils/spsc_queue.h"
+
+namespace OrderBook {
+
+    // Counts of updates which went through ConflatingQueue.
+    struct ConflationCounters {
+        std::uint64_t DepthReceived{};
+        std::uint64_t BBOReceived{};
+        std::uint64_t DepthApplied{};
+        std::uint64_t BBOApplied{};
+        std::uint64_t DepthConflated{}; // replaced by a later depth update before being applied
+        std::uint64_t BBOConflated{};   // replaced by a later BBO or depth update before being applied
+
+        [[nodiscard]]
+        std::uint64_t Conflated() const noexcept {
+            return DepthConflated + BBOConflated;
+        }
+    };
+
+    /*
+     * An ingestion stage between the decoder thread (producer) and the thread owning the books (consumer),
+     * which conflates updates of a symbol while the consumer is behind.
+     *
+     * A partial depth update carries the whole top of the book and a BBO update the whole best bid/ask,
+     * so when several of them are pending only the latest depth update and the latest BBO after it matter.
+     * Every symbol has a slot with this net state, overwritten by the producer through a SeqLock,
+     * and a dirty flag. The first update after the consumer has taken the state puts the symbol id
+     * into the ready queue, later updates only overwrite the slot. The consumer applies the net state with
+     * Replace followed by BBOUpdate, so it does at most one Replace and one BBOUpdate per symbol whatever
+     * the length of the burst, and the lag of a book is bounded by one pass over the dirty symbols.
+     *
+     * The ready queue holds every dirty symbol at most once. The consumer clears the flag of a symbol when it
+     * applies it, while the ids of the batch being applied stay in the ring until the whole batch is consumed,
+     * so a symbol re-queued during the batch takes a second slot: the ring has room for every symbol twice
+     * and the producer never waits for the consumer.
+     * The queue is large (a slot per symbol), allocate it on the heap.
+    */
+    template <typename TPrice, typename TQuantity, std::size_t PriceLevels = 20, std::size_t MaxSymbols = 256>
+    class ConflatingQueue {
+        using TBookUpdate = Models::BookUpdate<TPrice, TQuantity, PriceLevels>;
+        using TBookTicker = Models::BookTicker<TPrice, TQuantity>;
+
+        // The net state of a symbol, written only by the producer.
+        struct PendingState {
+            std::uint64_t DepthSequence{}; // number of depth updates pushed so far
+            std::uint64_t BBOSequence{};   // number of BBO updates pushed so far
+            std::uint64_t Timestamp{};     // of the latest update
+            bool HasBBOAfterDepth{};       // the ticker arrived after the latest depth update
+            TBookTicker Ticker;
+            TBookUpdate Depth;
+        };
+
+        struct Slot {
+            Utils::SeqLock<PendingState> State;
+            std::atomic<bool> Dirty = false; // the symbol is in the ready queue
+        };
+
+        // Sequences of the state last applied by the consumer.
+        struct AppliedState {
+            std::uint64_t DepthSequence{};
+            std::uint64_t BBOSequence{};
+        };
+
+        // Counters are written by one thread each, without locked instructions, and can be read by any thread.
+        class Counter {
+            std::atomic<std::uint64_t> Value_ = 0;
+
+        public:
+            void Add(std::uint64_t value) noexcept {
+                Value_.store(Value_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+            }
+
+            [[nodiscard]]
+            std::uint64_t Load() const noexcept {
+                return Value_.load(std::memory_order_relaxed);
+            }
+        };
+
+        std::array<Slot, MaxSymbols> Slots_;
+        // Up to MaxSymbols ids of the batch being applied and MaxSymbols ids queued again, one slot is never used.
+        Utils::SpscQueue<SymbolId, std::bit_ceil(2 * MaxSymbols + 1)> Ready_;
+
+        // Consumer side.
+        std::array<AppliedState, MaxSymbols> Applied_{};
+        PendingState Scratch_;
+
+        alignas(64) Counter DepthReceived_;
+        Counter BBOReceived_;
+        alignas(64) Counter DepthApplied_;
+        Counter BBOApplied_;
+        Counter DepthConflated_;
+        Counter BBOConflated_;
+
+    public:
+        ConflatingQueue() = default;
+
+        ConflatingQueue(const ConflatingQueue&) = delete;
+        ConflatingQueue& operator=(const ConflatingQueue&) = delete;
+
+        // Producer side. Replace the pending depth of the symbol, the pending BBO is outdated by it.
+        void PushDepth(SymbolId id, auto&& bids, auto&& asks, std::uint64_t timestamp = 0) {
+            assert(id < MaxSymbols);
+
+            Slots_[id].State.Update([&](PendingState& state) {
+                state.Depth.SetDepth(bids, asks);
+                state.Timestamp = timestamp;
+                state.HasBBOAfterDepth = false;
+                ++state.DepthSequence;
+            });
+
+            DepthReceived_.Add(1);
+            MarkDirty(id);
+        }
+
+        // Producer side. Replace the pending BBO of the symbol.
+        void PushBBO(SymbolId id, TBookTicker ticker, std::uint64_t timestamp = 0) {
+            assert(id < MaxSymbols);
+
+            Slots_[id].State.Update([&](PendingState& state) {
+                state.Ticker = ticker;
+                state.Timestamp = timestamp;
+                state.HasBBOAfterDepth = true;
+                ++state.BBOSequence;
+            });
+
+            BBOReceived_.Add(1);
+            MarkDirty(id);
+        }
+
+        // Producer side. Push a decoded update, the symbol and the time are taken from it.
+        void Push(const TBookUpdate& update) {
+            switch (update.Type) {
+                case Models::UpdateType::Depth:
+                    PushDepth(update.SymbolId, update.GetBids(), update.GetAsks(), update.Timestamp);
+                    break;
+                case Models::UpdateType::BBO:
+                    PushBBO(update.SymbolId, update.Ticker, update.Timestamp);
+                    break;
+            }
+        }
+
+        /*
+         * Consumer side. Apply the net state of up to maxSymbols dirty symbols to their books,
+         * `bookOf(id)` returns the book of the symbol. `onApplied(id, timestamp)` is called after each symbol
+         * is applied with the time of the latest update included. Returns the number of applied symbols,
+         * 0 means nothing was pending.
+        */
+        template <typename TBookOf, typename TOnApplied>
+        std::size_t Drain(TBookOf&& bookOf, std::size_t maxSymbols, TOnApplied&& onApplied) {
+            return Ready_.ConsumeBatch([&](SymbolId id) {
+                Apply(id, bookOf(id));
+                onApplied(id, Scratch_.Timestamp);
+            }, maxSymbols);
+        }
+
+        template <typename TBookOf>
+        std::size_t Drain(TBookOf&& bookOf, std::size_t maxSymbols = MaxSymbols) {
+            return Drain(bookOf, maxSymbols, [](SymbolId, std::uint64_t) {});
+        }
+
+        // Counters of all symbols, can be read by any thread.
+        [[nodiscard]]
+        ConflationCounters Counters() const noexcept {
+            return {
+                .DepthReceived = DepthReceived_.Load(),
+                .BBOReceived = BBOReceived_.Load(),
+                .DepthApplied = DepthApplied_.Load(),
+                .BBOApplied = BBOApplied_.Load(),
+                .DepthConflated = DepthConflated_.Load(),
+                .BBOConflated = BBOConflated_.Load(),
+            };
+        }
+
+    private:
+        void MarkDirty(SymbolId id) {
+            // Pairs with the exchange of the consumer: either the consumer sees the new state after clearing
+            // the flag, or the producer sees the flag cleared and queues the symbol again.
+            if (!Slots_[id].Dirty.exchange(true, std::memory_order_acq_rel)) {
+                // The ring always has room (see Ready_), but dropping the id would leave the symbol dirty
+                // and never applied again, so rather wait for the consumer should it ever be full.
+                while (!Ready_.TryPush(id)) [[unlikely]] {
+                }
+            }
+        }
+
+        template <typename TBook>
+        void Apply(SymbolId id, TBook& book) {
+            auto& slot = Slots_[id];
+            auto& applied = Applied_[id];
+
+            (void)slot.Dirty.exchange(false, std::memory_order_acq_rel);
+            while (!slot.State.TryLoad(Scratch_)) {
+            }
+
+            const std::uint64_t depthCount = Scratch_.DepthSequence - applied.DepthSequence;
+            const std::uint64_t bboCount = Scratch_.BBOSequence - applied.BBOSequence;
+
+            if (depthCount != 0) {
+                book.Replace(Scratch_.Depth.GetBids(), Scratch_.Depth.GetAsks());
+                DepthApplied_.Add(1);
+                DepthConflated_.Add(depthCount - 1);
+            }
+
+            if (bboCount != 0) {
+                // BBO updates before the latest depth update are outdated by it.
+                const bool apply = Scratch_.HasBBOAfterDepth;
+                if (apply) {
+                    book.BBOUpdate(Scratch_.Ticker);
+                    BBOApplied_.Add(1);
+                }
+                BBOConflated_.Add(bboCount - apply);
+            }
+
+            applied = {
+                .DepthSequence = Scratch_.DepthSequence,
+                .BBOSequence = Scratch_.BBOSequence,
+            };
+        }
+    };
+
+}
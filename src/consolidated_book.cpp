@@ -0,0 +1 @@
+#include "consolidated_book.h"
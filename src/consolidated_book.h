@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "analytics.h"
+#include "models/book_ticker.h"
+#include "models/top_of_book.h"
+
+namespace OrderBook {
+
+    // Index of an underlying book of ConsolidatedBook, assigned in the order of subscription.
+    using VenueId = std::uint32_t;
+
+    // A price level of the consolidated book: the total quantity of all venues quoting the price.
+    // The quantities of every venue are available through ConsolidatedBook::Breakdown.
+    template <typename TPrice, typename TQuantity>
+    struct ConsolidatedLevel {
+        TPrice Price{};
+        TQuantity Quantity{};
+        std::uint32_t VenuesMask{}; // bit i is set if venue i quotes the price
+        std::uint32_t Slot{};       // index of the per-venue quantities
+    };
+
+    /*
+     * One book aggregating the same symbol from K underlying books (venues, spot and backup feeds),
+     * each level keeping the quantities of every venue.
+     *
+     * Every venue is represented by its top levels as of the last refresh (a TSnapshot copy of the book).
+     * When a venue changes, its new top levels are compared with the previous ones and only the levels which
+     * differ are applied to the consolidated sides, so the cost of an update depends on the number of changed
+     * levels of one venue rather than on the number of venues.
+     *
+     * A consolidated side keeps every level known from any venue, at most MaxVenues * PriceLevels of them.
+     * Levels under the worst known level of some venue may miss the quantity of that venue beyond its top,
+     * so only the top levels down to the shallowest venue are complete.
+     *
+     * The book doesn't own the underlying books and is not thread safe, the same as BinanceBook.
+    */
+    template <typename TBook, std::size_t MaxVenues = 16>
+    class ConsolidatedBook {
+        static_assert(MaxVenues > 0 && MaxVenues <= 32, "Venues are tracked by bits of a 32-bit mask");
+
+        using TSnapshot = typename TBook::TSnapshot;
+        using TPriceQuantity = typename TSnapshot::TPriceQuantity;
+        using TPrice = decltype(TPriceQuantity::Price);
+        using TQuantity = decltype(TPriceQuantity::Quantity);
+
+        static constexpr std::size_t VenueLevels = std::tuple_size_v<decltype(TSnapshot::Bids)>;
+        static constexpr std::size_t MaxLevels = MaxVenues * VenueLevels;
+
+    public:
+        using TLevel = ConsolidatedLevel<TPrice, TQuantity>;
+
+    private:
+        struct Venue {
+            TBook* Book;
+            TSnapshot Top; // the top levels already applied to the consolidated sides
+        };
+
+        // One side of the consolidated book: levels sorted by TKeyComparator and the quantities of every venue
+        // in separate slots, so inserting a level moves only the small level records.
+        template <typename TKeyComparator>
+        class Side {
+            std::vector<TLevel> Levels_;
+            std::vector<std::array<TQuantity, MaxVenues>> Venues_; // slot -> quantity of every venue
+            std::vector<std::uint32_t> FreeSlots_;
+            [[no_unique_address]] TKeyComparator Comparator_;
+
+        public:
+            Side() : Venues_(MaxLevels) {
+                Levels_.reserve(MaxLevels);
+                FreeSlots_.reserve(MaxLevels);
+                for (std::uint32_t slot = MaxLevels; slot-- > 0; ) {
+                    FreeSlots_.push_back(slot);
+                }
+            }
+
+            [[nodiscard]]
+            std::span<const TLevel> Levels() const noexcept {
+                return Levels_;
+            }
+
+            [[nodiscard]]
+            std::span<const TQuantity, MaxVenues> Breakdown(const TLevel& level) const noexcept {
+                return Venues_[level.Slot];
+            }
+
+            /*
+             * Apply the difference between the previous and the current top levels of the venue,
+             * both sorted in the book order. Levels are visited in the book order too, so each lookup
+             * starts from the position of the previous one.
+            */
+            void Apply(VenueId venue, std::span<const TPriceQuantity> previous, std::span<const TPriceQuantity> current) {
+                std::size_t hint = 0;
+                auto oldIt = previous.begin();
+                auto newIt = current.begin();
+
+                while (oldIt != previous.end() || newIt != current.end()) {
+                    if (newIt == current.end() || (oldIt != previous.end() && Comparator_(oldIt->Price, newIt->Price))) {
+                        hint = Set(venue, oldIt->Price, TQuantity{}, hint);
+                        ++oldIt;
+                    } else if (oldIt == previous.end() || Comparator_(newIt->Price, oldIt->Price)) {
+                        hint = Set(venue, newIt->Price, newIt->Quantity, hint);
+                        ++newIt;
+                    } else {
+                        if (oldIt->Quantity != newIt->Quantity) {
+                            hint = Set(venue, newIt->Price, newIt->Quantity, hint);
+                        }
+                        ++oldIt;
+                        ++newIt;
+                    }
+                }
+            }
+
+        private:
+            // Set the quantity of the venue at the price, zero removes the venue from the level.
+            // Returns the position of the level to be used as the hint of the next lookup.
+            std::size_t Set(VenueId venue, const TPrice& price, const TQuantity& quantity, std::size_t hint) {
+                const auto first = hint <= Levels_.size() && (hint == 0 || Comparator_(Levels_[hint - 1].Price, price))
+                                   ? Levels_.begin() + static_cast<std::ptrdiff_t>(hint)
+                                   : Levels_.begin();
+                const auto it = std::lower_bound(first, Levels_.end(), price, [this](const TLevel& level, const TPrice& key) {
+                    return Comparator_(level.Price, key);
+                });
+                const auto position = static_cast<std::size_t>(it - Levels_.begin());
+                const bool exists = it != Levels_.end() && !Comparator_(price, it->Price);
+                const std::uint32_t bit = std::uint32_t{1} << venue;
+
+                if (quantity == TQuantity{}) {
+                    if (!exists || (it->VenuesMask & bit) == 0) [[unlikely]] {
+                        return position;
+                    }
+
+                    Venues_[it->Slot][venue] = TQuantity{};
+                    it->VenuesMask &= ~bit;
+
+                    if (it->VenuesMask == 0) {
+                        FreeSlots_.push_back(it->Slot);
+                        Levels_.erase(it);
+                    } else {
+                        it->Quantity = Total(*it);
+                    }
+
+                    return position;
+                }
+
+                if (!exists) {
+                    assert(!FreeSlots_.empty());
+
+                    const std::uint32_t slot = FreeSlots_.back();
+                    FreeSlots_.pop_back();
+                    Venues_[slot].fill(TQuantity{});
+
+                    Levels_.insert(it, TLevel {
+                        .Price = price,
+                        .Slot = slot,
+                    });
+                }
+
+                auto& level = Levels_[position];
+                Venues_[level.Slot][venue] = quantity;
+                level.VenuesMask |= bit;
+                level.Quantity = Total(level);
+
+                return position + 1;
+            }
+
+            // The total is summed again instead of being adjusted, so rounding errors don't accumulate.
+            TQuantity Total(const TLevel& level) const noexcept {
+                const auto& quantities = Venues_[level.Slot];
+
+                TQuantity total{};
+                for (auto mask = level.VenuesMask; mask != 0; mask &= mask - 1) {
+                    total += quantities[std::countr_zero(mask)];
+                }
+
+                return total;
+            }
+        };
+
+        std::vector<Venue> Venues_;
+        Side<std::greater<>> Bids_;
+        Side<std::less<>> Asks_;
+        TSnapshot Scratch_; // the new top of the venue being refreshed
+
+    public:
+        ConsolidatedBook() {
+            Venues_.reserve(MaxVenues);
+        }
+
+        // Levels of the venues are compared with copies taken at subscription, the venues must not move.
+        ConsolidatedBook(const ConsolidatedBook&) = delete;
+        ConsolidatedBook& operator=(const ConsolidatedBook&) = delete;
+
+        // Subscribe to the book of a venue, its current levels are added immediately.
+        // The book must outlive the consolidated book.
+        VenueId AddVenue(TBook& book) {
+            assert(Venues_.size() < MaxVenues);
+
+            const auto venue = static_cast<VenueId>(Venues_.size());
+            Venues_.push_back({.Book = &book, .Top = {}});
+            Refresh(venue);
+
+            return venue;
+        }
+
+        [[nodiscard]]
+        std::size_t VenuesCount() const noexcept {
+            return Venues_.size();
+        }
+
+        [[nodiscard]]
+        const TBook& VenueBook(VenueId venue) const noexcept {
+            return *Venues_[venue].Book;
+        }
+
+        // Apply the changes of the venue book made since the last refresh.
+        // Call it after every update of the book made directly rather than through the methods below.
+        void Refresh(VenueId venue) {
+            auto& state = Venues_[venue];
+            state.Book->CopyTop(Scratch_);
+
+            Bids_.Apply(venue, state.Top.GetBids(), Scratch_.GetBids());
+            Asks_.Apply(venue, state.Top.GetAsks(), Scratch_.GetAsks());
+
+            std::swap(state.Top, Scratch_);
+        }
+
+        // Update the book of the venue and the consolidated book.
+        void DepthUpdate(VenueId venue, auto&& bids, auto&& asks) {
+            Venues_[venue].Book->DepthUpdate(bids, asks);
+            Refresh(venue);
+        }
+
+        void BBOUpdate(VenueId venue, Models::BookTicker<TPrice, TQuantity> ticker) {
+            Venues_[venue].Book->BBOUpdate(ticker);
+            Refresh(venue);
+        }
+
+        void Replace(VenueId venue, auto&& bids, auto&& asks) {
+            Venues_[venue].Book->Replace(bids, asks);
+            Refresh(venue);
+        }
+
+        void Clear(VenueId venue) {
+            Venues_[venue].Book->Clear();
+            Refresh(venue);
+        }
+
+        // Consolidated levels of the side in the book order, up to `levels` of them.
+        // The span is invalidated by any update of the consolidated book.
+        [[nodiscard]]
+        std::span<const TLevel> Levels(BookSide side, std::size_t levels = VenueLevels) const noexcept {
+            const auto all = side == BookSide::Bids ? Bids_.Levels() : Asks_.Levels();
+            return all.first(std::min(levels, all.size()));
+        }
+
+        // Quantities of every venue at the level of the side, indexed by VenueId.
+        [[nodiscard]]
+        std::span<const TQuantity> Breakdown(BookSide side, const TLevel& level) const noexcept {
+            const auto quantities = side == BookSide::Bids ? Bids_.Breakdown(level) : Asks_.Breakdown(level);
+            return quantities.first(Venues_.size());
+        }
+    };
+
+}
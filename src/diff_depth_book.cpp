@@ -0,0 +1 @@
+#include "diff_depth_book.h"
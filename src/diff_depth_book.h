@@ -0,0 +1,344 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/container/map.hpp>
+
+#include "models/price_quantity.h"
+#include "parsers/binance_parser.h"
+
+namespace OrderBook {
+
+    // Outcome of applying a diff event to DiffDepthBook.
+    enum class DiffStatus : std::uint8_t {
+        Applied,  // the event has been applied to the book
+        Buffered, // the book is waiting for a snapshot, the event is kept until it arrives
+        Stale,    // the event is already included into the book and has been dropped
+        Gap,      // some events have been missed, the book is waiting for a new snapshot (resync is requested)
+        Overflow, // too many events are waiting for the snapshot, older ones have been dropped (resync is requested)
+    };
+
+    /*
+     * A full-depth order book maintained from a diff depth stream (<symbol>@depth@100ms) and a depth snapshot,
+     * following the Binance rules of keeping a local book:
+     * - diffs received before the snapshot are buffered;
+     * - when the snapshot arrives, buffered diffs with u <= lastUpdateId are dropped and the rest are applied;
+     * - every diff must continue the previous one (U <= last u + 1 <= u), otherwise updates have been missed:
+     *   the book requests a resync through the callback and buffers diffs again until a new snapshot.
+     * The buffer is limited: if the snapshot doesn't come in time, the buffered diffs are dropped
+     * and the resync is requested again, a newer snapshot doesn't need them.
+     *
+     * Unlike BinanceBook the number of levels is not limited, so levels are kept in a tree with nodes from a pool,
+     * making every insertion and removal O(log n) without any system allocations in the steady state.
+     *
+     * The book is not thread safe, the same as BinanceBook.
+    */
+    template <typename TPrice = double, typename TQuantity = double>
+    class DiffDepthBook {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        template <typename TKeyComparator>
+        using TLevels = boost::container::map<TPrice, TQuantity, TKeyComparator,
+                                              std::pmr::polymorphic_allocator<std::pair<const TPrice, TQuantity>>>;
+
+        // A diff kept until the snapshot arrives, its levels are stored in BufferedLevels_.
+        struct BufferedDiff {
+            std::uint64_t FirstUpdateId;
+            std::uint64_t FinalUpdateId;
+            std::size_t BidsCount;
+            std::size_t AsksCount;
+        };
+
+        // Tree nodes are allocated from the pool, removed nodes are reused by next insertions.
+        std::pmr::unsynchronized_pool_resource Pool_;
+        TLevels<std::greater<>> Bids_{&Pool_};
+        TLevels<std::less<>> Asks_{&Pool_};
+
+        bool IsSynced_ = false;
+        std::uint64_t LastUpdateId_ = 0;
+        bool IsReplaying_ = false;    // ApplySnapshot is applying the buffered diffs
+        bool IsResyncPending_ = false; // a gap found while replaying, the resync is requested after the replay
+
+        std::vector<BufferedDiff> BufferedDiffs_;
+        std::vector<TPriceQuantity> BufferedLevels_;
+        std::size_t MaxBufferedDiffs_;
+        std::size_t MaxBufferedLevels_;
+
+        std::function<void()> OnResync_;
+
+    public:
+        // About 15 minutes of a 100ms stream.
+        static constexpr std::size_t DefaultMaxBufferedDiffs = 8192;
+        static constexpr std::size_t DefaultMaxBufferedLevels = 1 << 20;
+
+        // `onResync` is called when a gap is detected or the buffer overflows, it should request a new snapshot
+        // (see ApplySnapshot). The limits bound the diffs and their levels kept while waiting for the snapshot.
+        explicit DiffDepthBook(std::function<void()> onResync = {},
+                               std::size_t maxBufferedDiffs = DefaultMaxBufferedDiffs,
+                               std::size_t maxBufferedLevels = DefaultMaxBufferedLevels)
+            : MaxBufferedDiffs_(maxBufferedDiffs), MaxBufferedLevels_(maxBufferedLevels), OnResync_(std::move(onResync)) {
+        }
+
+        // Levels point to the pool owned by the book.
+        DiffDepthBook(const DiffDepthBook&) = delete;
+        DiffDepthBook& operator=(const DiffDepthBook&) = delete;
+
+        // Whether the book reflects the snapshot and all the diffs after it.
+        [[nodiscard]]
+        bool IsSynced() const noexcept {
+            return IsSynced_;
+        }
+
+        // Final update id of the last applied snapshot or diff.
+        [[nodiscard]]
+        std::uint64_t LastUpdateId() const noexcept {
+            return LastUpdateId_;
+        }
+
+        [[nodiscard]]
+        bool IsEmpty() const noexcept {
+            return Bids_.empty() && Asks_.empty();
+        }
+
+        [[nodiscard]]
+        std::size_t BidsCount() const noexcept {
+            return Bids_.size();
+        }
+
+        [[nodiscard]]
+        std::size_t AsksCount() const noexcept {
+            return Asks_.size();
+        }
+
+        // Number of diffs waiting for the snapshot.
+        [[nodiscard]]
+        std::size_t BufferedCount() const noexcept {
+            return BufferedDiffs_.size();
+        }
+
+        /*
+         * Replace the content of the book with the snapshot (e.g. the response of GET /api/v3/depth)
+         * and apply the buffered diffs following it. If the buffered diffs don't continue the snapshot,
+         * the resync is requested again once all of them are processed, so the callback may apply
+         * the next snapshot right away.
+        */
+        void ApplySnapshot(std::uint64_t lastUpdateId, auto&& bids, auto&& asks) {
+            Bids_.clear();
+            Asks_.clear();
+            SetLevels(Bids_, bids);
+            SetLevels(Asks_, asks);
+
+            IsSynced_ = true;
+            LastUpdateId_ = lastUpdateId;
+
+            // Diffs being replayed are not buffered again, a gap among them restarts buffering with the diff after it.
+            std::vector<BufferedDiff> diffs;
+            std::vector<TPriceQuantity> levels;
+            diffs.swap(BufferedDiffs_);
+            levels.swap(BufferedLevels_);
+
+            IsReplaying_ = true;
+            std::size_t offset = 0;
+            for (const auto& diff : diffs) {
+                const std::span<const TPriceQuantity> diffBids(levels.data() + offset, diff.BidsCount);
+                const std::span<const TPriceQuantity> diffAsks(levels.data() + offset + diff.BidsCount, diff.AsksCount);
+                offset += diff.BidsCount + diff.AsksCount;
+
+                (void)Update(diff.FirstUpdateId, diff.FinalUpdateId, diffBids, diffAsks);
+            }
+            IsReplaying_ = false;
+
+            // Keep the capacity for the next resync.
+            if (BufferedDiffs_.empty()) {
+                diffs.clear();
+                levels.clear();
+                diffs.swap(BufferedDiffs_);
+                levels.swap(BufferedLevels_);
+            }
+
+            if (std::exchange(IsResyncPending_, false)) {
+                RequestResync();
+            }
+        }
+
+        // Apply a diff event with update ids U (first) and u (final).
+        DiffStatus Update(std::uint64_t firstUpdateId, std::uint64_t finalUpdateId, auto&& bids, auto&& asks) {
+            if (!IsSynced_) {
+                if (!Buffer(firstUpdateId, finalUpdateId, bids, asks)) [[unlikely]] {
+                    RequestResync();
+                    return DiffStatus::Overflow;
+                }
+
+                return DiffStatus::Buffered;
+            }
+
+            if (finalUpdateId <= LastUpdateId_) {
+                return DiffStatus::Stale;
+            }
+
+            if (firstUpdateId > LastUpdateId_ + 1) [[unlikely]] {
+                // The diff is the first one of the new stream, the next snapshot is applied before it.
+                IsSynced_ = false;
+                (void)Buffer(firstUpdateId, finalUpdateId, bids, asks);
+                RequestResync();
+
+                return DiffStatus::Gap;
+            }
+
+            UpdateLevels(Bids_, bids);
+            UpdateLevels(Asks_, asks);
+            LastUpdateId_ = finalUpdateId;
+
+            return DiffStatus::Applied;
+        }
+
+        // Apply a parsed diff depth payload.
+        template <typename TMessagePrice, typename TMessageQuantity>
+        DiffStatus Update(const Parsers::DiffDepthMessage<TMessagePrice, TMessageQuantity>& message) {
+            return Update(message.FirstUpdateId, message.FinalUpdateId, message.Bids, message.Asks);
+        }
+
+        // Drop all levels and buffered diffs, the book waits for a snapshot.
+        void Clear() noexcept {
+            Bids_.clear();
+            Asks_.clear();
+            BufferedDiffs_.clear();
+            BufferedLevels_.clear();
+            IsSynced_ = false;
+            LastUpdateId_ = 0;
+            IsResyncPending_ = false;
+        }
+
+        // Views over the bids and asks in the book order, yielding PriceQuantity.
+        [[nodiscard]]
+        auto Levels() const {
+            return std::make_pair(Bids_ | std::views::transform(ToPriceQuantity),
+                                  Asks_ | std::views::transform(ToPriceQuantity));
+        }
+
+        // Copy the top bids and asks into the caller buffers.
+        // Returns the numbers of copied bids and asks, each side is limited by the size of its buffer.
+        std::pair<std::size_t, std::size_t> CopyTop(std::span<TPriceQuantity> bids,
+                                                    std::span<TPriceQuantity> asks) const noexcept {
+            return {CopyLevels(Bids_, bids), CopyLevels(Asks_, asks)};
+        }
+
+    private:
+        static TPriceQuantity ToPriceQuantity(const std::pair<const TPrice, TQuantity>& level) noexcept {
+            return {
+                .Price = level.first,
+                .Quantity = level.second,
+            };
+        }
+
+        template <typename TSide>
+        static void SetLevels(TSide& side, auto&& levels) {
+            for (auto&& level : levels) {
+                if (level.Quantity > TQuantity{}) {
+                    side.insert_or_assign(level.Price, level.Quantity);
+                }
+            }
+        }
+
+        template <typename TSide>
+        static void UpdateLevels(TSide& side, auto&& levels) {
+            for (auto&& level : levels) {
+                if (level.Quantity > TQuantity{}) {
+                    side.insert_or_assign(level.Price, level.Quantity);
+                } else {
+                    side.erase(level.Price);
+                }
+            }
+        }
+
+        template <typename TSide>
+        static std::size_t CopyLevels(const TSide& side, std::span<TPriceQuantity> destination) noexcept {
+            std::size_t count = 0;
+            for (auto it = side.begin(); it != side.end() && count != destination.size(); ++it) {
+                destination[count++] = ToPriceQuantity(*it);
+            }
+
+            return count;
+        }
+
+        void RequestResync() {
+            if (IsReplaying_) {
+                IsResyncPending_ = true;
+            } else if (OnResync_) {
+                OnResync_();
+            }
+        }
+
+        // Returns false if the buffer has overflowed, only the newest diff is kept then (if it fits alone).
+        bool Buffer(std::uint64_t firstUpdateId, std::uint64_t finalUpdateId, auto&& bids, auto&& asks) {
+            // Parsed levels are input ranges with sentinels, so they are copied one by one.
+            const std::size_t before = BufferedLevels_.size();
+            for (auto&& level : bids) {
+                BufferedLevels_.push_back({.Price = level.Price, .Quantity = level.Quantity});
+            }
+
+            const std::size_t afterBids = BufferedLevels_.size();
+            for (auto&& level : asks) {
+                BufferedLevels_.push_back({.Price = level.Price, .Quantity = level.Quantity});
+            }
+
+            BufferedDiffs_.push_back({
+                .FirstUpdateId = firstUpdateId,
+                .FinalUpdateId = finalUpdateId,
+                .BidsCount = afterBids - before,
+                .AsksCount = BufferedLevels_.size() - afterBids,
+            });
+
+            if (BufferedDiffs_.size() <= MaxBufferedDiffs_ && BufferedLevels_.size() <= MaxBufferedLevels_) [[likely]] {
+                return true;
+            }
+
+            // The snapshot requested now is newer than the older diffs, they would be dropped as stale anyway.
+            BufferedDiffs_.erase(BufferedDiffs_.begin(), BufferedDiffs_.end() - 1);
+            BufferedLevels_.erase(BufferedLevels_.begin(), BufferedLevels_.begin() + before);
+            if (BufferedLevels_.size() > MaxBufferedLevels_) {
+                BufferedDiffs_.clear();
+                BufferedLevels_.clear();
+            }
+
+            return false;
+        }
+    };
+
+    /*
+     * Apply the depth snapshot stored in a file, in the format of the GET /api/v3/depth response:
+     * {"lastUpdateId":1027024,"bids":[["4.00000000","431.00000000"]],"asks":[["4.00000200","12.00000000"]]}
+     * Throws std::runtime_error if the file can't be read or is not a depth snapshot.
+    */
+    template <typename TPrice, typename TQuantity>
+    void ApplySnapshotFile(DiffDepthBook<TPrice, TQuantity>& book, const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Failed to open snapshot file " + path);
+        }
+
+        std::stringstream content;
+        content << in.rdbuf();
+        const std::string payload = content.str();
+
+        const auto snapshot = Parsers::ParseDepth<TPrice, TQuantity>(payload);
+        if (!snapshot) {
+            throw std::runtime_error("Not a depth snapshot " + path);
+        }
+
+        book.ApplySnapshot(snapshot->LastUpdateId, snapshot->Bids, snapshot->Asks);
+    }
+
+}
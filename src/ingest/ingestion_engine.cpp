@@ -0,0 +1 @@
+#include "ingestion_engine.h"
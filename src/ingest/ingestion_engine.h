@@ -0,0 +1,354 @@
+#pragma once
+
+#include <cerrno>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <sys/uio.h>
+
+#include "io_uring.h"
+#include "../utils/memory_region.h"
+
+namespace OrderBook::Ingest {
+
+    struct IngestionOptions {
+        unsigned QueueDepth = 256;
+        std::uint32_t BufferSize = 4096;       // the largest socket message, longer ones are cut
+        std::uint16_t BuffersCount = 256;      // socket buffers shared by all sockets
+        std::uint32_t FileBufferSize = 1 << 16; // per file, limits the size of a message read from a file
+        std::size_t MaxFiles = 8;
+    };
+
+    // Counts of IngestionEngine, see Counters.
+    struct IngestionCounters {
+        std::uint64_t Messages{};        // messages delivered to coroutines
+        std::uint64_t Bytes{};           // bytes of the delivered messages
+        std::uint64_t Dropped{};         // messages arrived while no coroutine was awaiting their source
+        std::uint64_t BufferShortages{}; // receives which found no free socket buffer and were retried
+        std::uint64_t Truncated{};       // file messages longer than the file buffer, dropped
+        std::uint64_t Errors{};          // sources closed by a read error
+    };
+
+    using SourceId = std::uint32_t;
+
+    /*
+     * Drives many feed sources from one thread through io_uring (see IoUring) and hands their messages
+     * to coroutines awaiting them (see Utils::Task):
+     *
+     *   Utils::Task Feed(IngestionEngine& engine, SourceId source, BinanceBook<>& book) {
+     *       while (auto message = co_await engine.Next(source)) {
+     *           if (auto depth = Parsers::ParseDepth(*message)) {
+     *               book.DepthUpdate(depth->Bids, depth->Asks);
+     *           }
+     *       }
+     *   }
+     *
+     * Sockets must keep message boundaries (SOCK_SEQPACKET or SOCK_DGRAM Unix sockets): every message is received
+     * by a multishot receive into a buffer the kernel takes from the provided buffers. Files (e.g. recorded
+     * streams during replay) hold messages separated by new lines and are read with READ_FIXED into registered
+     * buffers. Either way the coroutine gets a view straight into the buffer the kernel has written,
+     * valid until it awaits again, when the buffer goes back to the kernel. No messages are copied,
+     * except the incomplete last message of a file read, which is moved to the start of its buffer.
+     *
+     * Messages are delivered only to a coroutine currently awaiting their source, so every source needs
+     * its own coroutine, others are counted as dropped. Next returns std::nullopt once the source is closed
+     * (end of file, the peer closed the socket or an error). The engine doesn't close descriptors.
+     * Throws std::system_error if io_uring can't be set up.
+    */
+    class IngestionEngine {
+        enum class SourceKind : std::uint8_t {
+            Socket,
+            File,
+        };
+
+        struct Source {
+            int Fd = -1;
+            SourceKind Kind = SourceKind::Socket;
+            bool Open = true;
+            std::coroutine_handle<> Waiter;
+            std::optional<std::string_view> Message;
+
+            // Files only: the registered buffer, the next read offset and the bytes of an incomplete message.
+            std::uint32_t FileBuffer = 0;
+            std::uint64_t Offset = 0;
+            std::uint32_t Pending = 0;
+            bool Skipping = false; // the rest of a message longer than the buffer is being dropped
+        };
+
+        static constexpr std::uint16_t BufferGroup = 0;
+
+        IngestionOptions Options_;
+        Utils::MemoryRegion SocketBuffers_;
+        Utils::MemoryRegion FileBuffers_;
+        IoUring Ring_; // closed before the buffers are released, cancelling the requests using them
+        ProvidedBuffers Provided_;
+        std::vector<Source> Sources_;
+        std::size_t FilesCount_ = 0;
+        std::size_t OpenSources_ = 0;
+        IngestionCounters Counters_;
+
+    public:
+        class MessageAwaiter {
+            IngestionEngine& Engine_;
+            SourceId Source_;
+            std::coroutine_handle<> Handle_;
+
+        public:
+            MessageAwaiter(IngestionEngine& engine, SourceId source) noexcept : Engine_(engine), Source_(source) {
+            }
+
+            MessageAwaiter(const MessageAwaiter&) = delete;
+            MessageAwaiter& operator=(const MessageAwaiter&) = delete;
+
+            // A coroutine destroyed while suspended here must not be resumed by the next message of the source.
+            ~MessageAwaiter() {
+                auto& waiter = Engine_.Sources_[Source_].Waiter;
+                if (Handle_ && waiter == Handle_) {
+                    waiter = nullptr;
+                }
+            }
+
+            bool await_ready() const noexcept {
+                return !Engine_.Sources_[Source_].Open;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                Handle_ = handle;
+                Engine_.Sources_[Source_].Waiter = handle;
+            }
+
+            std::optional<std::string_view> await_resume() noexcept {
+                return std::exchange(Engine_.Sources_[Source_].Message, std::nullopt);
+            }
+        };
+
+        explicit IngestionEngine(IngestionOptions options = {})
+            : Options_(options),
+              SocketBuffers_(static_cast<std::size_t>(options.BufferSize) * options.BuffersCount),
+              FileBuffers_(static_cast<std::size_t>(options.FileBufferSize) * options.MaxFiles),
+              Ring_(options.QueueDepth),
+              Provided_(Ring_, BufferGroup, static_cast<std::byte*>(SocketBuffers_.Data()), options.BufferSize,
+                        options.BuffersCount) {
+            std::vector<iovec> buffers(Options_.MaxFiles);
+            for (std::size_t index = 0; index < buffers.size(); ++index) {
+                buffers[index] = {
+                    .iov_base = FileBuffer(index),
+                    .iov_len = Options_.FileBufferSize,
+                };
+            }
+
+            Ring_.RegisterBuffers(buffers);
+        }
+
+        IngestionEngine(const IngestionEngine&) = delete;
+        IngestionEngine& operator=(const IngestionEngine&) = delete;
+
+        // Start receiving from a Unix socket keeping message boundaries.
+        SourceId AddSocket(int fd) {
+            const auto id = AddSource(fd, SourceKind::Socket);
+            ArmReceive(id);
+            return id;
+        }
+
+        // Start reading new line separated messages from a file from its beginning.
+        // Throws std::length_error if MaxFiles files were added already.
+        SourceId AddFile(int fd) {
+            if (FilesCount_ == Options_.MaxFiles) {
+                throw std::length_error("Too many files for the ingestion engine");
+            }
+
+            const auto id = AddSource(fd, SourceKind::File);
+            Sources_[id].FileBuffer = static_cast<std::uint32_t>(FilesCount_++);
+            ArmRead(id);
+            return id;
+        }
+
+        // Await the next message of the source, std::nullopt once the source is closed.
+        [[nodiscard]]
+        MessageAwaiter Next(SourceId source) noexcept {
+            return {*this, source};
+        }
+
+        // Submit the pending requests and deliver the completed messages, waiting for at least one completion
+        // if `wait` and there are open sources. Returns the number of completions handled.
+        std::size_t Poll(bool wait = true) {
+            Ring_.Submit(wait && OpenSources_ != 0 ? 1 : 0);
+
+            return Ring_.ForEachCompletion([this](const io_uring_cqe& cqe) {
+                if (cqe.user_data == ProvidedBuffers::UserData) [[unlikely]] {
+                    throw std::system_error(-cqe.res, std::generic_category(), "Failed to provide socket buffers");
+                }
+
+                const auto id = static_cast<SourceId>(cqe.user_data);
+                if (Sources_[id].Kind == SourceKind::Socket) {
+                    CompleteReceive(id, cqe);
+                } else {
+                    CompleteRead(id, cqe);
+                }
+            });
+        }
+
+        // Deliver messages until all sources are closed.
+        void Run() {
+            while (OpenSources_ != 0) {
+                Poll(true);
+            }
+        }
+
+        [[nodiscard]]
+        std::size_t OpenSources() const noexcept {
+            return OpenSources_;
+        }
+
+        [[nodiscard]]
+        const IngestionCounters& Counters() const noexcept {
+            return Counters_;
+        }
+
+    private:
+        SourceId AddSource(int fd, SourceKind kind) {
+            Source source;
+            source.Fd = fd;
+            source.Kind = kind;
+            Sources_.push_back(source);
+            ++OpenSources_;
+
+            return static_cast<SourceId>(Sources_.size() - 1);
+        }
+
+        std::byte* FileBuffer(std::size_t index) const noexcept {
+            return static_cast<std::byte*>(FileBuffers_.Data()) + index * Options_.FileBufferSize;
+        }
+
+        void ArmReceive(SourceId id) {
+            io_uring_sqe& sqe = Ring_.NextSqe();
+            sqe.opcode = IORING_OP_RECV;
+            sqe.fd = Sources_[id].Fd;
+            sqe.ioprio = IORING_RECV_MULTISHOT;
+            sqe.flags = IOSQE_BUFFER_SELECT;
+            sqe.buf_group = BufferGroup;
+            sqe.user_data = id;
+        }
+
+        void ArmRead(SourceId id) {
+            const Source& source = Sources_[id];
+
+            io_uring_sqe& sqe = Ring_.NextSqe();
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.fd = source.Fd;
+            sqe.addr = reinterpret_cast<std::uint64_t>(FileBuffer(source.FileBuffer) + source.Pending);
+            sqe.len = Options_.FileBufferSize - source.Pending;
+            sqe.off = source.Offset;
+            sqe.buf_index = static_cast<std::uint16_t>(source.FileBuffer);
+            sqe.user_data = id;
+        }
+
+        void CompleteReceive(SourceId id, const io_uring_cqe& cqe) {
+            if (cqe.res > 0 && (cqe.flags & IORING_CQE_F_BUFFER)) [[likely]] {
+                const auto buffer = static_cast<std::uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+                Deliver(id, std::string_view(reinterpret_cast<const char*>(Provided_.Buffer(buffer)),
+                                             static_cast<std::size_t>(cqe.res)));
+                Provided_.Recycle(buffer);
+            } else if (cqe.res == -ENOBUFS) {
+                ++Counters_.BufferShortages;
+            } else if (cqe.res == 0) {
+                Close(id);
+            } else if (cqe.res < 0) {
+                ++Counters_.Errors;
+                Close(id);
+            }
+
+            // A multishot receive stops on errors and when it runs out of buffers.
+            if (!(cqe.flags & IORING_CQE_F_MORE) && Sources_[id].Open) {
+                ArmReceive(id);
+            }
+        }
+
+        void CompleteRead(SourceId id, const io_uring_cqe& cqe) {
+            if (cqe.res < 0) [[unlikely]] {
+                ++Counters_.Errors;
+                Close(id);
+                return;
+            }
+
+            auto* buffer = reinterpret_cast<const char*>(FileBuffer(Sources_[id].FileBuffer));
+            const std::size_t size = Sources_[id].Pending + static_cast<std::size_t>(cqe.res);
+
+            if (cqe.res == 0) {
+                // The last message may lack the new line.
+                if (size != 0) {
+                    Deliver(id, std::string_view(buffer, size));
+                }
+                Close(id);
+                return;
+            }
+
+            std::size_t start = 0;
+            if (Sources_[id].Skipping) [[unlikely]] {
+                const void* newLine = std::memchr(buffer, '\n', size);
+                start = newLine != nullptr ? static_cast<const char*>(newLine) - buffer + 1 : size;
+                Sources_[id].Skipping = newLine == nullptr;
+            }
+
+            while (const void* newLine = std::memchr(buffer + start, '\n', size - start)) {
+                const std::size_t end = static_cast<const char*>(newLine) - buffer;
+                if (end != start) {
+                    Deliver(id, std::string_view(buffer + start, end - start));
+                }
+                start = end + 1;
+            }
+
+            Source& source = Sources_[id];
+            source.Offset += static_cast<std::uint64_t>(cqe.res);
+            source.Pending = static_cast<std::uint32_t>(size - start);
+
+            if (source.Pending == Options_.FileBufferSize) [[unlikely]] {
+                ++Counters_.Truncated;
+                source.Pending = 0;
+                source.Skipping = true;
+            } else if (source.Pending != 0) {
+                std::memmove(FileBuffer(source.FileBuffer), buffer + start, source.Pending);
+            }
+
+            ArmRead(id);
+        }
+
+        // Resume the coroutine awaiting the source, it runs until it awaits again.
+        void Deliver(SourceId id, std::optional<std::string_view> message) {
+            auto waiter = std::exchange(Sources_[id].Waiter, nullptr);
+            if (message) {
+                if (!waiter) [[unlikely]] {
+                    ++Counters_.Dropped;
+                    return;
+                }
+
+                ++Counters_.Messages;
+                Counters_.Bytes += message->size();
+            }
+
+            if (waiter) {
+                Sources_[id].Message = message;
+                waiter.resume();
+            }
+        }
+
+        void Close(SourceId id) {
+            if (!Sources_[id].Open) {
+                return;
+            }
+
+            Sources_[id].Open = false;
+            --OpenSources_;
+            Deliver(id, std::nullopt);
+        }
+    };
+
+}
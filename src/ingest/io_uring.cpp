@@ -0,0 +1 @@
+#include "io_uring.h"
@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace OrderBook::Ingest {
+
+    /*
+     * A minimal io_uring instance driven by the raw system calls, so the project doesn't depend on liburing:
+     * the submission and completion rings mapped from the kernel, plus the registration of fixed buffers
+     * (see also ProvidedBuffers). Used by a single thread.
+     *
+     * Throws std::system_error if the kernel doesn't support io_uring or refuses the setup.
+    */
+    class IoUring {
+        int Fd_ = -1;
+
+        void* SqRing_ = nullptr;
+        std::size_t SqRingSize_ = 0;
+        void* CqRing_ = nullptr; // the same mapping as SqRing_ with IORING_FEAT_SINGLE_MMAP
+        std::size_t CqRingSize_ = 0;
+        io_uring_sqe* Sqes_ = nullptr;
+        std::size_t SqesSize_ = 0;
+
+        unsigned* SqHead_ = nullptr;
+        unsigned* SqTail_ = nullptr;
+        unsigned SqMask_ = 0;
+        unsigned SqEntries_ = 0;
+        unsigned* CqHead_ = nullptr;
+        unsigned* CqTail_ = nullptr;
+        unsigned CqMask_ = 0;
+        io_uring_cqe* Cqes_ = nullptr;
+
+        unsigned LocalTail_ = 0; // submission entries prepared so far
+        unsigned Pending_ = 0;   // submission entries not passed to the kernel yet
+
+    public:
+        explicit IoUring(unsigned entries) {
+            io_uring_params params{};
+            params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN;
+
+            Fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            if (Fd_ < 0 && errno == EINVAL) {
+                // Kernels before 6.0 don't know the flags, they are only optimizations.
+                params = {};
+                Fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+            }
+            if (Fd_ < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to set up io_uring");
+            }
+
+            SqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            CqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            const bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+            if (singleMapping) {
+                SqRingSize_ = CqRingSize_ = std::max(SqRingSize_, CqRingSize_);
+            }
+
+            SqRing_ = Map(SqRingSize_, IORING_OFF_SQ_RING);
+            CqRing_ = singleMapping ? SqRing_ : Map(CqRingSize_, IORING_OFF_CQ_RING);
+            SqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+            Sqes_ = static_cast<io_uring_sqe*>(Map(SqesSize_, IORING_OFF_SQES));
+
+            auto* sq = static_cast<std::byte*>(SqRing_);
+            SqHead_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+            SqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            SqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            SqEntries_ = params.sq_entries;
+
+            // Submission entries are used in order, so the indirection array is filled once.
+            auto* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            for (unsigned index = 0; index < SqEntries_; ++index) {
+                array[index] = index;
+            }
+
+            auto* cq = static_cast<std::byte*>(CqRing_);
+            CqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            CqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            CqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            Cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+            LocalTail_ = *SqTail_;
+        }
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        ~IoUring() {
+            Release();
+        }
+
+        [[nodiscard]]
+        int Fd() const noexcept {
+            return Fd_;
+        }
+
+        // A cleared submission entry to fill, submitted by the next Submit. Submits the pending ones if the ring is full.
+        io_uring_sqe& NextSqe() {
+            if (LocalTail_ - std::atomic_ref(*SqHead_).load(std::memory_order_acquire) == SqEntries_) [[unlikely]] {
+                Submit(0);
+            }
+
+            io_uring_sqe& sqe = Sqes_[LocalTail_ & SqMask_];
+            std::memset(&sqe, 0, sizeof(sqe));
+
+            ++LocalTail_;
+            ++Pending_;
+            std::atomic_ref(*SqTail_).store(LocalTail_, std::memory_order_release);
+
+            return sqe;
+        }
+
+        // Pass the pending submissions to the kernel and wait until at least `waitFor` completions are available.
+        void Submit(unsigned waitFor) {
+            if (Pending_ == 0 && waitFor == 0) {
+                return;
+            }
+
+            const unsigned flags = waitFor != 0 ? IORING_ENTER_GETEVENTS : 0;
+            while (true) {
+                const long submitted = ::syscall(__NR_io_uring_enter, Fd_, Pending_, waitFor, flags, nullptr, 0);
+                if (submitted >= 0) {
+                    Pending_ -= static_cast<unsigned>(submitted);
+                    return;
+                }
+                if (errno != EINTR) {
+                    throw std::system_error(errno, std::generic_category(), "Failed to submit to io_uring");
+                }
+            }
+        }
+
+        // Call `handler(cqe)` for every available completion, returns their number.
+        template <typename THandler>
+        unsigned ForEachCompletion(THandler&& handler) {
+            const unsigned first = *CqHead_;
+            const unsigned tail = std::atomic_ref(*CqTail_).load(std::memory_order_acquire);
+
+            for (unsigned head = first; head != tail; ++head) {
+                const io_uring_cqe cqe = Cqes_[head & CqMask_];
+                // Release the entry before handling it, the handler may submit and wait again.
+                std::atomic_ref(*CqHead_).store(head + 1, std::memory_order_release);
+                handler(cqe);
+            }
+
+            return tail - first;
+        }
+
+        // Register buffers for IORING_OP_READ_FIXED/WRITE_FIXED, referred to by their index.
+        void RegisterBuffers(std::span<const iovec> buffers) {
+            Register(IORING_REGISTER_BUFFERS, buffers.data(), static_cast<unsigned>(buffers.size()),
+                     "Failed to register io_uring buffers");
+        }
+
+    private:
+        void Release() noexcept {
+            if (Sqes_ != nullptr) {
+                ::munmap(Sqes_, SqesSize_);
+            }
+            if (CqRing_ != nullptr && CqRing_ != SqRing_) {
+                ::munmap(CqRing_, CqRingSize_);
+            }
+            if (SqRing_ != nullptr) {
+                ::munmap(SqRing_, SqRingSize_);
+            }
+            if (Fd_ >= 0) {
+                ::close(Fd_);
+            }
+
+            Sqes_ = nullptr;
+            CqRing_ = SqRing_ = nullptr;
+            Fd_ = -1;
+        }
+
+        void* Map(std::size_t size, std::uint64_t offset) {
+            void* data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, Fd_, static_cast<off_t>(offset));
+            if (data == MAP_FAILED) {
+                const int error = errno;
+                Release();
+                throw std::system_error(error, std::generic_category(), "Failed to map io_uring rings");
+            }
+
+            return data;
+        }
+
+        void Register(unsigned opcode, const void* argument, unsigned count, const char* message) {
+            if (::syscall(__NR_io_uring_register, Fd_, opcode, argument, count) < 0) {
+                throw std::system_error(errno, std::generic_category(), message);
+            }
+        }
+    };
+
+    /*
+     * Equally sized buffers the kernel picks from when a request with IOSQE_BUFFER_SELECT completes,
+     * e.g. every completion of a multishot receive takes the next free buffer of the group. The buffer id
+     * comes with the completion, the owner returns the buffer with Recycle once its contents are consumed.
+     * The buffers are handed over with IORING_OP_PROVIDE_BUFFERS queued before the next submission; they post
+     * completions only if they fail, with UserData. The buffers live in memory of the owner and must outlive the ring.
+    */
+    class ProvidedBuffers {
+        IoUring& Ring_;
+        std::uint16_t Group_ = 0;
+        std::byte* Buffers_ = nullptr;
+        std::uint32_t BufferSize_ = 0;
+
+    public:
+        static constexpr std::uint64_t UserData = ~std::uint64_t{0};
+
+        ProvidedBuffers(IoUring& ring, std::uint16_t group, std::byte* buffers, std::uint32_t bufferSize, std::uint16_t count)
+            : Ring_(ring), Group_(group), Buffers_(buffers), BufferSize_(bufferSize) {
+            Provide(0, count);
+        }
+
+        ProvidedBuffers(const ProvidedBuffers&) = delete;
+        ProvidedBuffers& operator=(const ProvidedBuffers&) = delete;
+
+        [[nodiscard]]
+        std::byte* Buffer(std::uint16_t id) const noexcept {
+            return Buffers_ + static_cast<std::size_t>(id) * BufferSize_;
+        }
+
+        // Give the buffer back to the kernel.
+        void Recycle(std::uint16_t id) {
+            Provide(id, 1);
+        }
+
+    private:
+        void Provide(std::uint16_t first, std::uint16_t count) {
+            io_uring_sqe& sqe = Ring_.NextSqe();
+            sqe.opcode = IORING_OP_PROVIDE_BUFFERS;
+            sqe.fd = count;
+            sqe.addr = reinterpret_cast<std::uint64_t>(Buffer(first));
+            sqe.len = BufferSize_;
+            sqe.off = first;
+            sqe.buf_group = Group_;
+            sqe.flags = IOSQE_CQE_SKIP_SUCCESS;
+            sqe.user_data = UserData;
+        }
+    };
+
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "websocket_frame.h"
+
+namespace OrderBook::Ingest {
+
+    enum class WebSocketError : std::uint8_t {
+        None,
+        ProtocolError, // a malformed frame, the connection should be closed with WebSocketCloseCode::ProtocolError
+        MessageTooBig, // a message longer than the buffer, the connection should be closed with MessageTooBig
+    };
+
+    // A complete message delivered by WebSocketDecoder, valid only during the call of the handler.
+    struct WebSocketMessage {
+        WebSocketOpcode Opcode{}; // never Continuation, fragmented messages are delivered with the opcode of the first frame
+        std::span<const std::byte> Payload;
+
+        [[nodiscard]]
+        std::string_view Text() const noexcept {
+            return {reinterpret_cast<const char*>(Payload.data()), Payload.size()};
+        }
+
+        // Status of a Close message, WebSocketCloseCode::NoStatus if it has none.
+        [[nodiscard]]
+        std::uint16_t CloseCode() const noexcept {
+            if (Payload.size() < 2) {
+                return static_cast<std::uint16_t>(WebSocketCloseCode::NoStatus);
+            }
+
+            return static_cast<std::uint16_t>((std::to_integer<std::uint16_t>(Payload[0]) << 8)
+                                              | std::to_integer<std::uint16_t>(Payload[1]));
+        }
+
+        [[nodiscard]]
+        std::string_view CloseReason() const noexcept {
+            return Payload.size() > 2 ? Text().substr(2) : std::string_view();
+        }
+    };
+
+    struct WebSocketDecodeResult {
+        std::size_t Consumed{}; // bytes of complete frames, the rest must be passed again with more data appended
+        WebSocketError Error = WebSocketError::None;
+    };
+
+    /*
+     * Decodes WebSocket frames (see websocket_frame.h) received from a stream without allocations.
+     *
+     * Decode takes the bytes received so far, calls `handler(const WebSocketMessage&)` for every complete message
+     * and reports how many bytes it has consumed; an incomplete frame at the end is left for the next call.
+     * Payloads of unfragmented messages, which is nearly every message of market data streams, are delivered
+     * straight from the input. Fragments are collected into the buffer given to the constructor, which also limits
+     * the size of messages. Control frames may arrive between fragments and are delivered at once.
+     * Masked frames are unmasked in place, so the decoder also reads frames sent by clients.
+     *
+     * Nothing is delivered after a Close message or an error. Extensions are not supported, frames with
+     * RSV bits set are protocol errors. Text messages are not validated as UTF-8.
+    */
+    class WebSocketDecoder {
+        std::span<std::byte> Fragments_; // payload of the fragmented message being collected
+        std::size_t FragmentsSize_ = 0;
+        WebSocketOpcode FragmentsOpcode_ = WebSocketOpcode::Continuation; // Continuation if there is no such message
+        bool Closed_ = false;
+        WebSocketError Error_ = WebSocketError::None;
+
+    public:
+        // The buffer must outlive the decoder, messages longer than it are rejected as MessageTooBig.
+        explicit WebSocketDecoder(std::span<std::byte> fragments) noexcept : Fragments_(fragments) {
+        }
+
+        template <typename THandler>
+        WebSocketDecodeResult Decode(std::span<std::byte> input, THandler&& handler) {
+            std::size_t position = 0;
+
+            while (!Closed_ && Error_ == WebSocketError::None) {
+                const auto frame = input.subspan(position);
+                if (frame.size() < 2) {
+                    break;
+                }
+
+                const auto first = std::to_integer<std::uint8_t>(frame[0]);
+                const auto second = std::to_integer<std::uint8_t>(frame[1]);
+                const bool final = (first & 0x80) != 0;
+                const auto opcode = static_cast<WebSocketOpcode>(first & 0x0F);
+                const bool masked = (second & 0x80) != 0;
+                const std::uint8_t shortSize = second & 0x7F;
+
+                const std::size_t sizeBytes = shortSize == 126 ? 2 : shortSize == 127 ? 8 : 0;
+                const std::size_t headerSize = 2 + sizeBytes + (masked ? 4 : 0);
+                if (frame.size() < headerSize) {
+                    break;
+                }
+
+                std::uint64_t size = shortSize;
+                if (sizeBytes != 0) {
+                    size = 0;
+                    for (std::size_t index = 0; index < sizeBytes; ++index) {
+                        size = (size << 8) | std::to_integer<std::uint64_t>(frame[2 + index]);
+                    }
+                }
+
+                if ((first & 0x70) != 0 || !IsValidFrame(opcode, final, size)) [[unlikely]] {
+                    Error_ = WebSocketError::ProtocolError;
+                    break;
+                }
+
+                const bool collected = !IsControl(opcode) && (!final || opcode == WebSocketOpcode::Continuation);
+                if (size > (collected ? Fragments_.size() - FragmentsSize_ : Fragments_.size())) [[unlikely]] {
+                    Error_ = WebSocketError::MessageTooBig;
+                    break;
+                }
+
+                if (frame.size() - headerSize < size) {
+                    break;
+                }
+
+                const auto payload = frame.subspan(headerSize, static_cast<std::size_t>(size));
+                if (masked) {
+                    WebSocketMask mask;
+                    std::memcpy(mask.data(), frame.data() + headerSize - mask.size(), mask.size());
+                    ApplyWebSocketMask(payload, mask);
+                }
+                position += headerSize + payload.size();
+
+                if (!collected) [[likely]] {
+                    if (opcode == WebSocketOpcode::Close) {
+                        if (payload.size() == 1) [[unlikely]] {
+                            Error_ = WebSocketError::ProtocolError;
+                            break;
+                        }
+                        Closed_ = true;
+                    }
+
+                    const WebSocketMessage message{.Opcode = opcode, .Payload = payload};
+                    handler(message);
+                    continue;
+                }
+
+                if (opcode != WebSocketOpcode::Continuation) {
+                    FragmentsOpcode_ = opcode;
+                }
+                std::memcpy(Fragments_.data() + FragmentsSize_, payload.data(), payload.size());
+                FragmentsSize_ += payload.size();
+
+                if (final) {
+                    const auto message = WebSocketMessage{
+                        .Opcode = FragmentsOpcode_,
+                        .Payload = Fragments_.first(FragmentsSize_),
+                    };
+                    FragmentsOpcode_ = WebSocketOpcode::Continuation;
+                    FragmentsSize_ = 0;
+
+                    handler(message);
+                }
+            }
+
+            return {position, Error_};
+        }
+
+        // Whether a Close message has been received.
+        [[nodiscard]]
+        bool IsClosed() const noexcept {
+            return Closed_;
+        }
+
+        [[nodiscard]]
+        WebSocketError Error() const noexcept {
+            return Error_;
+        }
+
+        // Forget the state of the previous connection.
+        void Reset() noexcept {
+            FragmentsSize_ = 0;
+            FragmentsOpcode_ = WebSocketOpcode::Continuation;
+            Closed_ = false;
+            Error_ = WebSocketError::None;
+        }
+
+    private:
+        bool IsValidFrame(WebSocketOpcode opcode, bool final, std::uint64_t size) const noexcept {
+            const bool collecting = FragmentsOpcode_ != WebSocketOpcode::Continuation;
+
+            switch (opcode) {
+                case WebSocketOpcode::Continuation:
+                    return collecting;
+                case WebSocketOpcode::Text:
+                case WebSocketOpcode::Binary:
+                    return !collecting && (size >> 63) == 0;
+                case WebSocketOpcode::Close:
+                case WebSocketOpcode::Ping:
+                case WebSocketOpcode::Pong:
+                    return final && size <= MaxControlPayloadSize;
+            }
+
+            return false;
+        }
+    };
+
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+
+namespace OrderBook::Ingest {
+
+    /*
+     * WebSocket framing (RFC 6455, section 5.2):
+     *
+     *   FIN, RSV1-3, opcode                 1 byte
+     *   MASK, payload length                1 byte, the length is 0-125, or 126/127 for the extended lengths
+     *   extended payload length             2 or 8 bytes, big endian
+     *   masking key                         4 bytes, if MASK is set
+     *   payload
+     *
+     * Frames sent by clients are masked with a random key, frames sent by servers are not.
+     * Control frames (Close, Ping, Pong) are never fragmented and carry at most 125 bytes.
+    */
+
+    enum class WebSocketOpcode : std::uint8_t {
+        Continuation = 0x0,
+        Text = 0x1,
+        Binary = 0x2,
+        Close = 0x8,
+        Ping = 0x9,
+        Pong = 0xA,
+    };
+
+    // Status codes of Close frames used here.
+    enum class WebSocketCloseCode : std::uint16_t {
+        Normal = 1000,
+        ProtocolError = 1002,
+        NoStatus = 1005, // never sent, reported for a Close frame without a status
+        MessageTooBig = 1009,
+    };
+
+    using WebSocketMask = std::array<std::byte, 4>;
+
+    constexpr std::size_t MaxWebSocketHeaderSize = 14;
+    constexpr std::size_t MaxControlPayloadSize = 125;
+
+    [[nodiscard]]
+    constexpr bool IsControl(WebSocketOpcode opcode) noexcept {
+        return (static_cast<std::uint8_t>(opcode) & 0x8) != 0;
+    }
+
+    // XOR the payload with the masking key in place, eight bytes at a time.
+    // `offset` is the position of the first byte of `payload` within the payload of the frame.
+    inline void ApplyWebSocketMask(std::span<std::byte> payload, WebSocketMask mask, std::size_t offset = 0) noexcept {
+        std::array<std::byte, 8> pattern;
+        for (std::size_t index = 0; index < pattern.size(); ++index) {
+            pattern[index] = mask[(offset + index) % mask.size()];
+        }
+
+        std::uint64_t word;
+        std::memcpy(&word, pattern.data(), sizeof(word));
+
+        std::byte* const data = payload.data();
+        std::size_t index = 0;
+        for (; index + sizeof(word) <= payload.size(); index += sizeof(word)) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, data + index, sizeof(chunk));
+            chunk ^= word;
+            std::memcpy(data + index, &chunk, sizeof(chunk));
+        }
+
+        for (; index < payload.size(); ++index) {
+            data[index] ^= pattern[index % pattern.size()];
+        }
+    }
+
+    /*
+     * Write a frame into `out`, which must have room for MaxWebSocketHeaderSize bytes and the payload.
+     * The payload is masked if the key is given, as required for frames of clients.
+     * Returns the size of the frame.
+    */
+    inline std::size_t EncodeWebSocketFrame(std::byte* out, WebSocketOpcode opcode, std::span<const std::byte> payload,
+                                            bool final = true, std::optional<WebSocketMask> mask = std::nullopt) noexcept {
+        std::byte* it = out;
+        *it++ = static_cast<std::byte>((final ? 0x80 : 0x00) | static_cast<std::uint8_t>(opcode));
+
+        const std::byte maskBit = mask ? std::byte{0x80} : std::byte{0x00};
+        const std::uint64_t size = payload.size();
+        if (size < 126) {
+            *it++ = maskBit | static_cast<std::byte>(size);
+        } else if (size <= 0xFFFF) {
+            *it++ = maskBit | std::byte{126};
+            for (int shift = 8; shift >= 0; shift -= 8) {
+                *it++ = static_cast<std::byte>(size >> shift);
+            }
+        } else {
+            *it++ = maskBit | std::byte{127};
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                *it++ = static_cast<std::byte>(size >> shift);
+            }
+        }
+
+        if (mask) {
+            std::memcpy(it, mask->data(), mask->size());
+            it += mask->size();
+        }
+
+        if (!payload.empty()) {
+            std::memcpy(it, payload.data(), payload.size());
+            if (mask) {
+                ApplyWebSocketMask(std::span(it, payload.size()), *mask);
+            }
+            it += payload.size();
+        }
+
+        return static_cast<std::size_t>(it - out);
+    }
+
+}
@@ -0,0 +1 @@
+#include "websocket_stream.h"
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <system_error>
+
+#include <poll.h>
+#include <sys/random.h>
+#include <sys/socket.h>
+
+#include "websocket_decoder.h"
+#include "../utils/memory_region.h"
+
+namespace OrderBook::Ingest {
+
+    /*
+     * The client side of a WebSocket connection over a connected stream socket, after the opening handshake:
+     * receives frames into its own buffer, decodes them in place (see WebSocketDecoder) and passes data messages
+     * to the handler, e.g. Parsers::ParseDepth followed by BinanceBook::DepthUpdate. Pings are answered with pongs
+     * and a Close with a Close, as RFC 6455 requires, frames of the client are masked with random keys.
+     *
+     * Both buffers are allocated by the constructor, nothing is allocated or copied per message,
+     * except the fragments of fragmented messages. The stream doesn't close the descriptor.
+     * Throws std::system_error if the socket fails.
+    */
+    class WebSocketStream {
+        int Fd_ = -1;
+        Utils::MemoryRegion Memory_; // the receive buffer followed by the buffer of fragments
+        std::span<std::byte> Received_;
+        std::size_t ReceivedSize_ = 0;
+        WebSocketDecoder Decoder_;
+        std::array<std::byte, MaxWebSocketHeaderSize + MaxControlPayloadSize> Reply_{};
+        bool Open_ = true;
+        bool CloseSent_ = false;
+
+    public:
+        // Messages longer than `maxMessageSize` close the connection with WebSocketCloseCode::MessageTooBig.
+        explicit WebSocketStream(int fd, std::size_t maxMessageSize = 1 << 20)
+            : Fd_(fd),
+              Memory_(2 * maxMessageSize + MaxWebSocketHeaderSize),
+              Received_(static_cast<std::byte*>(Memory_.Data()), maxMessageSize + MaxWebSocketHeaderSize),
+              Decoder_(std::span(Received_.data() + Received_.size(), maxMessageSize)) {
+        }
+
+        WebSocketStream(const WebSocketStream&) = delete;
+        WebSocketStream& operator=(const WebSocketStream&) = delete;
+
+        /*
+         * Receive what the socket has (waiting for it if the socket is blocking) and call `handler(message)`
+         * for every complete Text or Binary message. Returns false once the connection is closed:
+         * the server has sent a Close or closed the socket, or it has sent a malformed frame.
+        */
+        template <typename THandler>
+        bool Poll(THandler&& handler) {
+            if (!Open_) {
+                return false;
+            }
+
+            const ssize_t received = ::recv(Fd_, Received_.data() + ReceivedSize_, Received_.size() - ReceivedSize_, 0);
+            if (received <= 0) {
+                if (received == 0) {
+                    Open_ = false;
+                    return false;
+                }
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    return true;
+                }
+                throw std::system_error(errno, std::generic_category(), "Failed to receive WebSocket frames");
+            }
+            ReceivedSize_ += static_cast<std::size_t>(received);
+
+            const auto result = Decoder_.Decode(Received_.first(ReceivedSize_), [&](const WebSocketMessage& message) {
+                switch (message.Opcode) {
+                    case WebSocketOpcode::Text:
+                    case WebSocketOpcode::Binary:
+                        handler(message);
+                        break;
+                    case WebSocketOpcode::Ping:
+                        Send(WebSocketOpcode::Pong, message.Payload);
+                        break;
+                    case WebSocketOpcode::Close:
+                        if (!CloseSent_) {
+                            // Echo the status of the server.
+                            CloseSent_ = true;
+                            Send(WebSocketOpcode::Close, message.Payload.first(std::min<std::size_t>(message.Payload.size(), 2)));
+                        }
+                        break;
+                    default:
+                        break;
+                }
+            });
+
+            if (result.Error != WebSocketError::None) [[unlikely]] {
+                Close(result.Error == WebSocketError::MessageTooBig ? WebSocketCloseCode::MessageTooBig
+                                                                    : WebSocketCloseCode::ProtocolError);
+            }
+
+            if (!Open_ || Decoder_.IsClosed()) {
+                Open_ = false;
+                return false;
+            }
+
+            // Keep the incomplete frame for the next receive.
+            ReceivedSize_ -= result.Consumed;
+            if (ReceivedSize_ != 0 && result.Consumed != 0) {
+                std::memmove(Received_.data(), Received_.data() + result.Consumed, ReceivedSize_);
+            }
+
+            return true;
+        }
+
+        // Start the closing handshake, Poll returns false once the server has answered.
+        void Close(WebSocketCloseCode code = WebSocketCloseCode::Normal) {
+            if (CloseSent_) {
+                return;
+            }
+
+            CloseSent_ = true;
+            const std::array status = {
+                static_cast<std::byte>(static_cast<std::uint16_t>(code) >> 8),
+                static_cast<std::byte>(static_cast<std::uint16_t>(code)),
+            };
+            Send(WebSocketOpcode::Close, status);
+
+            if (code != WebSocketCloseCode::Normal) {
+                Open_ = false;
+            }
+        }
+
+        [[nodiscard]]
+        bool IsOpen() const noexcept {
+            return Open_;
+        }
+
+        [[nodiscard]]
+        WebSocketError Error() const noexcept {
+            return Decoder_.Error();
+        }
+
+    private:
+        void Send(WebSocketOpcode opcode, std::span<const std::byte> payload) {
+            WebSocketMask mask;
+            if (::getrandom(mask.data(), mask.size(), 0) != static_cast<ssize_t>(mask.size())) {
+                throw std::system_error(errno, std::generic_category(), "Failed to generate a WebSocket mask");
+            }
+
+            const std::size_t size = EncodeWebSocketFrame(Reply_.data(), opcode, payload, true, mask);
+
+            std::size_t sent = 0;
+            while (sent != size) {
+                const ssize_t written = ::send(Fd_, Reply_.data() + sent, size - sent, MSG_NOSIGNAL);
+                if (written >= 0) {
+                    sent += static_cast<std::size_t>(written);
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    pollfd descriptor{.fd = Fd_, .events = POLLOUT, .revents = 0};
+                    ::poll(&descriptor, 1, -1);
+                } else if (errno != EINTR) {
+                    throw std::system_error(errno, std::generic_category(), "Failed to send a WebSocket frame");
+                }
+            }
+        }
+    };
+
+}
@@ -0,0 +1 @@
+#include "instrumentation.h"
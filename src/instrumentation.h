@@ -0,0 +1,175 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/log_histogram.h"
+#include "utils/tsc.h"
+
+namespace OrderBook {
+
+    // Book operations with measured latency.
+    enum class BookOperation : std::uint8_t {
+        DepthUpdate,
+        BBOUpdate,
+        Extract,     // traversal of one side through its generator, including the time the caller spends on the levels
+        Replace,     // replacement of both sides, kept apart from the much cheaper incremental updates
+    };
+
+    inline constexpr std::size_t BookOperationsCount = 4;
+
+    // Notable paths taken by the book while applying updates.
+    enum class BookEvent : std::uint8_t {
+        BestLevelChanged,    // the price of the best level of a side has changed
+        Eviction,            // the worst level was dropped to keep PriceLevels levels
+        IgnoredZeroQuantity, // zero quantity update for a price which is not in the book
+        BBOOnEmptyBook,      // BBO update has inserted the first level of an empty side
+    };
+
+    inline constexpr std::size_t BookEventsCount = 4;
+
+    using LatencyHistogram = Utils::LogHistogram<>;
+
+    // Statistics of a book: latencies in TSC ticks (see Utils::TscTicksPerNanosecond) and event counts.
+    struct BookStatistics {
+        std::array<LatencyHistogram::Snapshot, BookOperationsCount> Latencies{};
+        std::array<std::uint64_t, BookEventsCount> Events{};
+
+        [[nodiscard]]
+        const LatencyHistogram::Snapshot& Latency(BookOperation operation) const noexcept {
+            return Latencies[static_cast<std::size_t>(operation)];
+        }
+
+        [[nodiscard]]
+        std::uint64_t Count(BookEvent event) const noexcept {
+            return Events[static_cast<std::size_t>(event)];
+        }
+
+        // Remove everything counted in the baseline (an earlier snapshot of the same book).
+        BookStatistics& operator-=(const BookStatistics& baseline) noexcept {
+            for (std::size_t operation = 0; operation < BookOperationsCount; ++operation) {
+                Latencies[operation] -= baseline.Latencies[operation];
+            }
+
+            for (std::size_t event = 0; event < BookEventsCount; ++event) {
+                Events[event] -= baseline.Events[event];
+            }
+
+            return *this;
+        }
+    };
+
+    /*
+     * Instrumentation policy of BinanceBook and OrderMap, which doesn't measure anything.
+     * All members are empty and all calls are no-ops, so a book with this policy is the same as without any.
+    */
+    struct DisabledInstrumentation {
+        static constexpr bool Enabled = false;
+
+        struct TEventCounters {
+            void Increment(BookEvent) noexcept {
+            }
+        };
+
+        struct TScope {
+        };
+
+        TScope Measure(BookOperation) noexcept {
+            return {};
+        }
+    };
+
+    /*
+     * Instrumentation policy recording the latency of every book operation into a log-bucketed histogram
+     * and counting notable events.
+     *
+     * Counters are written only by the thread owning the book, without locked instructions,
+     * and can be read by any thread at any time (see BinanceBook::Statistics). Readers never write the counters:
+     * to reset the statistics a reader keeps a snapshot as a baseline and subtracts it from later snapshots
+     * (see StatisticsReader).
+    */
+    class EnabledInstrumentation {
+    public:
+        static constexpr bool Enabled = true;
+
+        class TEventCounters {
+            std::array<std::atomic<std::uint64_t>, BookEventsCount> Counts_{};
+
+        public:
+            void Increment(BookEvent event) noexcept {
+                auto& counter = Counts_[static_cast<std::size_t>(event)];
+                counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            }
+
+            // Add the counts to the statistics.
+            void AddTo(BookStatistics& statistics) const noexcept {
+                for (std::size_t event = 0; event < BookEventsCount; ++event) {
+                    statistics.Events[event] += Counts_[event].load(std::memory_order_relaxed);
+                }
+            }
+        };
+
+        // Records the duration of the operation when destroyed.
+        class TScope {
+            LatencyHistogram* Histogram_;
+            std::uint64_t Start_;
+
+        public:
+            explicit TScope(LatencyHistogram* histogram) noexcept : Histogram_(histogram), Start_(Utils::ReadTsc()) {
+            }
+
+            TScope(const TScope&) = delete;
+            TScope& operator=(const TScope&) = delete;
+
+            ~TScope() {
+                Histogram_->Record(Utils::ReadTsc() - Start_);
+            }
+        };
+
+    private:
+        std::array<LatencyHistogram, BookOperationsCount> Latencies_;
+
+    public:
+        [[nodiscard]]
+        TScope Measure(BookOperation operation) noexcept {
+            return TScope(&Latencies_[static_cast<std::size_t>(operation)]);
+        }
+
+        // Add the latencies to the statistics.
+        void AddTo(BookStatistics& statistics) const noexcept {
+            for (std::size_t operation = 0; operation < BookOperationsCount; ++operation) {
+                statistics.Latencies[operation] = Latencies_[operation].Load();
+            }
+        }
+    };
+
+    /*
+     * Reader side of the book statistics with reset support: Read returns what was recorded since the last Reset.
+     * The book keeps counting from the start, the reader only remembers the baseline,
+     * so reading and resetting never interfere with the thread updating the book.
+    */
+    template <typename TBook>
+    class StatisticsReader {
+        const TBook* Book_;
+        BookStatistics Baseline_{};
+
+    public:
+        explicit StatisticsReader(const TBook& book) noexcept : Book_(&book) {
+        }
+
+        [[nodiscard]]
+        BookStatistics Read() const noexcept {
+            auto statistics = Book_->Statistics();
+            statistics -= Baseline_;
+
+            return statistics;
+        }
+
+        void Reset() noexcept {
+            Baseline_ = Book_->Statistics();
+        }
+    };
+
+}
@@ -0,0 +1 @@
+#include "level_events.h"
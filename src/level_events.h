@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "analytics.h"
+
+namespace OrderBook {
+
+    enum class LevelEventType : std::uint8_t {
+        Add,         // a price level appeared, OldQuantity is 0
+        Modify,      // the quantity of a level changed
+        Delete,      // a price level disappeared, NewQuantity is 0
+        BestChanged, // the best price of the side changed, Price is the new best (0 if the side became empty)
+    };
+
+    /*
+     * A change of one price level of a book as seen through BinanceBook::Levels. Applying the Add, Modify and Delete
+     * events of a side to a copy of its levels in the order of arrival keeps the copy equal to the side of the book.
+     * BestChanged comes after the level events of the same change and only informs about the new best price,
+     * its quantities are those of the previous and the new best level.
+    */
+    template <typename TPrice, typename TQuantity>
+    struct LevelEvent {
+        TPrice Price{};
+        TQuantity OldQuantity{};
+        TQuantity NewQuantity{};
+        LevelEventType Type{};
+        BookSide Side{};
+    };
+
+    /*
+     * Caller-provided storage for level events (see BinanceBook::EmitLevelEventsTo). The book appends events,
+     * the consumer reads them with Events and calls Clear before the next batch of updates.
+     *
+     * If the storage is full, further events are dropped and NeedsResync is set, the consumer should then take
+     * the whole levels of the book. The same happens if the storage of the book drops levels on its own
+     * (TickLadder moving its window). A level of an update usually emits one or two events, a change of the best price
+     * also emits the levels it hides or reveals, so size the storage for a few events per updated level.
+    */
+    template <typename TPrice, typename TQuantity>
+    class LevelEventBuffer {
+    public:
+        using TLevelEvent = LevelEvent<TPrice, TQuantity>;
+
+    private:
+        std::span<TLevelEvent> Storage_;
+        std::size_t Size_ = 0;
+        bool NeedsResync_ = false;
+
+    public:
+        explicit LevelEventBuffer(std::span<TLevelEvent> storage) noexcept : Storage_(storage) {
+        }
+
+        void Push(const TLevelEvent& event) noexcept {
+            if (Size_ == Storage_.size()) [[unlikely]] {
+                NeedsResync_ = true;
+                return;
+            }
+
+            Storage_[Size_++] = event;
+        }
+
+        // The consumer can't rely on the events alone anymore.
+        void RequestResync() noexcept {
+            NeedsResync_ = true;
+        }
+
+        [[nodiscard]]
+        std::span<const TLevelEvent> Events() const noexcept {
+            return Storage_.first(Size_);
+        }
+
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Size_;
+        }
+
+        [[nodiscard]]
+        bool NeedsResync() const noexcept {
+            return NeedsResync_;
+        }
+
+        void Clear() noexcept {
+            Size_ = 0;
+            NeedsResync_ = false;
+        }
+    };
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "price_quantity.h"
+
+namespace OrderBook::Models {
+
+    /*
+     * The complete state of a book as it is stored (see BinanceBook::SaveState): the best order of each side
+     * and all stored orders of the side in the book order. Unlike TopOfBook it includes the orders hidden
+     * above a best order moved by a BBO update, so a book restored from it behaves exactly as the saved one.
+     * The best order of a side is meaningful only if the side has orders.
+    */
+    template <typename TPrice, typename TQuantity, std::size_t Levels>
+    struct BookState {
+        using TPriceQuantity = PriceQuantity<TPrice, TQuantity>;
+
+        std::uint16_t BidsCount{};
+        std::uint16_t AsksCount{};
+        TPriceQuantity BestBid;
+        TPriceQuantity BestAsk;
+        std::array<TPriceQuantity, Levels> Bids;
+        std::array<TPriceQuantity, Levels> Asks;
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetBids() const noexcept {
+            return {Bids.data(), BidsCount};
+        }
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetAsks() const noexcept {
+            return {Asks.data(), AsksCount};
+        }
+    };
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "book_ticker.h"
+#include "price_quantity.h"
+
+namespace OrderBook::Models {
+
+    enum class UpdateType : std::uint8_t {
+        Depth, // partial depth update with up to PriceLevels bids and asks
+        BBO,   // best bid/offer update
+    };
+
+    /*
+     * A fixed-size record carrying a single decoded update for a book.
+     * It holds either a book ticker or a partial depth payload in inline arrays, so it can be passed between threads
+     * through preallocated queues without any allocations.
+    */
+    template <typename TPrice, typename TQuantity, std::size_t PriceLevels = 20>
+    struct BookUpdate {
+        using TPriceQuantity = PriceQuantity<TPrice, TQuantity>;
+
+        std::uint64_t Timestamp{}; // receive time in the clock chosen by the producer
+        std::uint32_t SymbolId{};
+        UpdateType Type{};
+        std::uint16_t BidsCount{};
+        std::uint16_t AsksCount{};
+        BookTicker<TPrice, TQuantity> Ticker;
+        std::array<TPriceQuantity, PriceLevels> Bids;
+        std::array<TPriceQuantity, PriceLevels> Asks;
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetBids() const noexcept {
+            return {Bids.data(), BidsCount};
+        }
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetAsks() const noexcept {
+            return {Asks.data(), AsksCount};
+        }
+
+        void SetTicker(BookTicker<TPrice, TQuantity> ticker) noexcept {
+            Type = UpdateType::BBO;
+            Ticker = ticker;
+        }
+
+        // Copy up to PriceLevels bids and asks from the given ranges, the rest of levels is dropped.
+        void SetDepth(auto&& bids, auto&& asks) noexcept {
+            Type = UpdateType::Depth;
+            BidsCount = CopyLevels(bids, Bids);
+            AsksCount = CopyLevels(asks, Asks);
+        }
+
+    private:
+        static std::uint16_t CopyLevels(auto&& levels, std::array<TPriceQuantity, PriceLevels>& destination) noexcept {
+            std::uint16_t count = 0;
+
+            for (auto&& level : levels) {
+                if (count == PriceLevels) {
+                    break;
+                }
+
+                destination[count++] = level;
+            }
+
+            return count;
+        }
+    };
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <charconv>
+#include <compare>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <string_view>
+
+#include "../utils/decimal.h"
+
+namespace OrderBook::Models {
+
+    /*
+     * A decimal fixed-point number stored as an integer count of 10^-Decimals units.
+     * For prices the unit is a tick, for quantities it is a lot, and the scale is the per-symbol
+     * precision published by the exchange (e.g. 2 decimals for BTCUSDT prices and 8 for quantities).
+     *
+     * All comparisons are plain int64_t comparisons, so the book never depends on exact float equality
+     * and flat_map lookups are integer compares end to end.
+     * TTag prevents mixing up prices and quantities that happen to share the same scale.
+    */
+    template <typename TTag, unsigned Decimals>
+    class FixedPoint {
+        static_assert(Decimals <= Utils::MaxDecimalDigits, "Scale doesn't fit into int64_t");
+
+    public:
+        using TRepresentation = std::int64_t;
+
+        static constexpr unsigned Scale = Decimals;
+        static constexpr TRepresentation Multiplier = Utils::Pow10(Decimals);
+
+    private:
+        TRepresentation Value_{};
+
+        constexpr explicit FixedPoint(TRepresentation value) noexcept : Value_(value) {
+        }
+
+    public:
+        constexpr FixedPoint() noexcept = default;
+
+        // Create a value from the raw number of ticks/lots.
+        static constexpr FixedPoint FromRaw(TRepresentation value) noexcept {
+            return FixedPoint(value);
+        }
+
+        // Create a value from a floating-point number rounding it to the closest tick/lot.
+        static FixedPoint FromDouble(double value) noexcept {
+            return FixedPoint(std::llround(value * static_cast<double>(Multiplier)));
+        }
+
+        // Parse a decimal string (as sent by the exchange) without going through a floating-point value.
+        static constexpr std::optional<FixedPoint> Parse(std::string_view text) noexcept {
+            if (auto value = Utils::ParseDecimal(text, Decimals)) [[likely]] {
+                return FixedPoint(*value);
+            }
+
+            return std::nullopt;
+        }
+
+        [[nodiscard]]
+        constexpr TRepresentation Raw() const noexcept {
+            return Value_;
+        }
+
+        [[nodiscard]]
+        constexpr double ToDouble() const noexcept {
+            return static_cast<double>(Value_) / static_cast<double>(Multiplier);
+        }
+
+        constexpr auto operator<=>(const FixedPoint&) const noexcept = default;
+
+        constexpr FixedPoint operator+(FixedPoint rhs) const noexcept {
+            return FixedPoint(Value_ + rhs.Value_);
+        }
+
+        constexpr FixedPoint operator-(FixedPoint rhs) const noexcept {
+            return FixedPoint(Value_ - rhs.Value_);
+        }
+
+        constexpr FixedPoint& operator+=(FixedPoint rhs) noexcept {
+            Value_ += rhs.Value_;
+            return *this;
+        }
+
+        constexpr FixedPoint& operator-=(FixedPoint rhs) noexcept {
+            Value_ -= rhs.Value_;
+            return *this;
+        }
+    };
+
+    struct PriceTag {};
+    struct QuantityTag {};
+
+    // Price in ticks of 10^-Decimals.
+    template <unsigned Decimals>
+    using Price = FixedPoint<PriceTag, Decimals>;
+
+    // Quantity in lots of 10^-Decimals.
+    template <unsigned Decimals>
+    using Quantity = FixedPoint<QuantityTag, Decimals>;
+
+    // Write the exact decimal representation, e.g. "20078.54", in the manner of std::to_chars.
+    template <typename TTag, unsigned Decimals>
+    std::to_chars_result ToChars(char* first, char* last, FixedPoint<TTag, Decimals> value) noexcept {
+        using TFixedPoint = FixedPoint<TTag, Decimals>;
+
+        const auto raw = value.Raw();
+        const auto absolute = raw < 0 ? -static_cast<std::uint64_t>(raw) : static_cast<std::uint64_t>(raw);
+        const auto multiplier = static_cast<std::uint64_t>(TFixedPoint::Multiplier);
+
+        if (raw < 0) {
+            if (first == last) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            *first++ = '-';
+        }
+
+        auto result = std::to_chars(first, last, absolute / multiplier);
+
+        if constexpr (Decimals > 0) {
+            if (result.ec != std::errc() || last - result.ptr < static_cast<std::ptrdiff_t>(Decimals + 1)) [[unlikely]] {
+                return {last, std::errc::value_too_large};
+            }
+
+            *result.ptr = '.';
+
+            auto remainder = absolute % multiplier;
+            for (int i = Decimals; i > 0; --i, remainder /= 10) {
+                result.ptr[i] = static_cast<char>('0' + remainder % 10);
+            }
+
+            result.ptr += Decimals + 1;
+        }
+
+        return result;
+    }
+
+    // Print the exact decimal representation, e.g. "20078.54".
+    template <typename TTag, unsigned Decimals>
+    std::ostream& operator<<(std::ostream& out, FixedPoint<TTag, Decimals> value) {
+        // Sign, up to 19 digits of int64_t and the decimal point.
+        char buffer[Utils::MaxDecimalDigits + 3] = {};
+        const auto [end, error] = ToChars(std::begin(buffer), std::end(buffer), value);
+
+        return out.write(buffer, end - buffer);
+    }
+
+}
@@ -0,0 +1 @@
+#include "top_of_book.h"
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "price_quantity.h"
+
+namespace OrderBook::Models {
+
+    // A compact copy of the top Levels of the book, best bid and best ask are the first levels of each side.
+    template <typename TPrice, typename TQuantity, std::size_t Levels = 20>
+    struct TopOfBook {
+        using TPriceQuantity = PriceQuantity<TPrice, TQuantity>;
+
+        std::uint16_t BidsCount{};
+        std::uint16_t AsksCount{};
+        std::array<TPriceQuantity, Levels> Bids;
+        std::array<TPriceQuantity, Levels> Asks;
+
+        [[nodiscard]]
+        bool IsEmpty() const noexcept {
+            return BidsCount == 0 && AsksCount == 0;
+        }
+
+        [[nodiscard]]
+        const TPriceQuantity* BestBid() const noexcept {
+            return BidsCount != 0 ? &Bids[0] : nullptr;
+        }
+
+        [[nodiscard]]
+        const TPriceQuantity* BestAsk() const noexcept {
+            return AsksCount != 0 ? &Asks[0] : nullptr;
+        }
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetBids() const noexcept {
+            return {Bids.data(), BidsCount};
+        }
+
+        [[nodiscard]]
+        std::span<const TPriceQuantity> GetAsks() const noexcept {
+            return {Asks.data(), AsksCount};
+        }
+    };
+
+}
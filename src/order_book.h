@@ -1,39 +1,69 @@
 #pragma once
 
+#include <algorithm>
 #include <iterator>
+#include <span>
 #include <vector>
+#include <ostream>
 #include <ranges>
-#include <sstream>
-
-#include <boost/format.hpp>
+#include <string>
+#include <system_error>
 
+#include "analytics.h"
+#include "book_formatter.h"
+#include "instrumentation.h"
+#include "level_events.h"
 #include "utils/generator.h"
 #include "order_map.h"
+#include "models/book_state.h"
 #include "models/book_ticker.h"
 #include "models/price_quantity.h"
+#include "models/top_of_book.h"
+#include "utils/seq_lock.h"
 
 namespace OrderBook {
 
     /*
      * An order book for Binance or a similar protocol.
      * Receives updates in the form of bids and asks for top PriceLevels as well as best pure best bid/ask updates.
+     * TStorage selects the container keeping the price levels of each side (FlatMapStorage, SimdPriceLadder
+     * or TickLadderStorage<...>::Type).
+     * TInstrumentation selects whether latencies and events are recorded (DisabledInstrumentation
+     * or EnabledInstrumentation, see Statistics).
+     * TAnalytics selects whether derived values are maintained (DisabledAnalytics or EnabledAnalytics, see Analytics).
     */
-    template <typename TPrice = double , typename TQuantity = double, size_t PriceLevels = 20>
+    template <typename TPrice = double , typename TQuantity = double, size_t PriceLevels = 20,
+              template <typename, typename, typename, size_t> class TStorage = FlatMapStorage,
+              typename TInstrumentation = DisabledInstrumentation,
+              typename TAnalytics = DisabledAnalytics>
     class BinanceBook {
     private:
-        using TAsks = OrderMap<TPrice, TQuantity, std::less<>, PriceLevels>;
-        using TBids = OrderMap<TPrice, TQuantity, std::greater<>, PriceLevels>;
+        using TAsks = OrderMap<TPrice, TQuantity, std::less<>, PriceLevels, TStorage, TInstrumentation, TAnalytics>;
+        using TBids = OrderMap<TPrice, TQuantity, std::greater<>, PriceLevels, TStorage, TInstrumentation, TAnalytics>;
         using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
         using TBookTicker = Models::BookTicker<TPrice, TQuantity>;
 
+    public:
+        using TBidsView = typename TBids::TOrdersView;
+        using TAsksView = typename TAsks::TOrdersView;
+        using TSnapshot = Models::TopOfBook<TPrice, TQuantity, PriceLevels>;
+        using TSnapshotSlot = Utils::SeqLock<TSnapshot>;
+        // Sides keep up to PriceLevels + 1 orders, see OrderMap.
+        using TState = Models::BookState<TPrice, TQuantity, PriceLevels + 1>;
+        using TLevelEventBuffer = LevelEventBuffer<TPrice, TQuantity>;
+
+    private:
         TAsks Asks_; // Asks container
         TBids Bids_; // Bids container
+        TSnapshotSlot* SnapshotSlot_ = nullptr; // Where the top of the book is published, if publishing is enabled
+        [[no_unique_address]] mutable TInstrumentation Instrumentation_; // Latencies of operations
 
     public:
         // Clear the order book by removing all bids and asks.
         void Clear() noexcept {
             Bids_.Clear();
             Asks_.Clear();
+            Publish();
         }
 
         // Check if the order book is empty.
@@ -44,18 +74,27 @@ namespace OrderBook {
 
         // Replace the entire contents of the order book with new bids and asks.
         void Replace(InputRange<TPriceQuantity> auto&& bids, InputRange<TPriceQuantity> auto&& asks) noexcept {
-            Clear();
-            DepthUpdate(bids, asks);
+            [[maybe_unused]] const auto scope = Instrumentation_.Measure(BookOperation::Replace);
+
+            // The book is cleared without publishing, so readers never observe the intermediate empty book.
+            Bids_.ReplaceOrders(bids);
+            Asks_.ReplaceOrders(asks);
+            Publish();
         }
 
         // Update the order book with new bids and asks.
         void DepthUpdate(InputRange<TPriceQuantity> auto&& bids, InputRange<TPriceQuantity> auto&& asks) noexcept {
+            [[maybe_unused]] const auto scope = Instrumentation_.Measure(BookOperation::DepthUpdate);
+
             Bids_.UpdateOrders(bids);
             Asks_.UpdateOrders(asks);
+            Publish();
         }
 
         // Update the best bid and best ask in the order book based on the book ticker data.
         void BBOUpdate(TBookTicker ticker) {
+            [[maybe_unused]] const auto scope = Instrumentation_.Measure(BookOperation::BBOUpdate);
+
             Bids_.UpdateBestOrder({
                 .Price = ticker.BestBidPrice,
                 .Quantity = ticker.BestBidQty,
@@ -65,79 +104,166 @@ namespace OrderBook {
                 .Price = ticker.BestAskPrice,
                 .Quantity = ticker.BestAskQty,
             });
+
+            Publish();
+        }
+
+        // Start loading both sides into the cache, e.g. while another book is being updated (see UpdateBatch).
+        void Prefetch() const noexcept {
+            Bids_.Prefetch();
+            Asks_.Prefetch();
+        }
+
+        /*
+         * Enable level events: every change of the levels (see Levels) made by the following updates is appended
+         * to the buffer, so consumers learn what has changed without comparing copies of the book.
+         * Replace, RestoreState and Clear emit only the difference between the old and the new levels.
+         * Pass nullptr to disable the events. The buffer must outlive the book or the events must be disabled
+         * before the buffer is destroyed.
+        */
+        void EmitLevelEventsTo(TLevelEventBuffer* buffer) noexcept {
+            Bids_.EmitLevelEventsTo(buffer);
+            Asks_.EmitLevelEventsTo(buffer);
+        }
+
+        /*
+         * Enable publishing mode: after every change the top of the book is copied into the slot,
+         * where other threads can take consistent copies of it without blocking the owner of the book.
+         * The current state is published immediately. Pass nullptr to disable publishing.
+         * The slot must outlive the book or publishing must be disabled before the slot is destroyed.
+        */
+        void PublishTo(TSnapshotSlot* slot) noexcept {
+            SnapshotSlot_ = slot;
+            Publish();
         }
 
         // Retrieve the bids and asks from the order book as generators,
         // enabling lazy evaluation and avoiding unnecessary memory copies.
+        // Frames of the generators come from the FramePool of the thread, still prefer Levels or CopyTop on hot paths.
         [[nodiscard]]
         auto Extract() const -> std::pair<Utils::Generator<TPriceQuantity>, Utils::Generator<TPriceQuantity>> {
-            return std::make_pair(Bids_.Extract(), Asks_.Extract());
+            if constexpr (TInstrumentation::Enabled) {
+                return std::make_pair(MeasureTraversal(Bids_.Extract()), MeasureTraversal(Asks_.Extract()));
+            } else {
+                return std::make_pair(Bids_.Extract(), Asks_.Extract());
+            }
         }
 
-        // Convert the order book to a string representation.
+        // Views over the bids and asks in the book order, read in place without allocations.
+        // The views are invalidated by any update of the book.
         [[nodiscard]]
-        std::string ToString() const {
-            std::stringstream ss;
-            ss << *this;
+        std::pair<TBidsView, TAsksView> Levels() const {
+            return {Bids_.Levels(), Asks_.Levels()};
+        }
 
-            return ss.str();
+        // Copy the top bids and asks into the caller buffers in one pass.
+        // Returns the numbers of copied bids and asks, each side is limited by the size of its buffer.
+        std::pair<std::size_t, std::size_t> CopyTop(std::span<TPriceQuantity> bids,
+                                                    std::span<TPriceQuantity> asks) const noexcept {
+            return {Bids_.CopyTop(bids), Asks_.CopyTop(asks)};
         }
-    };
 
-    std::ostream& operator<<(std::ostream& out, const BinanceBook<>& book) {
-        if (book.IsEmpty()) {
-            out << "[]";
+        // Copy up to `levels` top levels of both sides into the fixed arrays of `destination`.
+        template <std::size_t SnapshotLevels>
+        void CopyTop(Models::TopOfBook<TPrice, TQuantity, SnapshotLevels>& destination,
+                     std::size_t levels = SnapshotLevels) const noexcept {
+            levels = std::min(levels, SnapshotLevels);
+
+            const auto [bidsCount, asksCount] = CopyTop(std::span(destination.Bids).first(levels),
+                                                        std::span(destination.Asks).first(levels));
+            destination.BidsCount = static_cast<std::uint16_t>(bidsCount);
+            destination.AsksCount = static_cast<std::uint16_t>(asksCount);
         }
 
-        auto [bids, asks] = book.Extract();
+        // Copy the complete state of the book, e.g. into a checkpoint (see Capture::CheckpointWriter).
+        void SaveState(TState& state) const noexcept {
+            state.BestBid = Bids_.BestOrder();
+            state.BestAsk = Asks_.BestOrder();
+            state.BidsCount = static_cast<std::uint16_t>(Bids_.CopyOrders(state.Bids));
+            state.AsksCount = static_cast<std::uint16_t>(Asks_.CopyOrders(state.Asks));
+        }
 
-        int index = 1;
-        auto bidIt = bids.begin();
-        auto askIt = asks.begin();
+        // Replace the contents of the book with a state taken by SaveState, the book becomes exactly the saved one.
+        void RestoreState(const TState& state) noexcept {
+            Bids_.Restore(state.BestBid, state.GetBids());
+            Asks_.Restore(state.BestAsk, state.GetAsks());
+            Publish();
+        }
 
-        {
-            boost::format formatter("[%2d] [%9s] %.3f | %.3f [%-9s]\n");
+        /*
+         * Latencies and event counts (of both sides) recorded since the book was created.
+         * Available only with EnabledInstrumentation. Can be called from any thread while the book is being updated,
+         * it only reads the counters (use StatisticsReader to reset them).
+        */
+        [[nodiscard]]
+        BookStatistics Statistics() const noexcept requires TInstrumentation::Enabled {
+            BookStatistics statistics;
+            Instrumentation_.AddTo(statistics);
+            Bids_.Events().AddTo(statistics);
+            Asks_.Events().AddTo(statistics);
 
-            // std::ranges::zip_view should be here
-            for (; bidIt != bids.end() && askIt != asks.end(); ++bidIt, ++askIt, ++index) {
-                out << formatter
-                       % index
-                       % (*bidIt).Quantity
-                       % (*bidIt).Price
-                       % (*askIt).Price
-                       % (*askIt).Quantity;
-            }
+            return statistics;
+        }
+
+        // Derived values of the book (mid, spread, microprice, imbalance, depth, VWAP to size), maintained
+        // by the sides on every update. Available only with EnabledAnalytics. The view follows the updates of the book.
+        [[nodiscard]]
+        auto Analytics() const noexcept requires TAnalytics::Enabled {
+            return BookAnalytics(Bids_.Analytics(), Asks_.Analytics());
         }
 
-        // in case, when we have more bids, than asks
-        {
-            boost::format formatter("[%2d] [%9s] %.3f | %9s [%9s]\n");
+        // Convert the order book to a string representation.
+        [[nodiscard]]
+        std::string ToString() const {
+            std::string result(FormattedLineSize * (PriceLevels + 1), '\0');
+
+            while (true) {
+                const auto [end, error] = FormatBook(result.data(), result.data() + result.size(), *this);
+                if (error == std::errc()) [[likely]] {
+                    result.resize(end - result.data());
+                    return result;
+                }
 
-            for (; bidIt != bids.end(); ++bidIt, ++index) {
-                out << formatter
-                       % index
-                       % (*bidIt).Quantity
-                       % (*bidIt).Price
-                       % ""
-                       % "";
+                result.resize(result.size() * 2);
             }
         }
 
-        // in case, when we have more asks, than bids
-        {
-            boost::format formatter("[%2d] [%9s] %9s | %.3f [%-9s]\n");
+    private:
+        // The generators are lazy, so the traversal of a side is measured from its first level to the end,
+        // or to the destruction of the generator if the caller stops early.
+        Utils::Generator<TPriceQuantity> MeasureTraversal(Utils::Generator<TPriceQuantity> levels) const {
+            [[maybe_unused]] const auto scope = Instrumentation_.Measure(BookOperation::Extract);
 
-            for (; askIt != asks.end(); ++askIt, ++index) {
-                out << formatter
-                       % index
-                       % ""
-                       % ""
-                       % (*askIt).Price
-                       % (*askIt).Quantity;
+            for (const auto& level : levels) {
+                co_yield level;
             }
         }
 
-        return out;
+        void Publish() noexcept {
+            if (SnapshotSlot_ == nullptr) [[likely]] {
+                return;
+            }
+
+            SnapshotSlot_->Update([this](TSnapshot& snapshot) {
+                CopyTop(snapshot);
+            });
+        }
+    };
+
+    template <typename TPrice, typename TQuantity, size_t PriceLevels,
+              template <typename, typename, typename, size_t> class TStorage,
+              typename TInstrumentation, typename TAnalytics>
+    std::ostream& operator<<(std::ostream& out,
+                             const BinanceBook<TPrice, TQuantity, PriceLevels, TStorage,
+                                               TInstrumentation, TAnalytics>& book) {
+        // The buffer is usually enough, otherwise fall back to the growing string.
+        char buffer[FormattedLineSize * (PriceLevels + 1)];
+
+        if (const auto [end, error] = FormatBook(std::begin(buffer), std::end(buffer), book); error == std::errc()) [[likely]] {
+            return out.write(buffer, end - buffer);
+        }
+
+        return out << book.ToString();
     }
 
 } // OrderBook
@@ -1,12 +1,26 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
 
 #include <boost/container/flat_map.hpp>
 
+#include "analytics.h"
+#include "instrumentation.h"
+#include "level_events.h"
 #include "models/price_quantity.h"
 #include "utils/generator.h"
 #include "stack_memory_allocator.h"
+#include "simd_price_ladder.h"
+#include "tick_ladder.h"
 
 namespace OrderBook {
 
@@ -16,57 +30,226 @@ namespace OrderBook {
         std::is_same_v<typename std::ranges::iterator_t<decltype(range)>::value_type, TValue>;
     };
 
-    template <typename TPrice, typename TQuantity, typename TKeyComparator, size_t PriceLevels>
+    /*
+     * We use a flat_map data structure provided by Boost, to store the orders in sorted order.
+     * This data structure is chosen because the number of values in the map is relatively small
+     * and can benefit from the performance boost of cache locality.
+     * The flat_map implementation stores the key-value pairs in a contiguous memory block, resulting
+     * in improved cache locality and potentially faster lookup and iteration compared to other map
+     * implementations.
+     *
+     * To optimize memory allocation and improve performance, flat_map utilizes a custom StackMemoryAllocator.
+     * This allocator allows preallocating the required memory on the stack based on the maximum number
+     * of elements in the map (Capacity).
+    */
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, size_t Capacity>
+    using FlatMapStorage = boost::container::flat_map<TPrice, TQuantity,
+                                                      TKeyComparator,
+                                                      StackMemoryAllocator<std::pair<TPrice, TQuantity>, Capacity>>;
+
+    /*
+     * A non-owning view over the levels of one side of the book: the best order followed by the stored orders
+     * under it, in the book order. Iteration reads the levels in place and yields them by value, so unlike
+     * Extract it never allocates. The view is invalidated by any update of the book.
+    */
+    template <typename TPrice, typename TQuantity, typename TOrdersIterator>
+    class OrdersView {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        class Iterator {
+        public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type = TPriceQuantity;
+            using difference_type = std::ptrdiff_t;
+            using reference = TPriceQuantity;
+
+        private:
+            const TPriceQuantity* Best_ = nullptr; // set while the iterator points to the best order
+            TOrdersIterator Order_{};
+
+        public:
+            Iterator() = default;
+
+            Iterator(const TPriceQuantity* best, TOrdersIterator order) : Best_(best), Order_(order) {
+            }
+
+            reference operator*() const {
+                if (Best_ != nullptr) {
+                    return *Best_;
+                }
+
+                return {
+                    .Price = Order_->first,
+                    .Quantity = Order_->second,
+                };
+            }
+
+            Iterator& operator++() {
+                if (Best_ != nullptr) {
+                    Best_ = nullptr;
+                } else {
+                    ++Order_;
+                }
+
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            bool operator==(const Iterator& rhs) const {
+                return Best_ == rhs.Best_ && Order_ == rhs.Order_;
+            }
+        };
+
+        const TPriceQuantity* Best_ = nullptr; // nullptr for an empty side
+        TOrdersIterator First_{};              // the first order under the best one
+        TOrdersIterator Last_{};
+        std::size_t Size_ = 0;
+
+    public:
+        OrdersView() = default;
+
+        OrdersView(const TPriceQuantity* best, TOrdersIterator first, TOrdersIterator last, std::size_t size)
+            : Best_(best), First_(first), Last_(last), Size_(size) {
+        }
+
+        [[nodiscard]]
+        Iterator begin() const {
+            return {Best_, First_};
+        }
+
+        [[nodiscard]]
+        Iterator end() const {
+            return {nullptr, Last_};
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return Size_ == 0;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const {
+            return Size_;
+        }
+
+        // The best order, the view must not be empty.
+        [[nodiscard]]
+        const TPriceQuantity& front() const {
+            return *Best_;
+        }
+    };
+
+    /*
+     * Keeps the top PriceLevels orders of one side of the book.
+     * TStorage is the sorted container used to store the orders, it should provide the subset of the flat_map interface
+     * used below (see FlatMapStorage, SimdPriceLadder and TickLadder).
+     * TInstrumentation selects whether notable events of the side are counted (see instrumentation.h).
+     * TAnalytics selects whether running sums of the side are maintained along with the orders (see analytics.h).
+    */
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, size_t PriceLevels,
+              template <typename, typename, typename, size_t> class TStorage = FlatMapStorage,
+              typename TInstrumentation = DisabledInstrumentation,
+              typename TAnalytics = DisabledAnalytics>
     class OrderMap {
     private:
         using TBestOrder = Models::PriceQuantity<TPrice, TQuantity>;
 
-        /*
-         * We use a flat_map data structure provided by Boost, to store the orders in sorted order.
-         * This data structure is chosen because the number of values in the map is relatively small
-         * and can benefit from the performance boost of cache locality.
-         * The flat_map implementation stores the key-value pairs in a contiguous memory block, resulting
-         * in improved cache locality and potentially faster lookup and iteration compared to other map
-         * implementations.
-         *
-         * To optimize memory allocation and improve performance, flat_map utilizes a custom StackMemoryAllocator.
-         * This allocator allows preallocating the required memory on the stack based on the maximum number
-         * of elements in the map, which is PriceLevels + 1. The additional 1 is reserved for the scenario
-         * when the best order is updated and becomes better than all other existing records in the map.
-        */
-        using TOrdersMap = boost::container::flat_map<TPrice, TQuantity,
-                                                      TKeyComparator,
-                                                      StackMemoryAllocator<std::pair<TPrice, TQuantity>, PriceLevels + 1>>;
+        // The storage is preallocated for PriceLevels + 1 orders. The additional 1 is reserved for the scenario
+        // when the best order is updated and becomes better than all other existing records in the map.
+        using TOrdersMap = TStorage<TPrice, TQuantity, TKeyComparator, PriceLevels + 1>;
+
+    public:
+        using TOrdersView = OrdersView<TPrice, TQuantity, typename TOrdersMap::const_iterator>;
+        using TLevelEventBuffer = LevelEventBuffer<TPrice, TQuantity>;
+
+    private:
+        static constexpr BookSide Side = std::is_same_v<TKeyComparator, std::greater<>> ? BookSide::Bids : BookSide::Asks;
+
+        // What Levels shows: the best order and whether there are any orders at all.
+        struct VisibleState {
+            TBestOrder Best;
+            bool Empty;
+        };
+
+        // An order whose stored quantity was changed by an update, 0 stands for no order.
+        struct ChangedOrder {
+            TPrice Price;
+            TQuantity Before;
+            TQuantity After;
+        };
 
         TBestOrder BestOrder_;
         TOrdersMap Orders_;
         TKeyComparator Comparator;
+        [[no_unique_address]] typename TInstrumentation::TEventCounters Events_;
+        [[no_unique_address]] typename TAnalytics::template TSide<TPrice, TKeyComparator, PriceLevels + 1> Analytics_;
+        TLevelEventBuffer* LevelEvents_ = nullptr; // Where level events are appended, if they are enabled
 
     public:
+        OrderMap() {
+            // Reserve the whole preallocated block at once. Otherwise flat_map grows by "reallocating" into the same
+            // block provided by StackMemoryAllocator, and moving orders around within it corrupts their order.
+            if constexpr (requires { Orders_.reserve(PriceLevels + 1); }) {
+                Orders_.reserve(PriceLevels + 1);
+            }
+        }
+
         [[nodiscard]]
         bool IsEmpty() const {
             return Orders_.empty();
         }
 
         void Clear() {
-            Orders_.clear();
+            if (LevelEvents_ != nullptr) [[unlikely]] {
+                ChangeWithDiff([this]() { ClearOrders(); });
+                return;
+            }
+
+            ClearOrders();
         }
 
-        void UpdateBestOrder(Models::PriceQuantity<TPrice, TQuantity> update) {
-            BestOrder_ = update;
+        // Append the changes of the levels of the side to the buffer (see LevelEvent), nullptr disables them.
+        void EmitLevelEventsTo(TLevelEventBuffer* buffer) noexcept {
+            LevelEvents_ = buffer;
+        }
 
-            // In case of receiving BBO (Best Bid/Offer) update before Depth Update,
-            // add the update as the first entry to ensure the map is not empty.
-            if (IsEmpty()) [[unlikely]] {
-                Orders_.emplace(update.Price, update.Quantity);
+        void UpdateBestOrder(Models::PriceQuantity<TPrice, TQuantity> update) {
+            if (LevelEvents_ == nullptr) [[likely]] {
+                SetBestOrder(update);
+                return;
             }
+
+            const auto before = Visible();
+            SetBestOrder(update);
+            EmitChanges(before, {});
         }
 
         auto UpdateOrders(InputRange<Models::PriceQuantity<TPrice, TQuantity>> auto&& updates) {
-            std::optional<typename TOrdersMap::const_iterator> hint;
+            if (LevelEvents_ == nullptr) [[likely]] {
+                ApplyUpdates<false>(updates);
+            } else {
+                ApplyUpdates<true>(updates);
+            }
+        }
 
-            for (auto&& update : updates) {
-                hint = UpdateOrder(update, hint);
+        // Replace all orders of the side. Level events describe the difference between the old and the new levels,
+        // rather than the removal of all levels followed by the new ones.
+        void ReplaceOrders(InputRange<Models::PriceQuantity<TPrice, TQuantity>> auto&& updates) {
+            auto replace = [&]() {
+                ClearOrders();
+                ApplyUpdates<false>(updates);
+            };
+
+            if (LevelEvents_ != nullptr) [[unlikely]] {
+                ChangeWithDiff(replace);
+            } else {
+                replace();
             }
         }
 
@@ -90,11 +273,330 @@ namespace OrderBook {
             }
         }
 
+        // Hint the CPU to start loading the side into the cache ahead of an update.
+        // Only the object itself is prefetched (the storage of FlatMapStorage and SimdPriceLadder is inline),
+        // up to MaxPrefetchLines cache lines from the beginning, where the best levels are.
+        void Prefetch() const noexcept {
+            constexpr std::size_t CacheLineSize = 64;
+            constexpr std::size_t MaxPrefetchLines = 16;
+            constexpr std::size_t Lines = std::min((sizeof(*this) + CacheLineSize - 1) / CacheLineSize, MaxPrefetchLines);
+
+            const auto* address = reinterpret_cast<const char*>(this);
+            for (std::size_t line = 0; line < Lines; ++line) {
+                __builtin_prefetch(address + line * CacheLineSize, 1);
+            }
+        }
+
+        // Event counters of the side, available only with EnabledInstrumentation.
+        [[nodiscard]]
+        const auto& Events() const noexcept requires TInstrumentation::Enabled {
+            return Events_;
+        }
+
+        // Running sums of the side, available only with EnabledAnalytics (see BookAnalytics).
+        [[nodiscard]]
+        const auto& Analytics() const noexcept requires TAnalytics::Enabled {
+            return Analytics_;
+        }
+
+        // View over the best order and the orders under it, the allocation-free alternative to Extract.
+        [[nodiscard]]
+        TOrdersView Levels() const {
+            if (IsEmpty()) {
+                return {};
+            }
+
+            const auto first = FirstUnderBest();
+            return {&BestOrder_, first, Orders_.end(), 1 + static_cast<std::size_t>(std::distance(first, Orders_.end()))};
+        }
+
+        // Copy the best order followed by the orders under it into `destination` until it is full.
+        // Returns the number of copied orders.
+        std::size_t CopyTop(std::span<Models::PriceQuantity<TPrice, TQuantity>> destination) const {
+            if (IsEmpty() || destination.empty()) {
+                return 0;
+            }
+
+            std::size_t count = 0;
+            destination[count++] = BestOrder_;
+
+            for (auto it = FirstUnderBest(); it != Orders_.end() && count != destination.size(); ++it) {
+                destination[count++] = {
+                    .Price = it->first,
+                    .Quantity = it->second,
+                };
+            }
+
+            return count;
+        }
+
+        // The best order, meaningful only if the side is not empty.
+        [[nodiscard]]
+        const TBestOrder& BestOrder() const noexcept {
+            return BestOrder_;
+        }
+
+        // Copy all stored orders as they are, including those above the best order, until `destination` is full.
+        // Returns the number of copied orders. Together with BestOrder it is the whole state of the side.
+        std::size_t CopyOrders(std::span<Models::PriceQuantity<TPrice, TQuantity>> destination) const {
+            std::size_t count = 0;
+            for (auto it = Orders_.begin(); it != Orders_.end() && count != destination.size(); ++it) {
+                destination[count++] = {
+                    .Price = it->first,
+                    .Quantity = it->second,
+                };
+            }
+
+            return count;
+        }
+
+        // Replace the state of the side with the one taken by BestOrder and CopyOrders.
+        void Restore(TBestOrder best, std::span<const Models::PriceQuantity<TPrice, TQuantity>> orders) {
+            auto restore = [&]() {
+                Orders_.clear();
+
+                // Orders come in the book order, so each one is appended at the end.
+                for (const auto& order : orders) {
+                    Orders_.try_emplace(Orders_.end(), order.Price, order.Quantity);
+                }
+
+                BestOrder_ = best;
+                Analytics_.Rebuild(best.Price, Details::ToDouble(best.Quantity), Orders_);
+            };
+
+            if (LevelEvents_ != nullptr) [[unlikely]] {
+                ChangeWithDiff(restore);
+            } else {
+                restore();
+            }
+        }
+
     private:
+        void ClearOrders() {
+            Orders_.clear();
+            Analytics_.Clear();
+        }
+
+        void SetBestOrder(Models::PriceQuantity<TPrice, TQuantity> update) {
+            if (IsEmpty() || BestOrder_.Price != update.Price) {
+                Events_.Increment(BookEvent::BestLevelChanged);
+            }
+
+            BestOrder_ = update;
+            Analytics_.SetBest(update.Price, Details::ToDouble(update.Quantity));
+
+            // In case of receiving BBO (Best Bid/Offer) update before Depth Update,
+            // add the update as the first entry to ensure the map is not empty.
+            if (IsEmpty()) [[unlikely]] {
+                Events_.Increment(BookEvent::BBOOnEmptyBook);
+                Orders_.emplace(update.Price, update.Quantity);
+                Analytics_.Set(update.Price, Details::ToDouble(update.Quantity));
+            }
+        }
+
+        template <bool EmitEvents>
+        void ApplyUpdates(auto&& updates) {
+            std::optional<typename TOrdersMap::const_iterator> hint;
+
+            for (auto&& update : updates) {
+                hint = UpdateOrder<EmitEvents>(update, hint);
+            }
+        }
+
+        [[nodiscard]]
+        VisibleState Visible() const noexcept {
+            return {BestOrder_, IsEmpty()};
+        }
+
+        // Quantity at the price as shown by Levels in the given state, `stored` is the quantity kept in the storage.
+        // Orders above the best one are hidden, the best one shows the quantity of the best order.
+        [[nodiscard]]
+        TQuantity VisibleQuantity(const VisibleState& state, const TPrice& price, TQuantity stored) const {
+            if (state.Empty || Comparator(price, state.Best.Price)) {
+                return {};
+            }
+
+            return Comparator(state.Best.Price, price) ? stored : state.Best.Quantity;
+        }
+
+        void EmitLevel(const TPrice& price, TQuantity before, TQuantity after) {
+            if (before == after) {
+                return;
+            }
+
+            LevelEvents_->Push({
+                .Price = price,
+                .OldQuantity = before,
+                .NewQuantity = after,
+                .Type = before == TQuantity{} ? LevelEventType::Add
+                        : after == TQuantity{} ? LevelEventType::Delete
+                                               : LevelEventType::Modify,
+                .Side = Side,
+            });
+        }
+
+        void EmitBestChanged(const VisibleState& before, const VisibleState& after) {
+            if (before.Empty == after.Empty && (after.Empty || before.Best.Price == after.Best.Price)) {
+                return;
+            }
+
+            LevelEvents_->Push({
+                .Price = after.Empty ? TPrice{} : after.Best.Price,
+                .OldQuantity = before.Empty ? TQuantity{} : before.Best.Quantity,
+                .NewQuantity = after.Empty ? TQuantity{} : after.Best.Quantity,
+                .Type = LevelEventType::BestChanged,
+                .Side = Side,
+            });
+        }
+
+        /*
+         * Emit the events of a change given the visible state before it and the orders whose stored quantities
+         * were changed. Other stored orders keep their quantities, so they change only if the best order
+         * has moved: the ones between the previous and the current best price are revealed or hidden.
+        */
+        void EmitChanges(const VisibleState& before, std::initializer_list<ChangedOrder> changed) {
+            const auto after = Visible();
+
+            // Most updates leave the best order as it is, then only the changed orders under it can change.
+            if (before.Empty == after.Empty && (after.Empty || (before.Best.Price == after.Best.Price
+                                                                && before.Best.Quantity == after.Best.Quantity))) [[likely]] {
+                for (const auto& order : changed) {
+                    if (!after.Empty && Comparator(after.Best.Price, order.Price)) {
+                        EmitLevel(order.Price, order.Before, order.After);
+                    }
+                }
+                return;
+            }
+
+            auto isChanged = [&](const TPrice& price) {
+                return std::any_of(changed.begin(), changed.end(), [&](const auto& order) { return order.Price == price; });
+            };
+
+            for (const auto& order : changed) {
+                EmitLevel(order.Price, VisibleQuantity(before, order.Price, order.Before),
+                          VisibleQuantity(after, order.Price, order.After));
+            }
+
+            if (before.Empty && after.Empty) {
+                return;
+            }
+
+            if (!before.Empty && !after.Empty && before.Best.Price == after.Best.Price) {
+                // The best order stays, only its quantity may change.
+                if (!isChanged(after.Best.Price)) {
+                    EmitLevel(after.Best.Price, before.Best.Quantity, after.Best.Quantity);
+                }
+                return;
+            }
+
+            // The range between the previous and the current best price, a single price if the side was or became empty.
+            TPrice first = before.Empty ? after.Best.Price : before.Best.Price;
+            TPrice last = after.Empty ? before.Best.Price : after.Best.Price;
+            if (Comparator(last, first)) {
+                std::swap(first, last);
+            }
+
+            // Both ends of the range are visited if they are stored, so no separate lookups are needed for them.
+            bool beforeStored = false;
+            bool afterStored = false;
+            for (auto it = Orders_.lower_bound(first); it != Orders_.end() && !Comparator(last, it->first); ++it) {
+                beforeStored |= !before.Empty && it->first == before.Best.Price;
+                afterStored |= !after.Empty && it->first == after.Best.Price;
+
+                if (!isChanged(it->first)) {
+                    EmitLevel(it->first, VisibleQuantity(before, it->first, it->second),
+                              VisibleQuantity(after, it->first, it->second));
+                }
+            }
+
+            // The previous and the current best price may have no stored order (BBO updates).
+            auto emitUnstored = [&](const TPrice& price) {
+                if (!isChanged(price)) {
+                    EmitLevel(price, VisibleQuantity(before, price, {}), VisibleQuantity(after, price, {}));
+                }
+            };
+
+            if (!before.Empty && !beforeStored) {
+                emitUnstored(before.Best.Price);
+            }
+            if (!after.Empty && !afterStored) {
+                emitUnstored(after.Best.Price);
+            }
+
+            EmitBestChanged(before, after);
+        }
+
+        // Emit the events of an arbitrary change of the side by comparing the levels before and after it.
+        template <typename TChange>
+        void ChangeWithDiff(TChange&& change) {
+            // Up to PriceLevels + 1 stored orders under the best one.
+            std::array<TBestOrder, PriceLevels + 2> levels;
+            const std::size_t count = CopyTop(levels);
+            const auto before = Visible();
+
+            change();
+
+            const auto view = Levels();
+            auto it = view.begin();
+            std::size_t index = 0;
+
+            while (index != count || it != view.end()) {
+                if (it == view.end() || (index != count && Comparator(levels[index].Price, (*it).Price))) {
+                    EmitLevel(levels[index].Price, levels[index].Quantity, TQuantity{});
+                    ++index;
+                } else if (index == count || Comparator((*it).Price, levels[index].Price)) {
+                    EmitLevel((*it).Price, TQuantity{}, (*it).Quantity);
+                    ++it;
+                } else {
+                    EmitLevel((*it).Price, levels[index].Quantity, (*it).Quantity);
+                    ++index;
+                    ++it;
+                }
+            }
+
+            EmitBestChanged(before, Visible());
+        }
+
+        // Orders are sorted, so the orders under the best one are the tail of the map.
+        typename TOrdersMap::const_iterator FirstUnderBest() const {
+            auto it = Orders_.begin();
+            if (it == Orders_.end() || Comparator(BestOrder_.Price, it->first)) {
+                return it;
+            }
+
+            // Usually the first order is the best one, unless a BBO update has moved the best price down the book.
+            if (Comparator(it->first, BestOrder_.Price)) [[unlikely]] {
+                it = Orders_.lower_bound(BestOrder_.Price);
+            }
+
+            if (it != Orders_.end() && !Comparator(BestOrder_.Price, it->first)) {
+                ++it;
+            }
+
+            return it;
+        }
+
+        /*
+         * Insert, update or remove the order. With EmitEvents the level events of the update are derived from
+         * what the update finds out anyway: whether the order existed and its previous quantity, and the order
+         * evicted to make room for it. These are the only stored orders which change, the others can only be
+         * hidden or revealed by a move of the best order, see EmitChanges.
+        */
+        template <bool EmitEvents = false>
         auto UpdateOrder(Models::PriceQuantity<TPrice, TQuantity> update,
                          std::optional<typename TOrdersMap::const_iterator> hint = std::nullopt) {
+            [[maybe_unused]] VisibleState before{};
+            if constexpr (EmitEvents) {
+                before = Visible();
+            }
+
             // If the quantity of the update is greater than zero, insert or update the order.
-            if (update.Quantity > 0) {
+            if (update.Quantity > TQuantity{}) {
+                [[maybe_unused]] const std::size_t sizeBefore = Orders_.size();
+                // A new first order may make the storage drop orders (see TickLadder), so whether the first order
+                // is new is told by its price rather than by the size.
+                [[maybe_unused]] const bool wasFirst = EmitEvents && !IsEmpty() && Orders_.begin()->first == update.Price;
+
                 // Try to insert the update at the hinted position if available,
                 // which is the position of the last insertion or removal.
                 // This improves performance by avoiding unnecessary lookups from the beginning of the map.
@@ -102,9 +604,30 @@ namespace OrderBook {
                           ? Orders_.try_emplace(hint.value(), update.Price, update.Quantity)
                           : Orders_.try_emplace(update.Price, update.Quantity).first;
 
+                // A storage with a limited price range (see TickLadder) refuses levels which are too deep to fit.
+                if (it == Orders_.end()) [[unlikely]] {
+                    Events_.Increment(BookEvent::Eviction);
+                    return it;
+                }
+
                 // If the inserted order becomes the first order in the map (has best price), update the best order.
                 if (it == Orders_.begin()) {
+                    if (BestOrder_.Price != update.Price || Orders_.size() == 1) {
+                        Events_.Increment(BookEvent::BestLevelChanged);
+                    }
+
                     BestOrder_ = update;
+                    Analytics_.SetBest(update.Price, Details::ToDouble(update.Quantity));
+                }
+
+                Analytics_.Set(update.Price, Details::ToDouble(update.Quantity));
+
+                [[maybe_unused]] bool inserted = false;
+                [[maybe_unused]] TQuantity storedBefore{};
+                [[maybe_unused]] std::optional<TBestOrder> evicted;
+                if constexpr (EmitEvents) {
+                    inserted = it == Orders_.begin() ? !wasFirst : Orders_.size() != sizeBefore;
+                    storedBefore = inserted ? TQuantity{} : it->second;
                 }
 
                 // Insertion has an effect only if there is no order with the same price yet.
@@ -124,26 +647,62 @@ namespace OrderBook {
                 // which helps to keep the `flat_map` small and avoid potential performance slowdowns.
                 // After removing the last order, update the iterator to point to the first order in the map.
                 else if (Orders_.size() > PriceLevels) {
-                    Orders_.erase(std::prev(Orders_.end()));
+                    Events_.Increment(BookEvent::Eviction);
+                    const auto worst = std::prev(Orders_.end());
+                    if constexpr (EmitEvents) {
+                        evicted = TBestOrder{worst->first, worst->second};
+                    }
+
+                    Orders_.erase(worst);
+                    Analytics_.EraseWorst();
                     it = Orders_.begin();
                 }
 
+                Analytics_.Follow(BestOrder_.Price, Details::ToDouble(BestOrder_.Quantity), Orders_);
+
+                if constexpr (EmitEvents) {
+                    if (Orders_.size() != sizeBefore + inserted - evicted.has_value()) [[unlikely]] {
+                        // The storage has dropped orders on its own (TickLadder moving its window).
+                        LevelEvents_->RequestResync();
+                    }
+
+                    if (!evicted.has_value()) [[likely]] {
+                        EmitChanges(before, {ChangedOrder{update.Price, storedBefore, update.Quantity}});
+                    } else if (evicted->Price == update.Price) {
+                        // The updated order itself went beyond the worst one.
+                        EmitChanges(before, {ChangedOrder{update.Price, storedBefore, TQuantity{}}});
+                    } else {
+                        EmitChanges(before, {
+                            ChangedOrder{update.Price, storedBefore, update.Quantity},
+                            ChangedOrder{evicted->Price, evicted->Quantity, TQuantity{}},
+                        });
+                    }
+                }
+
                 return it;
             }
             // If the quantity of the update is zero or less, remove the order with the given price.
             else {
                 auto it = Orders_.lower_bound(update.Price);
                 if (it != Orders_.end() && it->first == update.Price) {
+                    [[maybe_unused]] const TQuantity storedBefore = it->second;
                     it = Orders_.erase(it); // get next item after deleted
+                    Analytics_.Erase(update.Price);
 
                     // If the deleted order was the best order and the map is not empty,
                     // update the best order to the new first order.
                     if (update.Price == BestOrder_.Price && !IsEmpty()) {
-                        UpdateBestOrder({
+                        SetBestOrder({
                             .Price = Orders_.begin()->first,
                             .Quantity = Orders_.begin()->second,
                         });
                     }
+
+                    if constexpr (EmitEvents) {
+                        EmitChanges(before, {ChangedOrder{update.Price, storedBefore, TQuantity{}}});
+                    }
+                } else {
+                    Events_.Increment(BookEvent::IgnoredZeroQuantity);
                 }
 
                 return it;
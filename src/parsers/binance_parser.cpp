@@ -0,0 +1 @@
+#include "binance_parser.h"
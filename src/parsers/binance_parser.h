@@ -0,0 +1,388 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+#include "../models/book_ticker.h"
+#include "../models/price_quantity.h"
+#include "../utils/decimal.h"
+
+namespace OrderBook::Parsers {
+
+    namespace Details {
+
+        inline const char* SkipWhitespace(const char* it, const char* end) noexcept {
+            while (it != end && (*it == ' ' || *it == '\n' || *it == '\r' || *it == '\t')) {
+                ++it;
+            }
+
+            return it;
+        }
+
+        // Find the value of the given key (the key is passed together with quotes, e.g. "\"bids\"").
+        // Returns a pointer to the first non-whitespace character after ':' or nullptr.
+        inline const char* FindValue(std::string_view payload, std::string_view quotedKey, std::size_t from = 0) noexcept {
+            const auto position = payload.find(quotedKey, from);
+            if (position == std::string_view::npos) [[unlikely]] {
+                return nullptr;
+            }
+
+            const char* const end = payload.data() + payload.size();
+            const char* it = SkipWhitespace(payload.data() + position + quotedKey.size(), end);
+            if (it == end || *it != ':') [[unlikely]] {
+                return nullptr;
+            }
+
+            it = SkipWhitespace(it + 1, end);
+            return it != end ? it : nullptr;
+        }
+
+        // Read a quoted string value starting at `it` (pointing to the opening quote).
+        // On success returns the contents without quotes and moves `it` past the closing quote.
+        inline std::optional<std::string_view> ReadString(const char*& it, const char* end) noexcept {
+            if (it == end || *it != '"') [[unlikely]] {
+                return std::nullopt;
+            }
+
+            const char* const begin = it + 1;
+            const auto* const close = static_cast<const char*>(std::memchr(begin, '"', end - begin));
+            if (close == nullptr) [[unlikely]] {
+                return std::nullopt;
+            }
+
+            it = close + 1;
+            return std::string_view(begin, close - begin);
+        }
+
+        inline std::optional<std::uint64_t> ReadUnsigned(const char* it, const char* end) noexcept {
+            const char* digitsEnd = it;
+            while (digitsEnd != end && *digitsEnd >= '0' && *digitsEnd <= '9') {
+                ++digitsEnd;
+            }
+
+            return Utils::FromDecimal<std::uint64_t>(std::string_view(it, digitsEnd - it));
+        }
+
+    }
+
+    /*
+     * A view over a JSON array of price levels in the Binance format: [["20078.54000000","0.00431000"],...].
+     * The levels are converted lazily while the view is iterated, directly from the original buffer,
+     * so the view can be passed straight into BinanceBook::DepthUpdate without any copies.
+     *
+     * The view doesn't own the payload, the buffer must outlive it.
+     * Views returned by ParseDepth and ParseDiffDepth are validated (see IsValid), so they yield every level
+     * of the array. Iterating an invalid view stops at the first malformed level.
+    */
+    template <typename TPrice, typename TQuantity>
+    class LevelsView {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        struct Sentinel {};
+
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = TPriceQuantity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const TPriceQuantity*;
+            using reference = const TPriceQuantity&;
+
+        private:
+            const char* Position_ = nullptr; // nullptr marks the end of the range
+            const char* End_ = nullptr;
+            TPriceQuantity Current_;
+            bool Malformed_ = false; // the range ended at a malformed level rather than at the closing bracket
+
+        public:
+            Iterator() = default;
+
+            Iterator(const char* position, const char* end) : Position_(position), End_(end) {
+                ReadNext();
+            }
+
+            reference operator*() const {
+                return Current_;
+            }
+
+            pointer operator->() const {
+                return &Current_;
+            }
+
+            Iterator& operator++() {
+                ReadNext();
+                return *this;
+            }
+
+            void operator++(int) {
+                (void)operator++();
+            }
+
+            bool operator==(Sentinel) const {
+                return Position_ == nullptr;
+            }
+
+            [[nodiscard]]
+            bool IsMalformed() const noexcept {
+                return Malformed_;
+            }
+
+        private:
+            void Fail() noexcept {
+                Position_ = nullptr;
+                Malformed_ = true;
+            }
+
+            // Expects Position_ to point either to the next level or to the closing bracket of the array.
+            void ReadNext() {
+                using namespace Details;
+
+                const char* it = SkipWhitespace(Position_, End_);
+                if (it != End_ && *it == ',') {
+                    it = SkipWhitespace(it + 1, End_);
+                }
+
+                if (it == End_ || *it != '[') {
+                    if (it == End_ || *it != ']') [[unlikely]] {
+                        Fail();
+                    } else {
+                        Position_ = nullptr;
+                    }
+                    return;
+                }
+
+                it = SkipWhitespace(it + 1, End_);
+                const auto price = ReadString(it, End_);
+
+                it = SkipWhitespace(it, End_);
+                if (!price || it == End_ || *it != ',') [[unlikely]] {
+                    Fail();
+                    return;
+                }
+
+                it = SkipWhitespace(it + 1, End_);
+                const auto quantity = ReadString(it, End_);
+
+                it = SkipWhitespace(it, End_);
+                if (!quantity || it == End_ || *it != ']') [[unlikely]] {
+                    Fail();
+                    return;
+                }
+
+                auto parsedPrice = Utils::FromDecimal<TPrice>(*price);
+                auto parsedQuantity = Utils::FromDecimal<TQuantity>(*quantity);
+                if (!parsedPrice || !parsedQuantity) [[unlikely]] {
+                    Fail();
+                    return;
+                }
+
+                Current_ = {
+                    .Price = *parsedPrice,
+                    .Quantity = *parsedQuantity,
+                };
+                Position_ = it + 1;
+            }
+        };
+
+        const char* Begin_ = nullptr; // points past the opening bracket of the array
+        const char* End_ = nullptr;
+
+    public:
+        LevelsView() = default;
+
+        LevelsView(const char* begin, const char* end) : Begin_(begin), End_(end) {
+        }
+
+        [[nodiscard]]
+        Iterator begin() const {
+            return Begin_ != nullptr ? Iterator(Begin_, End_) : Iterator();
+        }
+
+        [[nodiscard]]
+        Sentinel end() const {
+            return {};
+        }
+
+        // Check that every level of the array converts and the array is closed, converting all of them once.
+        [[nodiscard]]
+        bool IsValid() const {
+            if (Begin_ == nullptr) {
+                return true;
+            }
+
+            auto it = begin();
+            while (it != end()) {
+                ++it;
+            }
+
+            return !it.IsMalformed();
+        }
+    };
+
+    // Partial book depth payload (<symbol>@depth<levels>@100ms stream).
+    template <typename TPrice, typename TQuantity>
+    struct DepthMessage {
+        std::uint64_t LastUpdateId{};
+        LevelsView<TPrice, TQuantity> Bids;
+        LevelsView<TPrice, TQuantity> Asks;
+    };
+
+    // Diff depth payload (<symbol>@depth@100ms stream), levels are absolute quantities, zero removes the level.
+    template <typename TPrice, typename TQuantity>
+    struct DiffDepthMessage {
+        std::uint64_t FirstUpdateId{}; // "U"
+        std::uint64_t FinalUpdateId{}; // "u"
+        std::uint64_t EventTime{};     // "E", in milliseconds
+        LevelsView<TPrice, TQuantity> Bids;
+        LevelsView<TPrice, TQuantity> Asks;
+    };
+
+    // Individual symbol book ticker payload (<symbol>@bookTicker stream).
+    template <typename TPrice, typename TQuantity>
+    struct BookTickerMessage {
+        std::uint64_t UpdateId{};
+        std::string_view Symbol; // points into the parsed payload
+        Models::BookTicker<TPrice, TQuantity> Ticker;
+    };
+
+    /*
+     * Parses a partial depth payload in place:
+     * {"lastUpdateId":160,"bids":[["0.0024","10"]],"asks":[["0.0026","100"]]}
+     * The payload may also be wrapped into a combined stream object ({"stream":"...","data":{...}}).
+     *
+     * The levels are validated here and converted again while being iterated, std::nullopt is returned
+     * if any of them is malformed, so a truncated or damaged payload never reaches the book as a shorter one.
+    */
+    template <typename TPrice = double, typename TQuantity = double>
+    std::optional<DepthMessage<TPrice, TQuantity>> ParseDepth(std::string_view payload) noexcept {
+        using namespace Details;
+
+        const char* const end = payload.data() + payload.size();
+
+        const char* lastUpdateId = FindValue(payload, "\"lastUpdateId\"");
+        const char* bids = FindValue(payload, "\"bids\"");
+        if (lastUpdateId == nullptr || bids == nullptr || *bids != '[') [[unlikely]] {
+            return std::nullopt;
+        }
+
+        // Bids contain only numbers in quotes, so the asks key can't appear inside of them.
+        const char* asks = FindValue(payload, "\"asks\"", bids - payload.data());
+        if (asks == nullptr || *asks != '[') [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const auto updateId = ReadUnsigned(lastUpdateId, end);
+        const LevelsView<TPrice, TQuantity> bidsView(bids + 1, end);
+        const LevelsView<TPrice, TQuantity> asksView(asks + 1, end);
+        if (!updateId || !bidsView.IsValid() || !asksView.IsValid()) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        return DepthMessage<TPrice, TQuantity> {
+            .LastUpdateId = *updateId,
+            .Bids = bidsView,
+            .Asks = asksView,
+        };
+    }
+
+    /*
+     * Parses a diff depth payload in place:
+     * {"e":"depthUpdate","E":123456789,"s":"BNBBTC","U":157,"u":160,"b":[["0.0024","10"]],"a":[["0.0026","100"]]}
+     * The payload may also be wrapped into a combined stream object.
+     *
+     * The levels are validated the same way as by ParseDepth.
+    */
+    template <typename TPrice = double, typename TQuantity = double>
+    std::optional<DiffDepthMessage<TPrice, TQuantity>> ParseDiffDepth(std::string_view payload) noexcept {
+        using namespace Details;
+
+        const char* const end = payload.data() + payload.size();
+
+        auto readUnsigned = [&](std::string_view quotedKey) -> std::optional<std::uint64_t> {
+            const char* it = FindValue(payload, quotedKey);
+            return it != nullptr ? ReadUnsigned(it, end) : std::nullopt;
+        };
+
+        const auto firstUpdateId = readUnsigned("\"U\"");
+        const auto finalUpdateId = readUnsigned("\"u\"");
+        const auto eventTime = readUnsigned("\"E\"");
+
+        const char* bids = FindValue(payload, "\"b\"");
+        if (!firstUpdateId || !finalUpdateId || bids == nullptr || *bids != '[') [[unlikely]] {
+            return std::nullopt;
+        }
+
+        // Bids contain only numbers in quotes, so the asks key can't appear inside of them.
+        const char* asks = FindValue(payload, "\"a\"", bids - payload.data());
+        if (asks == nullptr || *asks != '[') [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const LevelsView<TPrice, TQuantity> bidsView(bids + 1, end);
+        const LevelsView<TPrice, TQuantity> asksView(asks + 1, end);
+        if (!bidsView.IsValid() || !asksView.IsValid()) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        return DiffDepthMessage<TPrice, TQuantity> {
+            .FirstUpdateId = *firstUpdateId,
+            .FinalUpdateId = *finalUpdateId,
+            .EventTime = eventTime.value_or(0),
+            .Bids = bidsView,
+            .Asks = asksView,
+        };
+    }
+
+    /*
+     * Parses a book ticker payload in place:
+     * {"u":400900217,"s":"BNBUSDT","b":"25.35190000","B":"31.21000000","a":"25.36520000","A":"40.66000000"}
+    */
+    template <typename TPrice = double, typename TQuantity = double>
+    std::optional<BookTickerMessage<TPrice, TQuantity>> ParseBookTicker(std::string_view payload) noexcept {
+        using namespace Details;
+
+        const char* const end = payload.data() + payload.size();
+
+        auto readString = [&](std::string_view quotedKey) -> std::optional<std::string_view> {
+            const char* it = FindValue(payload, quotedKey);
+            return it != nullptr ? ReadString(it, end) : std::nullopt;
+        };
+
+        const char* updateIdValue = FindValue(payload, "\"u\"");
+        const auto updateId = updateIdValue != nullptr ? ReadUnsigned(updateIdValue, end) : std::nullopt;
+        const auto symbol = readString("\"s\"");
+        const auto bidPrice = readString("\"b\"");
+        const auto bidQuantity = readString("\"B\"");
+        const auto askPrice = readString("\"a\"");
+        const auto askQuantity = readString("\"A\"");
+
+        if (!updateId || !symbol || !bidPrice || !bidQuantity || !askPrice || !askQuantity) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        auto bestBidPrice = Utils::FromDecimal<TPrice>(*bidPrice);
+        auto bestBidQty = Utils::FromDecimal<TQuantity>(*bidQuantity);
+        auto bestAskPrice = Utils::FromDecimal<TPrice>(*askPrice);
+        auto bestAskQty = Utils::FromDecimal<TQuantity>(*askQuantity);
+
+        if (!bestBidPrice || !bestBidQty || !bestAskPrice || !bestAskQty) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        return BookTickerMessage<TPrice, TQuantity> {
+            .UpdateId = *updateId,
+            .Symbol = *symbol,
+            .Ticker = {
+                .BestBidPrice = *bestBidPrice,
+                .BestBidQty = *bestBidQty,
+                .BestAskPrice = *bestAskPrice,
+                .BestAskQty = *bestAskQty,
+            },
+        };
+    }
+
+}
@@ -0,0 +1 @@
+#include "shm_format.h"
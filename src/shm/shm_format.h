@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "../level_events.h"
+#include "../models/top_of_book.h"
+#include "../utils/seq_lock.h"
+
+namespace OrderBook::Shm {
+
+    /*
+     * Layout of a POSIX shared memory segment through which one publisher process shares books with local readers
+     * (see ShmPublisher and ShmReader):
+     *
+     *   SegmentHeader             types and sizes of the segment, Ready is set once the segment is initialized
+     *   RingHead                  number of events published into the ring so far, on its own cache line
+     *   BookSlot[SlotsCount]      per book: the symbol and the top of the book published through a SeqLock
+     *   RingEntry[RingCapacity]   the broadcast ring of level changes of all books
+     *
+     * Every ring entry carries the sequence number of the event it holds, written after the event, so a reader
+     * which has fallen behind by more than the capacity of the ring detects that its entries were overwritten.
+     * Segments are only shared between processes of the same host and build, values are stored as they are
+     * in memory and the header records their sizes to reject readers of a different type of books.
+    */
+
+    inline constexpr std::uint32_t Magic = 0x504D4853; // "SHMP"
+    inline constexpr std::uint16_t Version = 1;
+    inline constexpr std::size_t SymbolSize = 32;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Atomics are shared between processes");
+
+    struct alignas(64) SegmentHeader {
+        std::uint32_t Magic{};
+        std::uint16_t Version{};
+        std::uint8_t PriceSize{};
+        std::uint8_t QuantitySize{};
+        std::uint32_t LevelsPerSide{};
+        std::uint32_t SlotsCount{};
+        std::uint64_t SlotSize{};
+        std::uint64_t RingCapacity{};
+        std::uint64_t RingEntrySize{};
+        std::atomic<std::uint32_t> Ready{}; // set last, with release, by the publisher
+    };
+
+    struct alignas(64) RingHead {
+        std::atomic<std::uint64_t> Published{};
+    };
+
+    template <typename TSnapshot>
+    struct alignas(64) BookSlot {
+        char Symbol[SymbolSize]{}; // not terminated if it takes the whole array
+        Utils::SeqLock<TSnapshot> Snapshot;
+    };
+
+    // A level change of a book, see LevelEvent.
+    template <typename TPrice, typename TQuantity>
+    struct RingEvent {
+        LevelEvent<TPrice, TQuantity> Event;
+        std::uint32_t SlotIndex{};
+        bool LastOfUpdate{}; // the last event of an update of the book, its slot shows the state after the update
+    };
+
+    template <typename TPrice, typename TQuantity>
+    struct RingEntry {
+        std::atomic<std::uint64_t> Sequence{}; // sequence number of the event + 1, 0 while it is being written
+        RingEvent<TPrice, TQuantity> Event;
+    };
+
+    // Offsets and sizes of a segment of books of the given types.
+    template <typename TPrice, typename TQuantity, std::size_t Levels>
+    struct SegmentLayout {
+        using TSnapshot = Models::TopOfBook<TPrice, TQuantity, Levels>;
+        using TSlot = BookSlot<TSnapshot>;
+        using TEntry = RingEntry<TPrice, TQuantity>;
+
+        static_assert(std::is_trivially_copyable_v<RingEvent<TPrice, TQuantity>>, "Events are copied while they can be overwritten");
+
+        static constexpr std::size_t SlotsOffset = sizeof(SegmentHeader) + sizeof(RingHead);
+
+        static constexpr std::size_t RingOffset(std::size_t slotsCount) noexcept {
+            return SlotsOffset + slotsCount * sizeof(TSlot);
+        }
+
+        static constexpr std::size_t Size(std::size_t slotsCount, std::size_t ringCapacity) noexcept {
+            return RingOffset(slotsCount) + ringCapacity * sizeof(TEntry);
+        }
+
+        // Header of a segment, Ready is left for the publisher to set.
+        static void WriteHeader(SegmentHeader& header, std::size_t slotsCount, std::size_t ringCapacity) noexcept {
+            header.Magic = Magic;
+            header.Version = Version;
+            header.PriceSize = sizeof(TPrice);
+            header.QuantitySize = sizeof(TQuantity);
+            header.LevelsPerSide = static_cast<std::uint32_t>(Levels);
+            header.SlotsCount = static_cast<std::uint32_t>(slotsCount);
+            header.SlotSize = sizeof(TSlot);
+            header.RingCapacity = ringCapacity;
+            header.RingEntrySize = sizeof(TEntry);
+        }
+
+        // Whether a segment with the header holds books of these types.
+        static bool Matches(const SegmentHeader& header) noexcept {
+            return header.Magic == Magic && header.Version == Version && header.PriceSize == sizeof(TPrice)
+                   && header.QuantitySize == sizeof(TQuantity) && header.LevelsPerSide == Levels
+                   && header.SlotSize == sizeof(TSlot) && header.RingEntrySize == sizeof(TEntry);
+        }
+    };
+
+}
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "shm_format.h"
+
+namespace OrderBook::Shm {
+
+    /*
+     * Shares books of this process with local reader processes through a POSIX shared memory segment
+     * (see shm_format.h). Every book gets a slot, the book publishes its top levels into the slot itself
+     * after every change (see Attach and BinanceBook::PublishTo), and the level events of the updates
+     * (see BinanceBook::EmitLevelEventsTo) are broadcast through the ring with PublishEvents.
+     * The publisher never waits for readers, readers which fall behind lose events and are told so.
+     *
+     * The publisher creates the segment under `name` (e.g. "/binance_books"), replacing a stale one left
+     * by a previous run, and removes the name when it is destroyed. Readers attached at that moment keep
+     * their mappings. Books and events must be published from a single thread.
+     * Throws std::system_error if the segment can't be created or mapped.
+    */
+    template <typename TPrice, typename TQuantity, std::size_t Levels = 20>
+    class ShmPublisher {
+        using TLayout = SegmentLayout<TPrice, TQuantity, Levels>;
+        using TSlot = typename TLayout::TSlot;
+        using TEntry = typename TLayout::TEntry;
+
+    public:
+        using TSnapshotSlot = Utils::SeqLock<typename TLayout::TSnapshot>;
+        using TLevelEvent = LevelEvent<TPrice, TQuantity>;
+
+    private:
+        std::string Name_;
+        std::byte* Data_ = nullptr;
+        std::size_t Size_ = 0;
+        std::size_t SlotsCount_ = 0;
+        std::size_t RingMask_ = 0;
+        std::uint64_t Published_ = 0; // the copy of RingHead kept by the only writer
+
+    public:
+        // The ring capacity is rounded up to a power of 2.
+        ShmPublisher(std::string name, std::size_t slotsCount, std::size_t ringCapacity = 1 << 16)
+            : Name_(std::move(name)), SlotsCount_(slotsCount), RingMask_(std::bit_ceil(std::max<std::size_t>(ringCapacity, 1)) - 1) {
+            Size_ = TLayout::Size(SlotsCount_, RingMask_ + 1);
+
+            ::shm_unlink(Name_.c_str());
+            const int fd = ::shm_open(Name_.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to create shared memory " + Name_);
+            }
+
+            if (::ftruncate(fd, static_cast<off_t>(Size_)) != 0) {
+                const int error = errno;
+                ::close(fd);
+                ::shm_unlink(Name_.c_str());
+                throw std::system_error(error, std::generic_category(), "Failed to resize shared memory " + Name_);
+            }
+
+            void* data = ::mmap(nullptr, Size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+            const int error = errno;
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                ::shm_unlink(Name_.c_str());
+                throw std::system_error(error, std::generic_category(), "Failed to map shared memory " + Name_);
+            }
+
+            Data_ = static_cast<std::byte*>(data);
+            Initialize();
+        }
+
+        ShmPublisher(const ShmPublisher&) = delete;
+        ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+        ~ShmPublisher() {
+            ::munmap(Data_, Size_);
+            ::shm_unlink(Name_.c_str());
+        }
+
+        /*
+         * Name the slot `index` and make the book publish its top levels into it from now on.
+         * Throws std::length_error if the symbol doesn't fit into the slot.
+        */
+        void Attach(std::size_t index, std::string_view symbol, auto& book) {
+            assert(index < SlotsCount_);
+
+            if (symbol.size() > SymbolSize) [[unlikely]] {
+                throw std::length_error("Symbol is too long for a shared memory slot: " + std::string(symbol));
+            }
+
+            auto& slot = Slot(index);
+            std::memset(slot.Symbol, 0, sizeof(slot.Symbol));
+            std::memcpy(slot.Symbol, symbol.data(), symbol.size());
+
+            book.PublishTo(&slot.Snapshot);
+        }
+
+        // The slot a book of the index publishes to, for books attached by the caller.
+        [[nodiscard]]
+        TSnapshotSlot* SnapshotSlot(std::size_t index) noexcept {
+            assert(index < SlotsCount_);
+            return &Slot(index).Snapshot;
+        }
+
+        // Broadcast the level events of an update of the book `index`, the last one is marked as the end of the update.
+        void PublishEvents(std::size_t index, std::span<const TLevelEvent> events) noexcept {
+            if (events.empty()) {
+                return;
+            }
+
+            auto* ring = Ring();
+            for (std::size_t i = 0; i < events.size(); ++i) {
+                auto& entry = ring[Published_ & RingMask_];
+
+                // Readers which see 0 or a changed sequence after copying the event know it was overwritten.
+                entry.Sequence.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                entry.Event = {
+                    .Event = events[i],
+                    .SlotIndex = static_cast<std::uint32_t>(index),
+                    .LastOfUpdate = i + 1 == events.size(),
+                };
+
+                entry.Sequence.store(++Published_, std::memory_order_release);
+            }
+
+            Head().Published.store(Published_, std::memory_order_release);
+        }
+
+        [[nodiscard]]
+        std::size_t SlotsCount() const noexcept {
+            return SlotsCount_;
+        }
+
+        [[nodiscard]]
+        std::size_t RingCapacity() const noexcept {
+            return RingMask_ + 1;
+        }
+
+        // Number of events published so far.
+        [[nodiscard]]
+        std::uint64_t PublishedEvents() const noexcept {
+            return Published_;
+        }
+
+        [[nodiscard]]
+        const std::string& Name() const noexcept {
+            return Name_;
+        }
+
+    private:
+        void Initialize() noexcept {
+            auto* header = ::new (Data_) SegmentHeader();
+            TLayout::WriteHeader(*header, SlotsCount_, RingMask_ + 1);
+            ::new (Data_ + sizeof(SegmentHeader)) RingHead();
+
+            for (std::size_t index = 0; index < SlotsCount_; ++index) {
+                ::new (&Slot(index)) TSlot();
+            }
+
+            auto* ring = Data_ + TLayout::RingOffset(SlotsCount_);
+            for (std::size_t index = 0; index <= RingMask_; ++index) {
+                ::new (ring + index * sizeof(TEntry)) TEntry();
+            }
+
+            header->Ready.store(1, std::memory_order_release);
+        }
+
+        TSlot& Slot(std::size_t index) noexcept {
+            return reinterpret_cast<TSlot*>(Data_ + TLayout::SlotsOffset)[index];
+        }
+
+        RingHead& Head() noexcept {
+            return *reinterpret_cast<RingHead*>(Data_ + sizeof(SegmentHeader));
+        }
+
+        TEntry* Ring() noexcept {
+            return reinterpret_cast<TEntry*>(Data_ + TLayout::RingOffset(SlotsCount_));
+        }
+    };
+
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "shm_format.h"
+
+namespace OrderBook::Shm {
+
+    // Outcome of ShmReader::Poll.
+    struct PollResult {
+        std::size_t Count{}; // events copied into the caller buffer
+        bool Overrun{};      // events were lost since the previous call, the slots have to be read again
+    };
+
+    /*
+     * Attaches read-only to a segment created by ShmPublisher (see shm_format.h). The top levels of every book
+     * are read from its slot either as a copy (Load) or in place (TryView), the level events of all books
+     * are taken from the broadcast ring with Poll. Readers never write to the segment, so any number of them
+     * can follow the publisher without slowing it down or each other.
+     *
+     * Throws std::system_error if the segment can't be opened or mapped, and std::runtime_error
+     * if it is not initialized yet or holds books of another type.
+    */
+    template <typename TPrice, typename TQuantity, std::size_t Levels = 20>
+    class ShmReader {
+        using TLayout = SegmentLayout<TPrice, TQuantity, Levels>;
+        using TSlot = typename TLayout::TSlot;
+        using TEntry = typename TLayout::TEntry;
+
+    public:
+        using TSnapshot = typename TLayout::TSnapshot;
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+        using TRingEvent = RingEvent<TPrice, TQuantity>;
+
+    private:
+        const std::byte* Data_ = nullptr;
+        std::size_t Size_ = 0;
+        std::size_t SlotsCount_ = 0;
+        std::size_t RingMask_ = 0;
+        std::uint64_t Cursor_ = 0; // the sequence number of the next event to read
+
+    public:
+        // Events are read from the moment of attaching.
+        explicit ShmReader(const std::string& name) {
+            const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+            if (fd < 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to open shared memory " + name);
+            }
+
+            struct stat status{};
+            if (::fstat(fd, &status) != 0) {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Failed to stat shared memory " + name);
+            }
+
+            Size_ = static_cast<std::size_t>(status.st_size);
+            if (Size_ < TLayout::SlotsOffset) {
+                ::close(fd);
+                throw std::runtime_error("Shared memory " + name + " is not initialized");
+            }
+
+            void* data = ::mmap(nullptr, Size_, PROT_READ, MAP_SHARED, fd, 0);
+            const int error = errno;
+            ::close(fd);
+
+            if (data == MAP_FAILED) {
+                throw std::system_error(error, std::generic_category(), "Failed to map shared memory " + name);
+            }
+
+            Data_ = static_cast<const std::byte*>(data);
+
+            const auto& header = Header();
+            if (header.Ready.load(std::memory_order_acquire) == 0 || !TLayout::Matches(header)
+                || !std::has_single_bit(header.RingCapacity) || TLayout::Size(header.SlotsCount, header.RingCapacity) != Size_) {
+                ::munmap(const_cast<std::byte*>(Data_), Size_);
+                throw std::runtime_error("Shared memory " + name + " doesn't hold books of this type");
+            }
+
+            SlotsCount_ = header.SlotsCount;
+            RingMask_ = header.RingCapacity - 1;
+            Cursor_ = Head().Published.load(std::memory_order_acquire);
+        }
+
+        ShmReader(const ShmReader&) = delete;
+        ShmReader& operator=(const ShmReader&) = delete;
+
+        ~ShmReader() {
+            ::munmap(const_cast<std::byte*>(Data_), Size_);
+        }
+
+        [[nodiscard]]
+        std::size_t SlotsCount() const noexcept {
+            return SlotsCount_;
+        }
+
+        // Symbol of the book of the slot, empty if the slot is not attached yet.
+        [[nodiscard]]
+        std::string_view Symbol(std::size_t index) const noexcept {
+            const auto& symbol = Slot(index).Symbol;
+            return {symbol, static_cast<std::size_t>(std::find(symbol, symbol + SymbolSize, '\0') - symbol)};
+        }
+
+        // Number of changes of the book published so far, e.g. to skip reading an unchanged book.
+        [[nodiscard]]
+        std::uint64_t Version(std::size_t index) const noexcept {
+            return Slot(index).Snapshot.Version();
+        }
+
+        // Copy a consistent top of the book, retrying while it is being written.
+        [[nodiscard]]
+        TSnapshot Load(std::size_t index) const noexcept {
+            return Slot(index).Snapshot.Load();
+        }
+
+        /*
+         * Call `reader(bids, asks)` with views of the levels of the book straight in the shared memory and return
+         * whether they were consistent. The levels may be overwritten while the reader looks at them,
+         * the results of the reader are valid only if true is returned, otherwise just try again.
+        */
+        template <typename TReader>
+        bool TryView(std::size_t index, TReader&& reader) const noexcept {
+            return Slot(index).Snapshot.TryRead([&](const TSnapshot& snapshot) {
+                // A torn copy may have any counts, keep the views within the arrays.
+                reader(std::span<const TPriceQuantity>(snapshot.Bids.data(), std::min<std::size_t>(snapshot.BidsCount, Levels)),
+                       std::span<const TPriceQuantity>(snapshot.Asks.data(), std::min<std::size_t>(snapshot.AsksCount, Levels)));
+            });
+        }
+
+        /*
+         * Copy the events published since the previous call into `events`, up to its size. If the publisher
+         * has overwritten events the reader hasn't taken yet, the reader skips to the oldest available event
+         * and reports the overrun: the books the lost events belonged to are unknown, so all slots should be read again.
+        */
+        PollResult Poll(std::span<TRingEvent> events) noexcept {
+            PollResult result;
+            const std::uint64_t published = Head().Published.load(std::memory_order_acquire);
+
+            if (published - Cursor_ > RingMask_ + 1) [[unlikely]] {
+                Cursor_ = published - (RingMask_ + 1);
+                result.Overrun = true;
+            }
+
+            const TEntry* ring = Ring();
+            while (Cursor_ != published && result.Count != events.size()) {
+                const TEntry& entry = ring[Cursor_ & RingMask_];
+
+                const std::uint64_t before = entry.Sequence.load(std::memory_order_acquire);
+                std::memcpy(&events[result.Count], &entry.Event, sizeof(TRingEvent));
+                std::atomic_thread_fence(std::memory_order_acquire);
+
+                if (before != Cursor_ + 1 || entry.Sequence.load(std::memory_order_relaxed) != before) [[unlikely]] {
+                    // Overwritten by the publisher lapping the reader, continue from the oldest entry still in the ring.
+                    const std::uint64_t head = Head().Published.load(std::memory_order_acquire);
+                    Cursor_ = head - std::min<std::uint64_t>(head, RingMask_ + 1);
+                    result.Overrun = true;
+                    return result;
+                }
+
+                ++Cursor_;
+                ++result.Count;
+            }
+
+            return result;
+        }
+
+        // Number of published events not taken by Poll yet (it may exceed the capacity of the ring).
+        [[nodiscard]]
+        std::uint64_t Lag() const noexcept {
+            return Head().Published.load(std::memory_order_acquire) - Cursor_;
+        }
+
+    private:
+        const SegmentHeader& Header() const noexcept {
+            return *reinterpret_cast<const SegmentHeader*>(Data_);
+        }
+
+        const RingHead& Head() const noexcept {
+            return *reinterpret_cast<const RingHead*>(Data_ + sizeof(SegmentHeader));
+        }
+
+        const TSlot& Slot(std::size_t index) const noexcept {
+            return reinterpret_cast<const TSlot*>(Data_ + TLayout::SlotsOffset)[index];
+        }
+
+        const TEntry* Ring() const noexcept {
+            return reinterpret_cast<const TEntry*>(Data_ + TLayout::RingOffset(SlotsCount_));
+        }
+    };
+
+}
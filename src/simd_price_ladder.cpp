@@ -0,0 +1 @@
+#include "simd_price_ladder.h"
@@ -0,0 +1,345 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace OrderBook {
+
+    namespace Details {
+
+        // Price types which are laid out as a single int64_t: raw ticks or Models::FixedPoint.
+        template <typename T>
+        concept Int64Price = std::is_same_v<T, std::int64_t>
+                             || (requires { typename T::TRepresentation; }
+                                 && std::is_same_v<typename T::TRepresentation, std::int64_t>
+                                 && std::is_standard_layout_v<T>
+                                 && sizeof(T) == sizeof(std::int64_t));
+
+        template <typename TKeyComparator>
+        constexpr bool IsLess = std::is_same_v<TKeyComparator, std::less<>>;
+
+        template <typename TKeyComparator>
+        constexpr bool IsGreater = std::is_same_v<TKeyComparator, std::greater<>>;
+
+        // Mask with the lowest `count` bits set.
+        constexpr unsigned LowBits(std::size_t count) {
+            return (1u << count) - 1;
+        }
+
+        // Number of set bits in a 4-bit movemask. A table is used since without -mpopcnt
+        // __builtin_popcount becomes a library call.
+        constexpr unsigned BitCount(unsigned bits) {
+            constexpr unsigned char Counts[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+            return Counts[bits];
+        }
+
+        /*
+         * Counts elements of the sorted array for which `values[i] < key` (Greater == false)
+         * or `values[i] > key` (Greater == true). For a sorted array it is exactly the lower bound position.
+         * The elements are compared all at once without branches depending on the data,
+         * `values` should be readable up to `size` rounded up to the number of lanes.
+        */
+        template <bool Greater>
+        std::size_t CountBefore(const double* values, std::size_t size, double key) {
+            std::size_t count = 0;
+            std::size_t i = 0;
+
+#if defined(__AVX__)
+            const __m256d keys = _mm256_set1_pd(key);
+            for (; i < size; i += 4) {
+                const __m256d lanes = _mm256_loadu_pd(values + i);
+                const __m256d mask = Greater ? _mm256_cmp_pd(lanes, keys, _CMP_GT_OQ)
+                                             : _mm256_cmp_pd(lanes, keys, _CMP_LT_OQ);
+                const unsigned bits = _mm256_movemask_pd(mask) & LowBits(std::min<std::size_t>(size - i, 4));
+                count += BitCount(bits);
+            }
+#elif defined(__SSE2__)
+            const __m128d keys = _mm_set1_pd(key);
+            for (; i < size; i += 2) {
+                const __m128d lanes = _mm_loadu_pd(values + i);
+                const __m128d mask = Greater ? _mm_cmpgt_pd(lanes, keys) : _mm_cmplt_pd(lanes, keys);
+                const unsigned bits = _mm_movemask_pd(mask) & LowBits(std::min<std::size_t>(size - i, 2));
+                count += BitCount(bits);
+            }
+#else
+            for (; i < size; ++i) {
+                count += Greater ? values[i] > key : values[i] < key;
+            }
+#endif
+
+            return count;
+        }
+
+        template <bool Greater>
+        std::size_t CountBefore(const std::int64_t* values, std::size_t size, std::int64_t key) {
+            std::size_t count = 0;
+            std::size_t i = 0;
+
+#if defined(__AVX2__)
+            const __m256i keys = _mm256_set1_epi64x(key);
+            for (; i < size; i += 4) {
+                const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+                const __m256i mask = Greater ? _mm256_cmpgt_epi64(lanes, keys) : _mm256_cmpgt_epi64(keys, lanes);
+                const unsigned bits = _mm256_movemask_pd(_mm256_castsi256_pd(mask))
+                                      & LowBits(std::min<std::size_t>(size - i, 4));
+                count += BitCount(bits);
+            }
+#elif defined(__SSE4_2__)
+            const __m128i keys = _mm_set1_epi64x(key);
+            for (; i < size; i += 2) {
+                const __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+                const __m128i mask = Greater ? _mm_cmpgt_epi64(lanes, keys) : _mm_cmpgt_epi64(keys, lanes);
+                const unsigned bits = _mm_movemask_pd(_mm_castsi128_pd(mask))
+                                      & LowBits(std::min<std::size_t>(size - i, 2));
+                count += BitCount(bits);
+            }
+#else
+            for (; i < size; ++i) {
+                count += Greater ? values[i] > key : values[i] < key;
+            }
+#endif
+
+            return count;
+        }
+
+    }
+
+    /*
+     * A sorted container of price levels with structure-of-arrays layout, an alternative to FlatMapStorage.
+     *
+     * Prices and quantities are kept in separate fixed arrays aligned to the cache line, so a lookup only touches
+     * the prices. Positions are found by comparing the key against all stored prices with SIMD instructions
+     * (AVX/AVX2 or SSE, depending on the target) and counting the matches. For the small number of levels kept
+     * by OrderMap it is faster than binary search, which has to wait for every loaded element before the next step.
+     * Other price types and comparators fall back to the same counting done by scalar code.
+     *
+     * Implements the subset of the flat_map interface used by OrderMap. Iterators are positions in the arrays and
+     * dereference to a pair-like proxy with `first` (price) and `second` (mutable quantity) members.
+     * The insertion hint is used the same way as by flat_map: if the price is after the hinted position,
+     * only the levels starting from it are compared.
+    */
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity>
+    class SimdPriceLadder {
+        static constexpr std::size_t CacheLineSize = 64;
+
+        // Pad the arrays with a full register of the widest SIMD instructions (4 x 64 bits),
+        // so the lookup starting from any position can always read full registers.
+        static constexpr std::size_t PaddedCapacity = (Capacity + 3 + 3) / 4 * 4;
+
+        alignas(CacheLineSize) std::array<TPrice, PaddedCapacity> Prices_{};
+        alignas(CacheLineSize) std::array<TQuantity, PaddedCapacity> Quantities_{};
+        std::size_t Size_ = 0;
+        [[no_unique_address]] TKeyComparator Comparator_;
+
+        struct Reference {
+            const TPrice& first;
+            TQuantity& second;
+        };
+
+        struct ConstReference {
+            const TPrice& first;
+            const TQuantity& second;
+        };
+
+        template <typename TReference>
+        struct ArrowProxy {
+            TReference Reference_;
+
+            const TReference* operator->() const {
+                return &Reference_;
+            }
+        };
+
+        template <bool IsConst>
+        class Iterator {
+            friend class SimdPriceLadder;
+            friend class Iterator<!IsConst>;
+
+            using TLadder = std::conditional_t<IsConst, const SimdPriceLadder, SimdPriceLadder>;
+            using TReference = std::conditional_t<IsConst, ConstReference, Reference>;
+
+            TLadder* Ladder_ = nullptr;
+            std::size_t Index_ = 0;
+
+            Iterator(TLadder* ladder, std::size_t index) : Ladder_(ladder), Index_(index) {
+            }
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<TPrice, TQuantity>;
+            using difference_type = std::ptrdiff_t;
+            using reference = TReference;
+            using pointer = ArrowProxy<TReference>;
+
+            Iterator() = default;
+            Iterator(const Iterator&) = default;
+            Iterator& operator=(const Iterator&) = default;
+
+            // Allow conversion of iterator to const_iterator.
+            Iterator(const Iterator<false>& rhs) requires IsConst : Ladder_(rhs.Ladder_), Index_(rhs.Index_) {
+            }
+
+            reference operator*() const {
+                return {Ladder_->Prices_[Index_], Ladder_->Quantities_[Index_]};
+            }
+
+            pointer operator->() const {
+                return {operator*()};
+            }
+
+            Iterator& operator++() {
+                ++Index_;
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                return Iterator(Ladder_, Index_++);
+            }
+
+            Iterator& operator--() {
+                --Index_;
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                return Iterator(Ladder_, Index_--);
+            }
+
+            bool operator==(const Iterator& rhs) const {
+                return Index_ == rhs.Index_;
+            }
+        };
+
+    public:
+        using key_type = TPrice;
+        using mapped_type = TQuantity;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        [[nodiscard]]
+        bool empty() const {
+            return Size_ == 0;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const {
+            return Size_;
+        }
+
+        void clear() {
+            Size_ = 0;
+        }
+
+        iterator begin() {
+            return {this, 0};
+        }
+
+        const_iterator begin() const {
+            return {this, 0};
+        }
+
+        iterator end() {
+            return {this, Size_};
+        }
+
+        const_iterator end() const {
+            return {this, Size_};
+        }
+
+        iterator lower_bound(const TPrice& price) {
+            return {this, LowerBound(price)};
+        }
+
+        const_iterator lower_bound(const TPrice& price) const {
+            return {this, LowerBound(price)};
+        }
+
+        // Insert the level if there is no level with the same price yet, otherwise the existing level is returned.
+        std::pair<iterator, bool> try_emplace(const TPrice& price, const TQuantity& quantity) {
+            return TryEmplace(0, price, quantity);
+        }
+
+        iterator try_emplace(const_iterator hint, const TPrice& price, const TQuantity& quantity) {
+            return TryEmplace(hint.Index_, price, quantity).first;
+        }
+
+        std::pair<iterator, bool> emplace(const TPrice& price, const TQuantity& quantity) {
+            return try_emplace(price, quantity);
+        }
+
+        // Remove the level and return the iterator to the next one.
+        iterator erase(const_iterator position) {
+            const std::size_t index = position.Index_;
+
+            std::copy(Prices_.begin() + index + 1, Prices_.begin() + Size_, Prices_.begin() + index);
+            std::copy(Quantities_.begin() + index + 1, Quantities_.begin() + Size_, Quantities_.begin() + index);
+            --Size_;
+
+            return {this, index};
+        }
+
+    private:
+        std::pair<iterator, bool> TryEmplace(std::size_t hint, const TPrice& price, const TQuantity& quantity) {
+            const std::size_t index = LowerBound(price, hint);
+
+            if (index != Size_ && !Comparator_(price, Prices_[index])) {
+                return {iterator(this, index), false};
+            }
+
+            assert(Size_ < Capacity);
+
+            std::copy_backward(Prices_.begin() + index, Prices_.begin() + Size_, Prices_.begin() + Size_ + 1);
+            std::copy_backward(Quantities_.begin() + index, Quantities_.begin() + Size_, Quantities_.begin() + Size_ + 1);
+
+            Prices_[index] = price;
+            Quantities_[index] = quantity;
+            ++Size_;
+
+            return {iterator(this, index), true};
+        }
+
+        // Find the position of the price. All levels before `from` are expected to be before the price,
+        // if it is not so, the whole array is searched.
+        std::size_t LowerBound(const TPrice& price, std::size_t from = 0) const {
+            if (from > Size_ || (from != 0 && !Comparator_(Prices_[from - 1], price))) {
+                from = 0;
+            }
+
+            return from + CountBefore(from, price);
+        }
+
+        // Count the levels before the price starting from the given position.
+        std::size_t CountBefore(std::size_t from, const TPrice& price) const {
+            constexpr bool Vectorizable = Details::IsLess<TKeyComparator> || Details::IsGreater<TKeyComparator>;
+            constexpr bool Greater = Details::IsGreater<TKeyComparator>;
+
+            if constexpr (Vectorizable && std::is_same_v<TPrice, double>) {
+                return Details::CountBefore<Greater>(Prices_.data() + from, Size_ - from, price);
+            } else if constexpr (Vectorizable && Details::Int64Price<TPrice>) {
+                // Both raw int64_t and fixed-point prices share the layout of a single int64_t.
+                return Details::CountBefore<Greater>(reinterpret_cast<const std::int64_t*>(Prices_.data() + from),
+                                                     Size_ - from,
+                                                     *reinterpret_cast<const std::int64_t*>(&price));
+            } else {
+                std::size_t count = 0;
+                for (std::size_t i = from; i < Size_; ++i) {
+                    count += Comparator_(Prices_[i], price);
+                }
+
+                return count;
+            }
+        }
+    };
+
+}
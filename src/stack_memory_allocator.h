@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <array>
 #include <boost/pool/simple_segregated_storage.hpp>
@@ -87,24 +88,37 @@ namespace OrderBook {
 
         template <typename U, typename... Args>
         void construct(U* p, Args&&... args) {
-            assert(reinterpret_cast<char*>(p) <= NextConstructed_);
-
             // Since we don't actually allocate a new block of memory but use an existing one,
             // we should not call the constructor twice for objects that have already been created.
             // NextConstructed_ keeps track of the next address where the constructor is not called yet.
-            if (reinterpret_cast<char*>(p) == NextConstructed_) {
+            // Trivially copyable values are relocated by flat_map with memmove bypassing construct(),
+            // so the address can be even past NextConstructed_.
+            // Insertion in the middle may also construct a temporary value outside of the arena (on the stack),
+            // such objects are not tracked.
+            if (!IsInArena(p)) {
+                ::new ((void*)p) U(std::forward<Args>(args)...);
+            } else if (reinterpret_cast<char*>(p) >= NextConstructed_) {
                 ::new ((void*)p) U(std::forward<Args>(args)...);
-                NextConstructed_ += sizeof(T);
+                NextConstructed_ = reinterpret_cast<char*>(p) + sizeof(T);
             } else {
                 ::new ((void*)p) U(U(std::forward<Args>(args)...));
             }
         }
 
         template<class U>
-        void destroy(U*) {
+        void destroy(U* p) {
             // Since we reuse memory, there is nothing to destroy.
-            // All created objects will be destroyed in the destructor of StackMemoryAllocator.
-            // pass
+            // All created objects will be destroyed in the destructor of StackMemoryAllocator,
+            // except for temporaries constructed outside of the arena.
+            if (!IsInArena(p)) {
+                p->~U();
+            }
+        }
+
+    private:
+        bool IsInArena(const void* p) const {
+            const auto* address = static_cast<const char*>(p);
+            return address >= Arena_.data() && address < Arena_.data() + Arena_.size();
         }
     };
 
@@ -0,0 +1 @@
+#include "tick_ladder.h"
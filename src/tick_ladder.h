@@ -0,0 +1,495 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace OrderBook {
+
+    /*
+     * Converts prices into integer ticks of 1/TicksPerUnit for TickLadder (and quantities into lots for the wire format):
+     * floating-point prices are rounded to the nearest tick, fixed-point prices are divided exactly
+     * and integral prices are expected to be ticks already.
+    */
+    template <std::int64_t TicksPerUnit>
+    struct DecimalTicks {
+        static_assert(TicksPerUnit > 0);
+
+        template <typename TPrice>
+        static std::int64_t ToTicks(const TPrice& price) noexcept {
+            if constexpr (std::is_floating_point_v<TPrice>) {
+                const double scaled = static_cast<double>(price) * static_cast<double>(TicksPerUnit);
+                return static_cast<std::int64_t>(scaled + (scaled < 0 ? -0.5 : 0.5));
+            } else if constexpr (std::is_integral_v<TPrice>) {
+                return static_cast<std::int64_t>(price);
+            } else {
+                static_assert(TPrice::Multiplier % TicksPerUnit == 0, "The tick is finer than the fixed-point scale");
+                return price.Raw() / (TPrice::Multiplier / TicksPerUnit);
+            }
+        }
+
+        // The inverse of ToTicks.
+        template <typename TPrice>
+        static TPrice FromTicks(std::int64_t ticks) noexcept {
+            if constexpr (std::is_floating_point_v<TPrice>) {
+                return static_cast<TPrice>(static_cast<double>(ticks) / static_cast<double>(TicksPerUnit));
+            } else if constexpr (std::is_integral_v<TPrice>) {
+                return static_cast<TPrice>(ticks);
+            } else {
+                static_assert(TPrice::Multiplier % TicksPerUnit == 0, "The tick is finer than the fixed-point scale");
+                return TPrice::FromRaw(ticks * (TPrice::Multiplier / TicksPerUnit));
+            }
+        }
+    };
+
+    namespace Details {
+
+        /*
+         * A bitmap of Bits positions with a summary word per 64 words, so the nearest set bit is found
+         * by looking at a few words, however sparse the bitmap is.
+        */
+        template <std::size_t Bits>
+        class LadderBitmap {
+            static_assert(Bits >= 64 && std::has_single_bit(Bits));
+
+            static constexpr std::size_t WordsCount = Bits / 64;
+            static constexpr std::size_t SummaryCount = (WordsCount + 63) / 64;
+
+            std::uint64_t Words_[WordsCount]{};
+            std::uint64_t Summary_[SummaryCount]{};
+
+        public:
+            static constexpr std::size_t NotFound = std::numeric_limits<std::size_t>::max();
+
+            [[nodiscard]]
+            bool Test(std::size_t position) const noexcept {
+                return (Words_[position / 64] >> (position % 64)) & 1;
+            }
+
+            void Set(std::size_t position) noexcept {
+                const std::size_t word = position / 64;
+                Words_[word] |= std::uint64_t{1} << (position % 64);
+                Summary_[word / 64] |= std::uint64_t{1} << (word % 64);
+            }
+
+            void Reset(std::size_t position) noexcept {
+                const std::size_t word = position / 64;
+                Words_[word] &= ~(std::uint64_t{1} << (position % 64));
+                if (Words_[word] == 0) {
+                    Summary_[word / 64] &= ~(std::uint64_t{1} << (word % 64));
+                }
+            }
+
+            void Clear() noexcept {
+                std::fill(std::begin(Words_), std::end(Words_), 0);
+                std::fill(std::begin(Summary_), std::end(Summary_), 0);
+            }
+
+            // Reset positions in [first, last) and return how many of them were set.
+            std::size_t ResetRange(std::size_t first, std::size_t last) noexcept {
+                std::size_t count = 0;
+                for (std::size_t position = FindNext(first, last); position != last; position = FindNext(position, last)) {
+                    Reset(position);
+                    ++count;
+                }
+
+                return count;
+            }
+
+            // The first set position in [first, last) or `last` if there is none.
+            [[nodiscard]]
+            std::size_t FindNext(std::size_t first, std::size_t last) const noexcept {
+                if (first >= last) {
+                    return last;
+                }
+
+                std::size_t word = first / 64;
+                if (const auto bits = Words_[word] & (~std::uint64_t{0} << (first % 64))) {
+                    return std::min(last, word * 64 + std::countr_zero(bits));
+                }
+
+                // Words after the first one are looked up through the summary.
+                for (++word; word < WordsCount && word * 64 < last; ) {
+                    const auto summary = Summary_[word / 64] & (~std::uint64_t{0} << (word % 64));
+                    if (summary == 0) {
+                        word = (word / 64 + 1) * 64;
+                        continue;
+                    }
+
+                    word = word / 64 * 64 + std::countr_zero(summary);
+                    return std::min(last, word * 64 + std::countr_zero(Words_[word]));
+                }
+
+                return last;
+            }
+
+            // The last set position in [first, last] or NotFound if there is none.
+            [[nodiscard]]
+            std::size_t FindPrevious(std::size_t first, std::size_t last) const noexcept {
+                if (first > last) {
+                    return NotFound;
+                }
+
+                std::size_t word = last / 64;
+                const auto found = [&](std::size_t position) {
+                    return position >= first ? position : NotFound;
+                };
+
+                if (const auto bits = Words_[word] & (~std::uint64_t{0} >> (63 - last % 64))) {
+                    return found(word * 64 + 63 - std::countl_zero(bits));
+                }
+
+                while (word-- > first / 64) {
+                    const auto summary = Summary_[word / 64] & (~std::uint64_t{0} >> (63 - word % 64));
+                    if (summary == 0) {
+                        word = word / 64 * 64;
+                        continue;
+                    }
+
+                    word = word / 64 * 64 + 63 - std::countl_zero(summary);
+                    return found(word * 64 + 63 - std::countl_zero(Words_[word]));
+                }
+
+                return NotFound;
+            }
+        };
+
+    }
+
+    /*
+     * A price ladder: an alternative to FlatMapStorage for wide and deep books, where inserting a level near the top
+     * of a sorted array has to shift all the levels under it.
+     *
+     * Levels are kept in a circular array of Slots directly indexed by the price in ticks (see DecimalTicks),
+     * so inserting, updating and removing a level never moves other levels. The window of the ladder is anchored
+     * at the best level and covers Slots ticks under it. The anchor follows the best level as the market moves,
+     * which needs no data movement since the index of a tick in the circular array doesn't depend on the anchor.
+     * A bitmap of occupied slots gives the best level at once and finds the next non-empty level
+     * without visiting empty slots.
+     *
+     * Levels farther than Slots ticks from the best one don't fit into the window: inserting such a level is refused
+     * (try_emplace returns end()), and a new best level drops the levels which are left outside of the window.
+     * Only the top of the book is kept by OrderMap anyway, so Slots should just cover its usual depth in ticks.
+     *
+     * Implements the subset of the flat_map interface used by OrderMap, the same as SimdPriceLadder.
+     * Iterators are bidirectional and dereference to a pair-like proxy with `first` (price) and `second`
+     * (mutable quantity) members. The insertion hint is ignored, a lookup costs the same without it.
+     * The ladder is allocated on the heap, since it is usually too large for the stack.
+    */
+    template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity,
+              typename TTicks, std::size_t Slots>
+    class TickLadder {
+        static_assert(std::is_same_v<TKeyComparator, std::less<>> || std::is_same_v<TKeyComparator, std::greater<>>,
+                      "TickLadder orders levels by ticks, only std::less<> and std::greater<> are supported");
+        static_assert(std::has_single_bit(Slots) && Slots >= 64, "Slots must be a power of 2 not less than 64");
+
+        static constexpr std::size_t Mask = Slots - 1;
+        static constexpr std::int64_t EndKey = std::numeric_limits<std::int64_t>::max();
+
+        struct Data {
+            TPrice Prices[Slots]{};
+            TQuantity Quantities[Slots]{};
+            Details::LadderBitmap<Slots> Occupied;
+        };
+
+        // Levels are addressed by keys growing from the best level to the worst one:
+        // ticks for asks and negated ticks for bids.
+        std::unique_ptr<Data> Data_ = std::make_unique<Data>();
+        std::int64_t Anchor_ = 0; // key of the best level, the first slot of the window
+        std::size_t Size_ = 0;
+
+        struct Reference {
+            const TPrice& first;
+            TQuantity& second;
+        };
+
+        struct ConstReference {
+            const TPrice& first;
+            const TQuantity& second;
+        };
+
+        template <typename TReference>
+        struct ArrowProxy {
+            TReference Reference_;
+
+            const TReference* operator->() const {
+                return &Reference_;
+            }
+        };
+
+        template <bool IsConst>
+        class Iterator {
+            friend class TickLadder;
+            friend class Iterator<!IsConst>;
+
+            using TLadder = std::conditional_t<IsConst, const TickLadder, TickLadder>;
+            using TReference = std::conditional_t<IsConst, ConstReference, Reference>;
+
+            TLadder* Ladder_ = nullptr;
+            std::int64_t Key_ = EndKey;
+
+            Iterator(TLadder* ladder, std::int64_t key) : Ladder_(ladder), Key_(key) {
+            }
+
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<TPrice, TQuantity>;
+            using difference_type = std::ptrdiff_t;
+            using reference = TReference;
+            using pointer = ArrowProxy<TReference>;
+
+            Iterator() = default;
+            Iterator(const Iterator&) = default;
+            Iterator& operator=(const Iterator&) = default;
+
+            // Allow conversion of iterator to const_iterator.
+            Iterator(const Iterator<false>& rhs) requires IsConst : Ladder_(rhs.Ladder_), Key_(rhs.Key_) {
+            }
+
+            reference operator*() const {
+                const std::size_t slot = SlotOf(Key_);
+                return {Ladder_->Data_->Prices[slot], Ladder_->Data_->Quantities[slot]};
+            }
+
+            pointer operator->() const {
+                return {operator*()};
+            }
+
+            Iterator& operator++() {
+                Key_ = Ladder_->NextKey(Key_ + 1);
+                return *this;
+            }
+
+            Iterator operator++(int) {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            Iterator& operator--() {
+                Key_ = Ladder_->PreviousKey(Key_ == EndKey ? Ladder_->Anchor_ + static_cast<std::int64_t>(Mask)
+                                                           : Key_ - 1);
+                return *this;
+            }
+
+            Iterator operator--(int) {
+                auto copy = *this;
+                --*this;
+                return copy;
+            }
+
+            bool operator==(const Iterator& rhs) const {
+                return Key_ == rhs.Key_;
+            }
+        };
+
+    public:
+        using key_type = TPrice;
+        using mapped_type = TQuantity;
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        [[nodiscard]]
+        bool empty() const {
+            return Size_ == 0;
+        }
+
+        [[nodiscard]]
+        std::size_t size() const {
+            return Size_;
+        }
+
+        void clear() {
+            Data_->Occupied.Clear();
+            Size_ = 0;
+        }
+
+        // The best level is always at the anchor.
+        iterator begin() {
+            return {this, empty() ? EndKey : Anchor_};
+        }
+
+        const_iterator begin() const {
+            return {this, empty() ? EndKey : Anchor_};
+        }
+
+        iterator end() {
+            return {this, EndKey};
+        }
+
+        const_iterator end() const {
+            return {this, EndKey};
+        }
+
+        iterator lower_bound(const TPrice& price) {
+            return {this, LowerBound(KeyOf(price))};
+        }
+
+        const_iterator lower_bound(const TPrice& price) const {
+            return {this, LowerBound(KeyOf(price))};
+        }
+
+        // Insert the level if there is no level with the same price yet, otherwise the existing level is returned.
+        // A level outside of the window is not inserted and end() is returned.
+        std::pair<iterator, bool> try_emplace(const TPrice& price, const TQuantity& quantity) {
+            const std::int64_t key = KeyOf(price);
+
+            if (empty()) {
+                Anchor_ = key;
+            } else if (key < Anchor_) {
+                MoveAnchor(key);
+            } else if (key - Anchor_ > static_cast<std::int64_t>(Mask)) [[unlikely]] {
+                return {end(), false};
+            }
+
+            const std::size_t slot = SlotOf(key);
+            if (Data_->Occupied.Test(slot)) {
+                return {iterator(this, key), false};
+            }
+
+            Data_->Prices[slot] = price;
+            Data_->Quantities[slot] = quantity;
+            Data_->Occupied.Set(slot);
+            ++Size_;
+
+            return {iterator(this, key), true};
+        }
+
+        iterator try_emplace(const_iterator /* hint */, const TPrice& price, const TQuantity& quantity) {
+            return try_emplace(price, quantity).first;
+        }
+
+        std::pair<iterator, bool> emplace(const TPrice& price, const TQuantity& quantity) {
+            return try_emplace(price, quantity);
+        }
+
+        // Remove the level and return the iterator to the next one.
+        iterator erase(const_iterator position) {
+            const std::int64_t key = position.Key_;
+            assert(key != EndKey && Data_->Occupied.Test(SlotOf(key)));
+
+            Data_->Occupied.Reset(SlotOf(key));
+            --Size_;
+
+            const std::int64_t next = NextKey(key + 1);
+            if (key == Anchor_ && next != EndKey) {
+                Anchor_ = next;
+            }
+
+            return {this, next};
+        }
+
+    private:
+        static std::int64_t KeyOf(const TPrice& price) noexcept {
+            const std::int64_t ticks = TTicks::ToTicks(price);
+            return std::is_same_v<TKeyComparator, std::greater<>> ? -ticks : ticks;
+        }
+
+        static std::size_t SlotOf(std::int64_t key) noexcept {
+            return static_cast<std::size_t>(key) & Mask;
+        }
+
+        std::int64_t LowerBound(std::int64_t key) const noexcept {
+            if (empty()) {
+                return EndKey;
+            }
+
+            return NextKey(std::max(key, Anchor_));
+        }
+
+        // The key of the first level at `key` or after it within the window, EndKey if there is none.
+        std::int64_t NextKey(std::int64_t key) const noexcept {
+            const std::int64_t offset = key - Anchor_;
+            if (offset > static_cast<std::int64_t>(Mask)) {
+                return EndKey;
+            }
+
+            // The window starts at the slot of the anchor and wraps around the end of the array.
+            const std::size_t start = SlotOf(Anchor_);
+            const std::size_t slot = SlotOf(key);
+            const auto& occupied = Data_->Occupied;
+
+            std::size_t found = Slots;
+            if (slot >= start) {
+                found = occupied.FindNext(slot, Slots);
+                if (found == Slots) {
+                    found = occupied.FindNext(0, start);
+                    found = found != start ? found : Slots;
+                }
+            } else {
+                found = occupied.FindNext(slot, start);
+                found = found != start ? found : Slots;
+            }
+
+            return found != Slots ? Anchor_ + static_cast<std::int64_t>((found - start) & Mask) : EndKey;
+        }
+
+        // The key of the last level at `key` or before it within the window, EndKey if there is none.
+        std::int64_t PreviousKey(std::int64_t key) const noexcept {
+            if (key < Anchor_) {
+                return EndKey;
+            }
+
+            const std::size_t start = SlotOf(Anchor_);
+            const std::size_t slot = SlotOf(key);
+            const auto& occupied = Data_->Occupied;
+
+            std::size_t found = Details::LadderBitmap<Slots>::NotFound;
+            if (slot >= start) {
+                found = occupied.FindPrevious(start, slot);
+            } else {
+                found = occupied.FindPrevious(0, slot);
+                if (found == Details::LadderBitmap<Slots>::NotFound) {
+                    found = occupied.FindPrevious(start, Mask);
+                }
+            }
+
+            return found != Details::LadderBitmap<Slots>::NotFound
+                   ? Anchor_ + static_cast<std::int64_t>((found - start) & Mask)
+                   : EndKey;
+        }
+
+        // Move the anchor to a new best level, dropping the levels left outside of the window.
+        void MoveAnchor(std::int64_t key) noexcept {
+            const std::uint64_t shift = static_cast<std::uint64_t>(Anchor_ - key);
+            auto& occupied = Data_->Occupied;
+
+            if (shift >= Slots) {
+                occupied.Clear();
+                Size_ = 0;
+            } else {
+                // Keys [key + Slots, Anchor_ + Slots) share the slots with the new keys [key, Anchor_).
+                const std::size_t first = SlotOf(key);
+                const std::size_t last = first + shift;
+
+                if (last <= Slots) {
+                    Size_ -= occupied.ResetRange(first, last);
+                } else {
+                    Size_ -= occupied.ResetRange(first, Slots);
+                    Size_ -= occupied.ResetRange(0, last - Slots);
+                }
+            }
+
+            Anchor_ = key;
+        }
+    };
+
+    /*
+     * Binds the tick size and the number of slots of TickLadder, so it can be passed as TStorage:
+     * BinanceBook<double, double, 500, TickLadderStorage<DecimalTicks<100>>::Type>
+    */
+    template <typename TTicks, std::size_t Slots = 8192>
+    struct TickLadderStorage {
+        template <typename TPrice, typename TQuantity, typename TKeyComparator, std::size_t Capacity>
+        using Type = TickLadder<TPrice, TQuantity, TKeyComparator, Capacity, TTicks, Slots>;
+    };
+
+}
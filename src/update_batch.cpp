@@ -0,0 +1 @@
+#include "update_batch.h"
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#include "book_registry.h"
+#include "models/book_ticker.h"
+#include "models/book_update.h"
+#include "models/price_quantity.h"
+
+namespace OrderBook {
+
+    /*
+     * A burst of decoded updates of many books, applied at once with ApplyTo.
+     *
+     * Updates are kept as a structure of arrays: book ids, update types and payload indices in parallel vectors,
+     * tickers and depth levels in their own vectors, so filling the batch only appends to a few arrays.
+     * Vectors keep their capacity between bursts, a batch reused after Clear doesn't allocate.
+     *
+     * ApplyTo groups the updates by book, keeping the order of updates of every book, and prefetches
+     * the books of the next groups while applying the current one (see BinanceBook::Prefetch),
+     * so the cache misses of different books overlap instead of being taken one by one.
+    */
+    template <typename TPrice, typename TQuantity>
+    class UpdateBatch {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+        using TBookTicker = Models::BookTicker<TPrice, TQuantity>;
+
+        struct DepthPayload {
+            std::uint32_t Offset; // of the bids in Levels_, the asks follow them
+            std::uint16_t BidsCount;
+            std::uint16_t AsksCount;
+        };
+
+        std::vector<SymbolId> Books_;
+        std::vector<Models::UpdateType> Types_;
+        std::vector<std::uint32_t> Payloads_; // index in Tickers_ or Depths_ depending on the type
+
+        std::vector<TBookTicker> Tickers_;
+        std::vector<DepthPayload> Depths_;
+        std::vector<TPriceQuantity> Levels_;
+
+        // Scratch of ApplyTo: updates grouped by book and the first position of every group in Order_.
+        struct Group {
+            SymbolId Book;
+            std::uint32_t First;
+        };
+
+        std::vector<std::uint32_t> Order_;
+        std::vector<std::uint32_t> Starts_;
+        std::vector<Group> Groups_;
+
+    public:
+        static constexpr std::size_t DefaultPrefetchDistance = 4;
+
+        void AddDepth(SymbolId book, auto&& bids, auto&& asks) {
+            const auto offset = static_cast<std::uint32_t>(Levels_.size());
+            AppendLevels(bids);
+
+            const auto bidsCount = static_cast<std::uint16_t>(Levels_.size() - offset);
+            AppendLevels(asks);
+
+            Add(book, Models::UpdateType::Depth, Depths_.size());
+            Depths_.push_back({
+                .Offset = offset,
+                .BidsCount = bidsCount,
+                .AsksCount = static_cast<std::uint16_t>(Levels_.size() - offset - bidsCount),
+            });
+        }
+
+        void AddBBO(SymbolId book, TBookTicker ticker) {
+            Add(book, Models::UpdateType::BBO, Tickers_.size());
+            Tickers_.push_back(ticker);
+        }
+
+        template <std::size_t PriceLevels>
+        void Add(const Models::BookUpdate<TPrice, TQuantity, PriceLevels>& update) {
+            switch (update.Type) {
+                case Models::UpdateType::Depth:
+                    AddDepth(update.SymbolId, update.GetBids(), update.GetAsks());
+                    break;
+                case Models::UpdateType::BBO:
+                    AddBBO(update.SymbolId, update.Ticker);
+                    break;
+            }
+        }
+
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Books_.size();
+        }
+
+        [[nodiscard]]
+        bool IsEmpty() const noexcept {
+            return Books_.empty();
+        }
+
+        void Clear() noexcept {
+            Books_.clear();
+            Types_.clear();
+            Payloads_.clear();
+            Tickers_.clear();
+            Depths_.clear();
+            Levels_.clear();
+        }
+
+        /*
+         * Apply all updates of the batch, `bookOf(id)` returns the book by its id.
+         * Updates of the same book are applied in the order they were added, books are visited in the order of ids.
+         * `prefetchDistance` is the number of books prefetched ahead, 0 disables prefetching.
+        */
+        template <typename TBookOf>
+        void ApplyTo(TBookOf&& bookOf, std::size_t prefetchDistance = DefaultPrefetchDistance) {
+            GroupByBook();
+
+            for (std::size_t group = 0; group < std::min(prefetchDistance, Groups_.size()); ++group) {
+                bookOf(Groups_[group].Book).Prefetch();
+            }
+
+            for (std::size_t group = 0; group != Groups_.size(); ++group) {
+                if (prefetchDistance != 0 && group + prefetchDistance < Groups_.size()) {
+                    bookOf(Groups_[group + prefetchDistance].Book).Prefetch();
+                }
+
+                auto& book = bookOf(Groups_[group].Book);
+                const std::size_t last = group + 1 != Groups_.size() ? Groups_[group + 1].First : Order_.size();
+                for (std::size_t position = Groups_[group].First; position != last; ++position) {
+                    Apply(book, Order_[position]);
+                }
+            }
+        }
+
+        // Apply all updates of the batch in the order they were added, without grouping and prefetching.
+        template <typename TBookOf>
+        void ApplyInOrder(TBookOf&& bookOf) {
+            for (std::size_t index = 0; index < Books_.size(); ++index) {
+                Apply(bookOf(Books_[index]), index);
+            }
+        }
+
+    private:
+        /*
+         * Counting sort of the updates by book: ids are dense, so two passes over the batch and one over
+         * the ids are much cheaper than a comparison sort of a burst, and the order within a book is kept.
+        */
+        void GroupByBook() {
+            Groups_.clear();
+            Order_.resize(Books_.size());
+
+            SymbolId maxBook = 0;
+            for (const SymbolId book : Books_) {
+                maxBook = std::max(maxBook, book);
+            }
+
+            Starts_.assign(Books_.empty() ? 0 : maxBook + std::size_t{1}, 0);
+            for (const SymbolId book : Books_) {
+                ++Starts_[book];
+            }
+
+            std::uint32_t first = 0;
+            for (std::size_t book = 0; book < Starts_.size(); ++book) {
+                const std::uint32_t count = Starts_[book];
+                if (count != 0) {
+                    Groups_.push_back({.Book = static_cast<SymbolId>(book), .First = first});
+                }
+
+                Starts_[book] = first;
+                first += count;
+            }
+
+            for (std::size_t index = 0; index < Books_.size(); ++index) {
+                Order_[Starts_[Books_[index]]++] = static_cast<std::uint32_t>(index);
+            }
+        }
+
+        void AppendLevels(auto&& levels) {
+            if constexpr (std::ranges::common_range<decltype(levels)>) {
+                Levels_.insert(Levels_.end(), std::ranges::begin(levels), std::ranges::end(levels));
+            } else {
+                for (auto&& level : levels) {
+                    Levels_.push_back(level);
+                }
+            }
+        }
+
+        void Add(SymbolId book, Models::UpdateType type, std::size_t payload) {
+            Books_.push_back(book);
+            Types_.push_back(type);
+            Payloads_.push_back(static_cast<std::uint32_t>(payload));
+        }
+
+        template <typename TBook>
+        void Apply(TBook& book, std::size_t index) {
+            const std::uint32_t payload = Payloads_[index];
+
+            switch (Types_[index]) {
+                case Models::UpdateType::Depth: {
+                    const auto& depth = Depths_[payload];
+                    const std::span<const TPriceQuantity> levels(Levels_.data() + depth.Offset,
+                                                                 depth.BidsCount + depth.AsksCount);
+                    book.DepthUpdate(levels.first(depth.BidsCount), levels.last(depth.AsksCount));
+                    break;
+                }
+                case Models::UpdateType::BBO:
+                    book.BBOUpdate(Tickers_[payload]);
+                    break;
+            }
+        }
+    };
+
+}
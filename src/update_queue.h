@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+
+#include "models/book_update.h"
+#include "utils/spsc_queue.h"
+
+namespace OrderBook {
+
+    // Queue of decoded updates between the decoder thread (producer) and the thread owning the book (consumer).
+    template <typename TPrice, typename TQuantity, std::size_t PriceLevels = 20, std::size_t Capacity = 1024>
+    using UpdateQueue = Utils::SpscQueue<Models::BookUpdate<TPrice, TQuantity, PriceLevels>, Capacity>;
+
+    // Apply a single decoded update to the book.
+    template <typename TBook, typename TPrice, typename TQuantity, std::size_t PriceLevels>
+    void ApplyUpdate(TBook& book, const Models::BookUpdate<TPrice, TQuantity, PriceLevels>& update) {
+        switch (update.Type) {
+            case Models::UpdateType::Depth:
+                book.DepthUpdate(update.GetBids(), update.GetAsks());
+                break;
+            case Models::UpdateType::BBO:
+                book.BBOUpdate(update.Ticker);
+                break;
+        }
+    }
+
+    /*
+     * Consumer loop step: apply up to maxBatch queued updates to the book in the order they were pushed.
+     * `onApplied(update)` is called after each update is applied, e.g. to track the latency.
+     * Returns the number of applied updates, 0 means the queue was empty.
+    */
+    template <typename TBook, typename TQueue, typename TOnApplied>
+    std::size_t DrainUpdates(TQueue& queue, TBook& book, std::size_t maxBatch, TOnApplied&& onApplied) {
+        return queue.ConsumeBatch([&](const auto& update) {
+            ApplyUpdate(book, update);
+            onApplied(update);
+        }, maxBatch);
+    }
+
+    template <typename TBook, typename TQueue>
+    std::size_t DrainUpdates(TQueue& queue, TBook& book, std::size_t maxBatch = 64) {
+        return DrainUpdates(queue, book, maxBatch, [](const auto&) {});
+    }
+
+}
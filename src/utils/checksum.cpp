@@ -0,0 +1 @@
+#include "checksum.h"
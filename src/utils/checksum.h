@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace OrderBook::Utils {
+
+    inline constexpr std::uint64_t Fnv1aOffsetBasis = 14695981039346656037ull;
+    inline constexpr std::uint64_t Fnv1aPrime = 1099511628211ull;
+
+    // 64-bit FNV-1a hash of the bytes, continuing from the given hash.
+    inline std::uint64_t Fnv1a(const void* data, std::size_t size, std::uint64_t hash = Fnv1aOffsetBasis) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * Fnv1aPrime;
+        }
+
+        return hash;
+    }
+
+    template <typename T>
+    std::uint64_t Fnv1a(const T& value, std::uint64_t hash = Fnv1aOffsetBasis) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return Fnv1a(&value, sizeof(value), hash);
+    }
+
+    /*
+     * FNV-1a over 64-bit words instead of bytes, about eight times faster on large blocks, e.g. checkpoint records.
+     * A word multiplied by the prime affects only the bits above its own ones, so the high half is folded back
+     * after every step. Trailing bytes which don't fill a word are hashed one by one.
+    */
+    inline std::uint64_t Fnv1aWords(const void* data, std::size_t size, std::uint64_t hash = Fnv1aOffsetBasis) noexcept {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        const std::size_t words = size / sizeof(std::uint64_t);
+
+        for (std::size_t i = 0; i < words; ++i) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i * sizeof(word), sizeof(word));
+
+            hash = (hash ^ word) * Fnv1aPrime;
+            hash ^= hash >> 32;
+        }
+
+        return Fnv1a(bytes + words * sizeof(std::uint64_t), size % sizeof(std::uint64_t), hash);
+    }
+
+    /*
+     * Checksum of the book content: prices and quantities of all bids and then all asks in the book order.
+     * Books with the same levels have the same checksum, so it can be used to compare runs of the same input.
+    */
+    template <typename TBook>
+    std::uint64_t BookChecksum(const TBook& book) {
+        auto [bids, asks] = book.Levels();
+
+        std::uint64_t hash = Fnv1aOffsetBasis;
+        for (auto level : bids) {
+            hash = Fnv1a(level.Price, hash);
+            hash = Fnv1a(level.Quantity, hash);
+        }
+
+        // Separates the sides, so moving the last bid to asks changes the checksum.
+        hash = Fnv1a('|', hash);
+
+        for (auto level : asks) {
+            hash = Fnv1a(level.Price, hash);
+            hash = Fnv1a(level.Quantity, hash);
+        }
+
+        return hash;
+    }
+
+}
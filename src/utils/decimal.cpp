@@ -0,0 +1 @@
+#include "decimal.h"
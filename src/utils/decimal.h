@@ -0,0 +1,112 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+namespace OrderBook::Utils {
+
+    // Largest power of 10 representable in int64_t is 10^18.
+    inline constexpr unsigned MaxDecimalDigits = 18;
+
+    constexpr std::int64_t Pow10(unsigned exponent) {
+        std::int64_t result = 1;
+        for (unsigned i = 0; i < exponent; ++i) {
+            result *= 10;
+        }
+
+        return result;
+    }
+
+    /*
+     * Converts a decimal string (e.g. "20078.54000000") into an integer number of 10^-decimals units.
+     * The exchange sends prices and quantities as strings with a fixed number of fractional digits,
+     * so the conversion is exact and never goes through a floating-point value.
+     *
+     * Fractional digits beyond the requested scale are accepted only if they are zeros,
+     * otherwise the value cannot be represented exactly and std::nullopt is returned.
+     * std::nullopt is also returned for empty input, unexpected characters and overflow.
+    */
+    constexpr std::optional<std::int64_t> ParseDecimal(std::string_view text, unsigned decimals) noexcept {
+        if (text.empty() || decimals > MaxDecimalDigits) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const char* it = text.data();
+        const char* const end = it + text.size();
+
+        const bool negative = *it == '-';
+        if (negative || *it == '+') {
+            ++it;
+        }
+
+        const auto multiplier = static_cast<std::uint64_t>(Pow10(decimals));
+        const auto maxIntegral = static_cast<std::uint64_t>(INT64_MAX) / multiplier;
+
+        std::uint64_t integral = 0;
+        unsigned digits = 0;
+
+        for (; it != end && *it >= '0' && *it <= '9'; ++it, ++digits) {
+            const auto digit = static_cast<unsigned>(*it - '0');
+
+            // Leading zeros never overflow, the check is exact for any number of digits.
+            if (integral > (maxIntegral - digit) / 10) [[unlikely]] {
+                return std::nullopt;
+            }
+            integral = integral * 10 + digit;
+        }
+
+        std::uint64_t fractional = 0;
+        unsigned fractionalDigits = 0;
+
+        if (it != end && *it == '.') {
+            ++it;
+
+            for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+                if (fractionalDigits < decimals) {
+                    fractional = fractional * 10 + static_cast<unsigned>(*it - '0');
+                    ++fractionalDigits;
+                }
+                // Extra digits can be dropped only if they don't carry any value.
+                else if (*it != '0') [[unlikely]] {
+                    return std::nullopt;
+                }
+            }
+        }
+
+        if (it != end || (digits == 0 && fractionalDigits == 0)) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const std::uint64_t value = integral * multiplier
+                                    + fractional * static_cast<std::uint64_t>(Pow10(decimals - fractionalDigits));
+        if (value > static_cast<std::uint64_t>(INT64_MAX)) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        return negative ? -static_cast<std::int64_t>(value) : static_cast<std::int64_t>(value);
+    }
+
+    /*
+     * Converts a decimal string into a price/quantity representation used by the book:
+     * floating-point and integral types go through std::from_chars,
+     * while fixed-point types (see Models::FixedPoint) provide their own exact Parse.
+    */
+    template <typename T>
+    std::optional<T> FromDecimal(std::string_view text) noexcept {
+        if constexpr (std::is_arithmetic_v<T>) {
+            T value{};
+            const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+            if (error != std::errc() || end != text.data() + text.size()) [[unlikely]] {
+                return std::nullopt;
+            }
+
+            return value;
+        } else {
+            return T::Parse(text);
+        }
+    }
+
+}
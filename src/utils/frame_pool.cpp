@@ -0,0 +1 @@
+#include "frame_pool.h"
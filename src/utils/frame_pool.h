@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace OrderBook::Utils {
+
+    // Counts of FramePool allocations, see FramePool::Counters.
+    struct FramePoolCounters {
+        std::uint64_t Allocations{};         // blocks handed out, including the oversized ones
+        std::uint64_t UpstreamAllocations{}; // calls of the global operator new: new chunks and oversized blocks
+    };
+
+    /*
+     * A pool of coroutine frames (see Generator): blocks of a few size classes are kept in free lists,
+     * so frames of the same coroutines created and destroyed again and again reuse the same blocks and
+     * the steady state allocates nothing. Blocks are carved from chunks taken from the global operator new,
+     * blocks larger than the largest class go straight to it.
+     *
+     * Every thread has its own pool (see Local) without any synchronization. A block may be freed by another
+     * thread than the one which allocated it, it then joins the free list of the freeing thread. So chunks
+     * are never returned while the process runs, they are owned by a process-wide list and released at exit.
+    */
+    class FramePool : public std::pmr::memory_resource {
+        static constexpr std::size_t MinBlockSize = 64;
+        static constexpr std::size_t ClassesCount = 6; // 64 .. 2048 bytes
+        static constexpr std::size_t ChunkSize = 16 * 1024;
+
+    public:
+        static constexpr std::size_t MaxBlockSize = MinBlockSize << (ClassesCount - 1);
+
+    private:
+        struct FreeBlock {
+            FreeBlock* Next;
+        };
+
+        // Chunks of all pools, released at exit.
+        class Chunks {
+            std::mutex Mutex_;
+            std::vector<void*> Chunks_;
+
+        public:
+            ~Chunks() {
+                for (void* chunk : Chunks_) {
+                    ::operator delete(chunk, std::align_val_t{alignof(std::max_align_t)});
+                }
+            }
+
+            void* Allocate() {
+                void* chunk = ::operator new(ChunkSize, std::align_val_t{alignof(std::max_align_t)});
+
+                const std::lock_guard lock(Mutex_);
+                Chunks_.push_back(chunk);
+
+                return chunk;
+            }
+        };
+
+        std::array<FreeBlock*, ClassesCount> Free_{};
+        FramePoolCounters Counters_;
+
+    public:
+        FramePool() = default;
+
+        FramePool(const FramePool&) = delete;
+        FramePool& operator=(const FramePool&) = delete;
+
+        // The pool of the calling thread.
+        static FramePool& Local() noexcept {
+            thread_local FramePool pool;
+            return pool;
+        }
+
+        // Allocations made by this pool so far.
+        [[nodiscard]]
+        const FramePoolCounters& Counters() const noexcept {
+            return Counters_;
+        }
+
+    private:
+        static Chunks& AllChunks() {
+            static Chunks chunks;
+            return chunks;
+        }
+
+        static constexpr std::size_t ClassOf(std::size_t size) noexcept {
+            return size <= MinBlockSize ? 0 : std::bit_width((size - 1) / MinBlockSize);
+        }
+
+        void* do_allocate(std::size_t size, std::size_t alignment) override {
+            ++Counters_.Allocations;
+
+            if (size > MaxBlockSize || alignment > alignof(std::max_align_t)) [[unlikely]] {
+                ++Counters_.UpstreamAllocations;
+                return ::operator new(size, std::align_val_t{alignment});
+            }
+
+            auto& free = Free_[ClassOf(size)];
+            if (free == nullptr) [[unlikely]] {
+                Refill(ClassOf(size));
+            }
+
+            FreeBlock* block = free;
+            free = block->Next;
+
+            return block;
+        }
+
+        void do_deallocate(void* pointer, std::size_t size, std::size_t alignment) override {
+            if (size > MaxBlockSize || alignment > alignof(std::max_align_t)) [[unlikely]] {
+                ::operator delete(pointer, size, std::align_val_t{alignment});
+                return;
+            }
+
+            auto& free = Free_[ClassOf(size)];
+            free = ::new (pointer) FreeBlock{free};
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            // Blocks of any pool can be returned to any other one.
+            return dynamic_cast<const FramePool*>(&other) != nullptr;
+        }
+
+        void Refill(std::size_t sizeClass) {
+            const std::size_t blockSize = MinBlockSize << sizeClass;
+            auto* chunk = static_cast<std::byte*>(AllChunks().Allocate());
+            ++Counters_.UpstreamAllocations;
+
+            for (std::size_t offset = ChunkSize; offset >= blockSize; offset -= blockSize) {
+                Free_[sizeClass] = ::new (chunk + offset - blockSize) FreeBlock{Free_[sizeClass]};
+            }
+        }
+    };
+
+}
@@ -1,11 +1,17 @@
 #pragma once
 
-#include <experimental/coroutine>
+#include <coroutine>
+#include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 #include <exception>
 #include <iterator>
 #include <functional>
+#include <memory>
+#include <memory_resource>
+
+#include "frame_pool.h"
 
 namespace OrderBook::Utils {
 
@@ -16,6 +22,11 @@ namespace OrderBook::Utils {
      * It acts as the return object and is tightly coupled with the Promise type.
      * The Promise and Iterator components work together to manage the coroutine state and expose the yielded values
      * to the client code.
+     *
+     * Frames are allocated from the FramePool of the calling thread, so a generator created again and again
+     * (e.g. the ones of BinanceBook::Extract) doesn't touch the global heap in the steady state.
+     * A coroutine taking `std::allocator_arg, std::pmr::polymorphic_allocator<>` as its first parameters
+     * (after the object for member functions) allocates its frame from the resource of the allocator instead.
      * */
     template <typename T>
     class Generator {
@@ -26,17 +37,45 @@ namespace OrderBook::Utils {
         struct Promise {
             T value_;
 
+            // Frames are allocated with a trailer keeping their resource, nullptr stands for the thread pool.
+            static void* operator new(std::size_t size) {
+                return Allocate(size, nullptr);
+            }
+
+            template <typename... TArgs>
+            static void* operator new(std::size_t size, std::allocator_arg_t, std::pmr::polymorphic_allocator<> allocator,
+                                      TArgs&...) {
+                return Allocate(size, allocator.resource());
+            }
+
+            template <typename TThis, typename... TArgs>
+            static void* operator new(std::size_t size, TThis&, std::allocator_arg_t,
+                                      std::pmr::polymorphic_allocator<> allocator, TArgs&...) {
+                return Allocate(size, allocator.resource());
+            }
+
+            static void operator delete(void* frame, std::size_t size) noexcept {
+                std::pmr::memory_resource* resource;
+                std::memcpy(&resource, static_cast<std::byte*>(frame) + TrailerOffset(size), sizeof(resource));
+
+                if (resource == nullptr) {
+                    resource = &FramePool::Local();
+                }
+
+                resource->deallocate(frame, FrameSize(size), alignof(std::max_align_t));
+            }
+
             auto get_return_object() -> Generator {
-                using Handle = std::experimental::coroutine_handle<Promise>;
+                using Handle = std::coroutine_handle<Promise>;
                 return Generator{Handle::from_promise(*this)};
             }
 
             auto initial_suspend() {
-                return std::experimental::suspend_always(); // coroutine is suspended from the very beginning
+                return std::suspend_always(); // coroutine is suspended from the very beginning
             }
 
             auto final_suspend() noexcept {
-                return std::experimental::suspend_always(); // coroutine is suspended in the end of execution
+                return std::suspend_always(); // coroutine is suspended in the end of execution
             }
 
             void return_void() {
@@ -48,12 +87,30 @@ namespace OrderBook::Utils {
 
             auto yield_value(T&& value) {
                 value_ = std::move(value);
-                return std::experimental::suspend_always();
+                return std::suspend_always();
             }
 
             auto yield_value(const T& value) {
                 value_ = value;
-                return std::experimental::suspend_always();
+                return std::suspend_always();
+            }
+
+        private:
+            static constexpr std::size_t TrailerOffset(std::size_t size) noexcept {
+                return (size + alignof(std::pmr::memory_resource*) - 1) / alignof(std::pmr::memory_resource*)
+                       * alignof(std::pmr::memory_resource*);
+            }
+
+            static constexpr std::size_t FrameSize(std::size_t size) noexcept {
+                return TrailerOffset(size) + sizeof(std::pmr::memory_resource*);
+            }
+
+            static void* Allocate(std::size_t size, std::pmr::memory_resource* resource) {
+                auto* owner = resource != nullptr ? resource : &FramePool::Local();
+                auto* frame = static_cast<std::byte*>(owner->allocate(FrameSize(size), alignof(std::max_align_t)));
+                std::memcpy(frame + TrailerOffset(size), &resource, sizeof(resource));
+
+                return frame;
             }
         };
 
@@ -70,7 +127,7 @@ namespace OrderBook::Utils {
             using pointer = T*;
             using reference = T&;
 
-            std::experimental::coroutine_handle<Promise> Handle_;
+            std::coroutine_handle<Promise> Handle_;
 
             Iterator& operator++() {
                 Handle_.resume();
@@ -94,9 +151,9 @@ namespace OrderBook::Utils {
             }
         };
 
-        std::experimental::coroutine_handle<Promise> Handle_;
+        std::coroutine_handle<Promise> Handle_;
 
-        explicit Generator(std::experimental::coroutine_handle<Promise> handle) : Handle_(handle) {
+        explicit Generator(std::coroutine_handle<Promise> handle) : Handle_(handle) {
         }
 
     public:
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace OrderBook::Utils {
+
+    /*
+     * A histogram of 64-bit values with logarithmic buckets (the HDR histogram layout):
+     * values below 2^SubBucketBits have their own buckets, larger values are grouped by the position of the highest
+     * set bit and split into 2^SubBucketBits linear sub-buckets, so the relative error is below 2^-SubBucketBits
+     * over the whole range, with a fixed number of buckets.
+     *
+     * Recording is a single increment without a lock prefix, there must be a single writer.
+     * Any thread may take a Snapshot concurrently, counters are loaded one by one, so a snapshot taken
+     * during recording may miss the latest values but never sees torn counters.
+    */
+    template <unsigned SubBucketBits = 3>
+    class LogHistogram {
+        static constexpr std::size_t SubBuckets = std::size_t{1} << SubBucketBits;
+
+    public:
+        static constexpr std::size_t BucketsCount = (64 - SubBucketBits + 1) * SubBuckets;
+
+        static constexpr std::size_t BucketOf(std::uint64_t value) noexcept {
+            if (value < SubBuckets) {
+                return value;
+            }
+
+            const unsigned magnitude = std::bit_width(value) - 1;
+            const unsigned shift = magnitude - SubBucketBits;
+            const auto subBucket = static_cast<std::size_t>(value >> shift) & (SubBuckets - 1);
+
+            return (shift + 1) * SubBuckets + subBucket;
+        }
+
+        // The largest value falling into the bucket.
+        static constexpr std::uint64_t BucketUpperBound(std::size_t bucket) noexcept {
+            if (bucket < SubBuckets) {
+                return bucket;
+            }
+
+            const std::size_t shift = bucket / SubBuckets - 1;
+            const std::uint64_t lowerBound = (SubBuckets + bucket % SubBuckets) << shift;
+
+            return lowerBound + ((std::uint64_t{1} << shift) - 1);
+        }
+
+        // Plain copy of the counters.
+        struct Snapshot {
+            std::array<std::uint64_t, BucketsCount> Counts{};
+
+            [[nodiscard]]
+            std::uint64_t Count() const noexcept {
+                std::uint64_t count = 0;
+                for (auto bucketCount : Counts) {
+                    count += bucketCount;
+                }
+
+                return count;
+            }
+
+            // Upper bound of the bucket containing the given percentile (0-100), 0 for an empty histogram.
+            [[nodiscard]]
+            std::uint64_t Percentile(double percentile) const noexcept {
+                const std::uint64_t count = Count();
+                if (count == 0) {
+                    return 0;
+                }
+
+                // Rank of the value among the sorted values starting from 1.
+                auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5);
+                rank = rank == 0 ? 1 : (rank > count ? count : rank);
+
+                std::uint64_t seen = 0;
+                for (std::size_t bucket = 0; bucket < BucketsCount; ++bucket) {
+                    seen += Counts[bucket];
+                    if (seen >= rank) {
+                        return BucketUpperBound(bucket);
+                    }
+                }
+
+                return BucketUpperBound(BucketsCount - 1);
+            }
+
+            [[nodiscard]]
+            std::uint64_t Max() const noexcept {
+                for (std::size_t bucket = BucketsCount; bucket > 0; --bucket) {
+                    if (Counts[bucket - 1] != 0) {
+                        return BucketUpperBound(bucket - 1);
+                    }
+                }
+
+                return 0;
+            }
+
+            // Remove the values counted in the baseline (an earlier snapshot of the same histogram).
+            Snapshot& operator-=(const Snapshot& baseline) noexcept {
+                for (std::size_t bucket = 0; bucket < BucketsCount; ++bucket) {
+                    Counts[bucket] -= baseline.Counts[bucket];
+                }
+
+                return *this;
+            }
+        };
+
+    private:
+        std::array<std::atomic<std::uint64_t>, BucketsCount> Counts_{};
+
+    public:
+        // Writer side.
+        void Record(std::uint64_t value) noexcept {
+            auto& counter = Counts_[BucketOf(value)];
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        // Reader side.
+        [[nodiscard]]
+        Snapshot Load() const noexcept {
+            Snapshot snapshot;
+            for (std::size_t bucket = 0; bucket < BucketsCount; ++bucket) {
+                snapshot.Counts[bucket] = Counts_[bucket].load(std::memory_order_relaxed);
+            }
+
+            return snapshot;
+        }
+    };
+
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace OrderBook::Utils {
+
+    inline constexpr std::size_t HugePageSize = std::size_t{2} << 20;
+
+    // Pages backing a MemoryRegion, from the best for TLB to the worst.
+    enum class PageKind : std::uint8_t {
+        Huge,        // explicit 2MB pages from the reserved pool (MAP_HUGETLB)
+        Transparent, // regular mapping advised to be backed by transparent huge pages, not guaranteed
+        Regular,     // 4KB pages
+    };
+
+    inline const char* ToString(PageKind kind) noexcept {
+        switch (kind) {
+            case PageKind::Huge:
+                return "huge";
+            case PageKind::Transparent:
+                return "transparent";
+            case PageKind::Regular:
+                return "regular";
+        }
+
+        return "unknown";
+    }
+
+    /*
+     * An anonymous memory mapping owned by the object, preferably backed by 2MB pages.
+     *
+     * Explicit huge pages are tried first, they exist only if the administrator has reserved them
+     * (vm.nr_hugepages). Otherwise the region falls back to regular pages advised for transparent huge pages,
+     * or to plain regular pages if huge pages are disabled. The size is rounded up to the page size.
+     *
+     * Pages are not touched by the constructor, so the placement of the region (see BindToNumaNode) takes effect
+     * when the owner touches them first.
+    */
+    class MemoryRegion {
+        void* Data_ = nullptr;
+        std::size_t Size_ = 0;
+        PageKind Kind_ = PageKind::Regular;
+
+    public:
+        MemoryRegion() = default;
+
+        // Throws std::system_error if the memory can't be mapped at all.
+        explicit MemoryRegion(std::size_t size, bool useHugePages = true) {
+#if defined(__linux__)
+            if (useHugePages) {
+                Size_ = RoundUp(size, HugePageSize);
+                Data_ = Map(Size_, MAP_HUGETLB);
+                Kind_ = PageKind::Huge;
+
+                if (Data_ == nullptr) {
+                    Data_ = Map(Size_, 0);
+                    Kind_ = Data_ != nullptr && madvise(Data_, Size_, MADV_HUGEPAGE) == 0 ? PageKind::Transparent
+                                                                                          : PageKind::Regular;
+                }
+            } else {
+                Size_ = RoundUp(size, static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+                Data_ = Map(Size_, 0);
+                Kind_ = PageKind::Regular;
+            }
+
+            if (Data_ == nullptr) {
+                throw std::system_error(errno, std::generic_category(), "Failed to map memory region");
+            }
+#else
+            (void)size;
+            (void)useHugePages;
+            throw std::system_error(std::make_error_code(std::errc::not_supported), "Memory regions require Linux");
+#endif
+        }
+
+        MemoryRegion(MemoryRegion&& rhs) noexcept
+            : Data_(std::exchange(rhs.Data_, nullptr)), Size_(std::exchange(rhs.Size_, 0)), Kind_(rhs.Kind_) {
+        }
+
+        MemoryRegion& operator=(MemoryRegion&& rhs) noexcept {
+            if (this != &rhs) {
+                Release();
+                Data_ = std::exchange(rhs.Data_, nullptr);
+                Size_ = std::exchange(rhs.Size_, 0);
+                Kind_ = rhs.Kind_;
+            }
+
+            return *this;
+        }
+
+        MemoryRegion(const MemoryRegion&) = delete;
+        MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+        ~MemoryRegion() {
+            Release();
+        }
+
+        [[nodiscard]]
+        void* Data() const noexcept {
+            return Data_;
+        }
+
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return Size_;
+        }
+
+        [[nodiscard]]
+        PageKind Kind() const noexcept {
+            return Kind_;
+        }
+
+        /*
+         * Allocate the pages of the region on the given NUMA node when they are touched first
+         * (pages already touched are moved if possible). Uses the mbind system call directly,
+         * so libnuma is not needed. Returns false if the binding is not supported or the node doesn't exist,
+         * the region stays usable with the default placement.
+        */
+        bool BindToNumaNode(int node) noexcept {
+#if defined(__linux__) && defined(SYS_mbind)
+            constexpr int BindPolicy = 2;     // MPOL_BIND
+            constexpr unsigned MoveFlag = 2;  // MPOL_MF_MOVE
+            constexpr int MaxNode = 64;       // nodes of a single mask word
+
+            if (Data_ == nullptr || node < 0 || node >= MaxNode) {
+                return false;
+            }
+
+            const unsigned long mask = 1ul << node;
+            return syscall(SYS_mbind, Data_, Size_, BindPolicy, &mask, MaxNode + 1, MoveFlag) == 0;
+#else
+            (void)node;
+            return false;
+#endif
+        }
+
+    private:
+        static std::size_t RoundUp(std::size_t size, std::size_t alignment) noexcept {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+
+#if defined(__linux__)
+        static void* Map(std::size_t size, int flags) noexcept {
+            void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+            return data != MAP_FAILED ? data : nullptr;
+        }
+#endif
+
+        void Release() noexcept {
+#if defined(__linux__)
+            if (Data_ != nullptr) {
+                munmap(Data_, Size_);
+            }
+#endif
+            Data_ = nullptr;
+            Size_ = 0;
+        }
+    };
+
+    // NUMA node of the core the calling thread is running on, -1 if unknown.
+    // Call it after pinning the thread (see PinCurrentThread) to get the node of the pinned core.
+    inline int CurrentNumaNode() noexcept {
+#if defined(__linux__) && defined(SYS_getcpu)
+        unsigned cpu = 0;
+        unsigned node = 0;
+        if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+            return static_cast<int>(node);
+        }
+#endif
+        return -1;
+    }
+
+}
@@ -0,0 +1 @@
+#include "seq_lock.h"
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace OrderBook::Utils {
+
+    /*
+     * A single-writer slot publishing values of T to any number of concurrent readers.
+     *
+     * The writer never waits for readers: it makes the sequence odd, overwrites the value and makes the sequence
+     * even again. A reader copies the value and checks that the sequence was the same even number before
+     * and after the copy, otherwise the copy could be torn and is discarded.
+     * Readers never write to the slot, so they don't contend with each other or slow down the writer.
+     *
+     * The sequence and the value start on their own cache line to avoid false sharing with neighbouring slots.
+    */
+    template <typename T>
+    class alignas(64) SeqLock {
+        static_assert(std::is_trivially_copyable_v<T>, "Values are copied while they can be overwritten");
+
+        std::atomic<std::uint64_t> Sequence_ = 0;
+        T Value_{};
+
+    public:
+        // Writer side. Modify the value in place with `writer(value)`.
+        template <typename TWriter>
+        void Update(TWriter&& writer) noexcept {
+            const std::uint64_t sequence = Sequence_.load(std::memory_order_relaxed);
+
+            Sequence_.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            writer(Value_);
+
+            Sequence_.store(sequence + 2, std::memory_order_release);
+        }
+
+        // Writer side.
+        void Store(const T& value) noexcept {
+            Update([&value](T& slot) {
+                slot = value;
+            });
+        }
+
+        // Reader side. Make a single attempt to copy a consistent value, never waits.
+        // Returns false if the value was being written at the moment.
+        bool TryLoad(T& value) const noexcept {
+            const std::uint64_t before = Sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                return false;
+            }
+
+            std::memcpy(&value, &Value_, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            return Sequence_.load(std::memory_order_relaxed) == before;
+        }
+
+        /*
+         * Reader side. Call `reader(value)` on the value in place, without copying it, and return whether
+         * the value was consistent all along. The value may be overwritten while the reader looks at it,
+         * so the reader must stay within bounds whatever it sees and its results are valid only if true is returned.
+        */
+        template <typename TReader>
+        bool TryRead(TReader&& reader) const noexcept {
+            const std::uint64_t before = Sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                return false;
+            }
+
+            reader(Value_);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            return Sequence_.load(std::memory_order_relaxed) == before;
+        }
+
+        // Reader side. Copy a consistent value retrying while it is being written.
+        T Load() const noexcept {
+            T value;
+            while (!TryLoad(value)) {
+            }
+
+            return value;
+        }
+
+        // Number of completed writes, can be used by readers to check if the value has changed.
+        [[nodiscard]]
+        std::uint64_t Version() const noexcept {
+            return Sequence_.load(std::memory_order_acquire) / 2;
+        }
+    };
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace OrderBook::Utils {
+
+    /*
+     * A bounded lock-free queue for exactly one producer thread and one consumer thread.
+     *
+     * Records are stored in a preallocated ring, so neither pushing nor popping allocates.
+     * The head (consumer position) and the tail (producer position) live on separate cache lines,
+     * and each side keeps a cached copy of the other side's position, so the shared cache lines are
+     * only touched when the cached value says the queue looks full or empty.
+     *
+     * Capacity must be a power of 2, one slot is never used to distinguish a full queue from an empty one.
+    */
+    template <typename T, std::size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+        static constexpr std::size_t CacheLineSize = 64;
+        static constexpr std::size_t Mask = Capacity - 1;
+
+        alignas(CacheLineSize) std::atomic<std::size_t> Head_ = 0; // written by the consumer
+        std::size_t CachedTail_ = 0;                                // consumer's copy of Tail_
+
+        alignas(CacheLineSize) std::atomic<std::size_t> Tail_ = 0; // written by the producer
+        std::size_t CachedHead_ = 0;                                // producer's copy of Head_
+
+        alignas(CacheLineSize) std::array<T, Capacity> Records_;
+
+    public:
+        SpscQueue() = default;
+
+        SpscQueue(const SpscQueue&) = delete;
+        SpscQueue& operator=(const SpscQueue&) = delete;
+
+        // Producer side. Fill the next record in place with `writer(record)` and publish it.
+        // Returns false without calling the writer if the queue is full.
+        template <typename TWriter>
+        bool TryPushWith(TWriter&& writer) {
+            const std::size_t tail = Tail_.load(std::memory_order_relaxed);
+            const std::size_t next = (tail + 1) & Mask;
+
+            if (next == CachedHead_) {
+                CachedHead_ = Head_.load(std::memory_order_acquire);
+                if (next == CachedHead_) {
+                    return false;
+                }
+            }
+
+            writer(Records_[tail]);
+            Tail_.store(next, std::memory_order_release);
+
+            return true;
+        }
+
+        // Producer side.
+        bool TryPush(const T& record) {
+            return TryPushWith([&record](T& slot) {
+                slot = record;
+            });
+        }
+
+        /*
+         * Consumer side. Pass up to maxCount available records to `consumer(record)` in order
+         * and release their slots to the producer at once. Returns the number of consumed records.
+        */
+        template <typename TConsumer>
+        std::size_t ConsumeBatch(TConsumer&& consumer, std::size_t maxCount = Capacity) {
+            const std::size_t head = Head_.load(std::memory_order_relaxed);
+
+            if (head == CachedTail_) {
+                CachedTail_ = Tail_.load(std::memory_order_acquire);
+                if (head == CachedTail_) {
+                    return 0;
+                }
+            }
+
+            const std::size_t available = (CachedTail_ - head) & Mask;
+            const std::size_t count = available < maxCount ? available : maxCount;
+
+            for (std::size_t i = 0; i < count; ++i) {
+                consumer(std::as_const(Records_[(head + i) & Mask]));
+            }
+
+            Head_.store((head + count) & Mask, std::memory_order_release);
+
+            return count;
+        }
+
+        // Consumer side.
+        bool TryPop(T& record) {
+            return ConsumeBatch([&record](const T& slot) {
+                record = slot;
+            }, 1) == 1;
+        }
+
+        // Approximate number of records in the queue, exact only when called by one of the sides while the other is idle.
+        [[nodiscard]]
+        std::size_t Size() const noexcept {
+            return (Tail_.load(std::memory_order_acquire) - Head_.load(std::memory_order_acquire)) & Mask;
+        }
+    };
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+#include "frame_pool.h"
+
+namespace OrderBook::Utils {
+
+    /*
+     * The return type of coroutines which run on their own, driven by the events they await
+     * (e.g. messages of Ingest::IngestionEngine), rather than pulled by the caller like a Generator.
+     *
+     * The coroutine starts running when it is called and keeps running until its first suspension,
+     * then it is resumed by whatever it awaits. The Task owns the frame: destroying the Task destroys
+     * the coroutine, wherever it is suspended. An exception leaving the coroutine completes it and is rethrown
+     * by RethrowIfFailed. Frames are allocated from the FramePool of the calling thread, like those of Generator.
+    */
+    class Task {
+    public:
+        struct promise_type {
+            std::exception_ptr Exception_;
+
+            static void* operator new(std::size_t size) {
+                return FramePool::Local().allocate(size, alignof(std::max_align_t));
+            }
+
+            static void operator delete(void* frame, std::size_t size) noexcept {
+                FramePool::Local().deallocate(frame, size, alignof(std::max_align_t));
+            }
+
+            Task get_return_object() noexcept {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_never initial_suspend() noexcept {
+                return {};
+            }
+
+            std::suspend_always final_suspend() noexcept {
+                return {}; // the frame stays until the Task is destroyed, so Done can be queried
+            }
+
+            void return_void() noexcept {
+            }
+
+            void unhandled_exception() noexcept {
+                Exception_ = std::current_exception();
+            }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> Handle_;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept : Handle_(handle) {
+        }
+
+    public:
+        Task() = default;
+
+        Task(Task&& rhs) noexcept : Handle_(std::exchange(rhs.Handle_, nullptr)) {
+        }
+
+        Task& operator=(Task&& rhs) noexcept {
+            if (this != &rhs) {
+                Destroy();
+                Handle_ = std::exchange(rhs.Handle_, nullptr);
+            }
+
+            return *this;
+        }
+
+        ~Task() {
+            Destroy();
+        }
+
+        // Whether the coroutine has completed, normally or with an exception.
+        [[nodiscard]]
+        bool Done() const noexcept {
+            return !Handle_ || Handle_.done();
+        }
+
+        void RethrowIfFailed() const {
+            if (Handle_ && Handle_.promise().Exception_) {
+                std::rethrow_exception(Handle_.promise().Exception_);
+            }
+        }
+
+    private:
+        void Destroy() noexcept {
+            if (Handle_) {
+                Handle_.destroy();
+                Handle_ = nullptr;
+            }
+        }
+    };
+
+}
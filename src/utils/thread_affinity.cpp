@@ -0,0 +1 @@
+#include "thread_affinity.h"
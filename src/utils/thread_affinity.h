@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace OrderBook::Utils {
+
+    // Number of cores available to the process (at least 1).
+    inline std::size_t CoresCount() noexcept {
+        const auto count = std::thread::hardware_concurrency();
+        return count != 0 ? count : 1;
+    }
+
+    // Pin the calling thread to the given core.
+    // Returns false if pinning failed or is not supported by the platform, the thread keeps running anyway.
+    inline bool PinCurrentThread(std::size_t core) noexcept {
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+
+        return pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0;
+#else
+        (void)core;
+        return false;
+#endif
+    }
+
+}
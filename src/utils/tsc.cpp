@@ -0,0 +1 @@
+#include "tsc.h"
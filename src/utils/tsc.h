@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace OrderBook::Utils {
+
+    // Read the time stamp counter, a cheap monotonic clock for measuring short intervals.
+    // Falls back to the steady clock in nanoseconds on platforms without TSC.
+    inline std::uint64_t ReadTsc() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+    }
+
+    // Number of TSC ticks per nanosecond, measured against the steady clock on the first call (takes ~10ms).
+    inline double TscTicksPerNanosecond() {
+        static const double ticksPerNanosecond = []() {
+            const auto startTime = std::chrono::steady_clock::now();
+            const auto startTsc = ReadTsc();
+
+            while (std::chrono::steady_clock::now() - startTime < std::chrono::milliseconds(10)) {
+            }
+
+            const auto elapsed = std::chrono::steady_clock::now() - startTime;
+            const auto ticks = ReadTsc() - startTsc;
+
+            return static_cast<double>(ticks) / static_cast<double>(std::chrono::nanoseconds(elapsed).count());
+        }();
+
+        return ticksPerNanosecond;
+    }
+
+}
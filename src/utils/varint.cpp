@@ -0,0 +1 @@
+#include "varint.h"
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace OrderBook::Utils {
+
+    // Longest encoding of a 64-bit value: 7 bits per byte.
+    inline constexpr std::size_t MaxVarintSize = 10;
+
+    // Map signed values to unsigned ones so that values close to zero stay small: 0, -1, 1, -2 -> 0, 1, 2, 3.
+    constexpr std::uint64_t ZigZagEncode(std::int64_t value) noexcept {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    constexpr std::int64_t ZigZagDecode(std::uint64_t value) noexcept {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    // Write the value as a LEB128 varint, the buffer must have room for MaxVarintSize bytes.
+    // Returns the position after the written bytes.
+    inline std::byte* WriteVarint(std::byte* out, std::uint64_t value) noexcept {
+        while (value >= 0x80) {
+            *out++ = static_cast<std::byte>(value | 0x80);
+            value >>= 7;
+        }
+
+        *out++ = static_cast<std::byte>(value);
+        return out;
+    }
+
+    // Read a varint written by WriteVarint and advance the position past it.
+    // Returns std::nullopt if the buffer ends in the middle of the value or the value is longer than 64 bits.
+    inline std::optional<std::uint64_t> ReadVarint(const std::byte*& position, const std::byte* end) noexcept {
+        std::uint64_t value = 0;
+
+        for (unsigned shift = 0; position != end && shift < 64; shift += 7) {
+            const auto byte = std::to_integer<std::uint64_t>(*position++);
+            // The 10th byte carries only the highest bit of the value.
+            if (shift == 63 && byte > 1) [[unlikely]] {
+                return std::nullopt;
+            }
+
+            value |= (byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0) [[likely]] {
+                return value;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    // Read a varint known to be well-formed (e.g. validated by ReadVarint before), without bounds checks.
+    inline std::uint64_t ReadVarintUnchecked(const std::byte*& position) noexcept {
+        std::uint64_t value = 0;
+
+        for (unsigned shift = 0;; shift += 7) {
+            const auto byte = std::to_integer<std::uint64_t>(*position++);
+            value |= (byte & 0x7F) << shift;
+
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+
+}
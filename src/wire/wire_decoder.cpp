@@ -0,0 +1 @@
+#include "wire_decoder.h"
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "wire_format.h"
+
+namespace OrderBook::Wire {
+
+    enum class DecodeStatus : std::uint8_t {
+        Applied,   // the book was updated
+        Malformed, // the message can't be parsed, the book is untouched
+        Stale,     // the message is older than the state of the book (e.g. a duplicate), it was ignored
+        Gap,       // a delta doesn't follow the last applied message, the book waits for the next snapshot
+    };
+
+    /*
+     * Applies wire messages (see wire_format.h) of one stream to a book: snapshots through BinanceBook::Replace
+     * and deltas through BinanceBook::DepthUpdate, levels are decoded straight from the message while the book
+     * consumes them. Deltas are applied only in sequence after a snapshot, once a delta is missed the book keeps
+     * its last state until the next snapshot.
+     *
+     * A consumer book with PriceLevels + 1 levels matches the levels of the encoded book exactly. The encoded book
+     * may show one level more than its PriceLevels (see OrderMap), so a consumer of the same depth may lose
+     * its deepest levels until the next snapshot.
+    */
+    template <typename TPrice, typename TQuantity, typename TPriceTicks, typename TQuantityLots>
+    class WireDecoder {
+        std::uint64_t NextSequence_ = 0;
+        bool Synced_ = false;
+
+    public:
+        DecodeStatus Apply(std::span<const std::byte> bytes, auto& book) {
+            const auto message = ParseMessage<TPrice, TQuantity, TPriceTicks, TQuantityLots>(bytes);
+            if (!message) [[unlikely]] {
+                return DecodeStatus::Malformed;
+            }
+
+            if (Synced_ && message->Sequence < NextSequence_) [[unlikely]] {
+                return DecodeStatus::Stale;
+            }
+
+            if (message->Type == MessageType::Snapshot) {
+                book.Replace(message->Bids, message->Asks);
+            } else if (Synced_ && message->Sequence == NextSequence_) [[likely]] {
+                book.DepthUpdate(message->Bids, message->Asks);
+            } else {
+                Synced_ = false;
+                return DecodeStatus::Gap;
+            }
+
+            Synced_ = true;
+            NextSequence_ = message->Sequence + 1;
+
+            return DecodeStatus::Applied;
+        }
+
+        // Whether deltas can be applied, i.e. a snapshot was applied and no message was missed since.
+        [[nodiscard]]
+        bool IsSynced() const noexcept {
+            return Synced_;
+        }
+
+        // Sequence number of the message expected next.
+        [[nodiscard]]
+        std::uint64_t NextSequence() const noexcept {
+            return NextSequence_;
+        }
+    };
+
+}
@@ -0,0 +1 @@
+#include "wire_encoder.h"
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "wire_format.h"
+#include "../level_events.h"
+#include "../models/price_quantity.h"
+#include "../utils/varint.h"
+
+namespace OrderBook::Wire {
+
+    /*
+     * Encodes the levels of one book into wire messages (see wire_format.h) and numbers them.
+     * Messages are written into caller buffers, which must hold MaxMessageSize of the levels being encoded.
+     * TPriceTicks and TQuantityLots convert prices and quantities into integers (see DecimalTicks),
+     * the values must be multiples of the tick and the lot.
+    */
+    template <typename TPrice, typename TQuantity, typename TPriceTicks, typename TQuantityLots>
+    class WireEncoder {
+        using TLevelEvent = LevelEvent<TPrice, TQuantity>;
+
+        std::uint64_t NextSequence_ = 0;
+
+    public:
+        explicit WireEncoder(std::uint64_t firstSequence = 0) noexcept : NextSequence_(firstSequence) {
+        }
+
+        // Sequence number of the next message.
+        [[nodiscard]]
+        std::uint64_t NextSequence() const noexcept {
+            return NextSequence_;
+        }
+
+        // Encode all levels of the book (see BinanceBook::Levels), returns the size of the message.
+        std::size_t EncodeSnapshot(const auto& book, std::span<std::byte> out) {
+            const auto [bids, asks] = book.Levels();
+            assert(out.size() >= MaxMessageSize(bids.size() + asks.size()));
+
+            const std::int64_t reference = Reference(bids, asks);
+            std::byte* position = WriteHeader(out.data(), MessageType::Snapshot, reference, bids.size(), asks.size());
+
+            for (const auto level : bids) {
+                position = WriteLevel(position, reference, level.Price, level.Quantity);
+            }
+            for (const auto level : asks) {
+                position = WriteLevel(position, reference, level.Price, level.Quantity);
+            }
+
+            return static_cast<std::size_t>(position - out.data());
+        }
+
+        /*
+         * Encode the level events of an update of the book (see BinanceBook::EmitLevelEventsTo), returns the size
+         * of the message. The reference is taken from the book after the update. Events of each side keep their order,
+         * a level may be added and evicted by the same update.
+         * The consumer must take a snapshot instead, if the event buffer needs a resync.
+        */
+        std::size_t EncodeDelta(const auto& book, std::span<const TLevelEvent> events, std::span<std::byte> out) {
+            assert(out.size() >= MaxMessageSize(events.size()));
+
+            std::size_t counts[2] = {};
+            for (const auto& event : events) {
+                counts[event.Side == BookSide::Bids ? 0 : 1] += event.Type != LevelEventType::BestChanged;
+            }
+
+            const auto [bids, asks] = book.Levels();
+            const std::int64_t reference = Reference(bids, asks);
+            std::byte* position = WriteHeader(out.data(), MessageType::Delta, reference, counts[0], counts[1]);
+
+            for (const BookSide side : {BookSide::Bids, BookSide::Asks}) {
+                for (const auto& event : events) {
+                    if (event.Side == side && event.Type != LevelEventType::BestChanged) {
+                        position = WriteLevel(position, reference, event.Price, event.NewQuantity);
+                    }
+                }
+            }
+
+            return static_cast<std::size_t>(position - out.data());
+        }
+
+    private:
+        static std::int64_t Reference(const auto& bids, const auto& asks) noexcept {
+            if (!bids.empty()) {
+                return TPriceTicks::ToTicks(bids.front().Price);
+            }
+
+            return asks.empty() ? 0 : TPriceTicks::ToTicks(asks.front().Price);
+        }
+
+        std::byte* WriteHeader(std::byte* out, MessageType type, std::int64_t reference,
+                               std::size_t bidsCount, std::size_t asksCount) noexcept {
+            *out++ = std::byte{Version};
+            *out++ = static_cast<std::byte>(type);
+            out = Utils::WriteVarint(out, NextSequence_++);
+            out = Utils::WriteVarint(out, Utils::ZigZagEncode(reference));
+            out = Utils::WriteVarint(out, bidsCount);
+            return Utils::WriteVarint(out, asksCount);
+        }
+
+        static std::byte* WriteLevel(std::byte* out, std::int64_t reference, const TPrice& price,
+                                     const TQuantity& quantity) noexcept {
+            const std::int64_t lots = TQuantityLots::ToTicks(quantity);
+            assert(lots >= 0);
+
+            out = Utils::WriteVarint(out, Utils::ZigZagEncode(TPriceTicks::ToTicks(price) - reference));
+            return Utils::WriteVarint(out, static_cast<std::uint64_t>(lots));
+        }
+    };
+
+}
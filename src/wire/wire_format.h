@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <span>
+
+#include "../models/price_quantity.h"
+#include "../utils/varint.h"
+
+namespace OrderBook::Wire {
+
+    /*
+     * Compact binary messages carrying the levels of one book from the book process to its consumers,
+     * written by WireEncoder and applied by WireDecoder.
+     *
+     *   u8      Version
+     *   u8      Type              Snapshot or Delta
+     *   varint  Sequence          incremented by every message of the stream
+     *   zigzag  Reference         the best bid in price ticks (the best ask if there are no bids)
+     *   varint  BidsCount
+     *   varint  AsksCount
+     *   levels  BidsCount bids followed by AsksCount asks, each one is
+     *           zigzag  Price - Reference in ticks
+     *           varint  Quantity in lots, 0 deletes the level (deltas only)
+     *
+     * A snapshot carries all levels of the book in the book order, a delta carries the changed levels
+     * (see LevelEvent). Prices near the top of the book are a few ticks from the reference, so a level
+     * usually takes 2-4 bytes instead of the 16 of a PriceQuantity<double, double>.
+     * The symbol of the book is up to the transport, a message describes a single book.
+    */
+
+    inline constexpr std::uint8_t Version = 1;
+
+    enum class MessageType : std::uint8_t {
+        Snapshot = 1,
+        Delta = 2,
+    };
+
+    // Upper bound of the size of a message carrying the given total number of levels.
+    constexpr std::size_t MaxMessageSize(std::size_t levelsCount) noexcept {
+        return 2 + 4 * Utils::MaxVarintSize + levelsCount * 2 * Utils::MaxVarintSize;
+    }
+
+    /*
+     * A view over the encoded levels of one side of a message. Levels are decoded lazily while the view
+     * is iterated, directly from the message, so the view can be passed straight into BinanceBook::Replace
+     * or BinanceBook::DepthUpdate. The levels must have been validated (see ParseMessage).
+     * TPriceTicks and TQuantityLots convert between values and integers (see DecimalTicks).
+    */
+    template <typename TPrice, typename TQuantity, typename TPriceTicks, typename TQuantityLots>
+    class LevelsView {
+        using TPriceQuantity = Models::PriceQuantity<TPrice, TQuantity>;
+
+        struct Sentinel {};
+
+        class Iterator {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = TPriceQuantity;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const TPriceQuantity*;
+            using reference = const TPriceQuantity&;
+
+        private:
+            const std::byte* Position_ = nullptr; // nullptr marks the end of the range
+            std::size_t Remaining_ = 0;
+            std::int64_t Reference_ = 0;
+            TPriceQuantity Current_;
+
+        public:
+            Iterator() = default;
+
+            Iterator(const std::byte* position, std::size_t count, std::int64_t reference)
+                : Position_(position), Remaining_(count), Reference_(reference) {
+                ReadNext();
+            }
+
+            reference operator*() const {
+                return Current_;
+            }
+
+            pointer operator->() const {
+                return &Current_;
+            }
+
+            Iterator& operator++() {
+                ReadNext();
+                return *this;
+            }
+
+            void operator++(int) {
+                (void)operator++();
+            }
+
+            bool operator==(Sentinel) const {
+                return Position_ == nullptr;
+            }
+
+        private:
+            void ReadNext() {
+                if (Remaining_ == 0) {
+                    Position_ = nullptr;
+                    return;
+                }
+
+                --Remaining_;
+                const auto ticks = Reference_ + Utils::ZigZagDecode(Utils::ReadVarintUnchecked(Position_));
+                const auto lots = static_cast<std::int64_t>(Utils::ReadVarintUnchecked(Position_));
+
+                Current_ = {
+                    .Price = TPriceTicks::template FromTicks<TPrice>(ticks),
+                    .Quantity = TQuantityLots::template FromTicks<TQuantity>(lots),
+                };
+            }
+        };
+
+        const std::byte* Begin_ = nullptr;
+        std::size_t Count_ = 0;
+        std::int64_t Reference_ = 0;
+
+    public:
+        LevelsView() = default;
+
+        LevelsView(const std::byte* begin, std::size_t count, std::int64_t reference)
+            : Begin_(begin), Count_(count), Reference_(reference) {
+        }
+
+        [[nodiscard]]
+        Iterator begin() const {
+            return Iterator(Begin_, Count_, Reference_);
+        }
+
+        [[nodiscard]]
+        Sentinel end() const {
+            return {};
+        }
+
+        [[nodiscard]]
+        std::size_t size() const noexcept {
+            return Count_;
+        }
+    };
+
+    template <typename TPrice, typename TQuantity, typename TPriceTicks, typename TQuantityLots>
+    struct Message {
+        using TLevelsView = LevelsView<TPrice, TQuantity, TPriceTicks, TQuantityLots>;
+
+        MessageType Type{};
+        std::uint64_t Sequence{};
+        TLevelsView Bids;
+        TLevelsView Asks;
+    };
+
+    namespace Details {
+
+        // Skip `count` levels checking that they fit into the message, returns nullptr if they don't.
+        inline const std::byte* SkipLevels(const std::byte* position, const std::byte* end, std::uint64_t count) noexcept {
+            for (std::uint64_t level = 0; level < count; ++level) {
+                if (!Utils::ReadVarint(position, end) || !Utils::ReadVarint(position, end)) [[unlikely]] {
+                    return nullptr;
+                }
+            }
+
+            return position;
+        }
+
+    }
+
+    // Validate the message and return views over its levels, std::nullopt if the message is malformed.
+    template <typename TPrice, typename TQuantity, typename TPriceTicks, typename TQuantityLots>
+    std::optional<Message<TPrice, TQuantity, TPriceTicks, TQuantityLots>> ParseMessage(std::span<const std::byte> bytes) noexcept {
+        using TMessage = Message<TPrice, TQuantity, TPriceTicks, TQuantityLots>;
+
+        const std::byte* position = bytes.data();
+        const std::byte* end = bytes.data() + bytes.size();
+
+        if (bytes.size() < 2 || std::to_integer<std::uint8_t>(position[0]) != Version) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const auto type = static_cast<MessageType>(position[1]);
+        if (type != MessageType::Snapshot && type != MessageType::Delta) [[unlikely]] {
+            return std::nullopt;
+        }
+        position += 2;
+
+        const auto sequence = Utils::ReadVarint(position, end);
+        const auto reference = Utils::ReadVarint(position, end);
+        const auto bidsCount = Utils::ReadVarint(position, end);
+        const auto asksCount = Utils::ReadVarint(position, end);
+        if (!sequence || !reference || !bidsCount || !asksCount) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const std::byte* bids = position;
+        const std::byte* asks = Details::SkipLevels(bids, end, *bidsCount);
+        const std::byte* last = asks != nullptr ? Details::SkipLevels(asks, end, *asksCount) : nullptr;
+        if (last != end) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const auto referenceTicks = Utils::ZigZagDecode(*reference);
+
+        return TMessage{
+            .Type = type,
+            .Sequence = *sequence,
+            .Bids = typename TMessage::TLevelsView(bids, *bidsCount, referenceTicks),
+            .Asks = typename TMessage::TLevelsView(asks, *asksCount, referenceTicks),
+        };
+    }
+
+}
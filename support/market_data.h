@@ -0,0 +1,203 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#include "src/models/book_ticker.h"
+#include "src/models/price_quantity.h"
+
+namespace OrderBook::Support {
+
+    // Convert a double into the generated price/quantity representation.
+    template <typename T>
+    T FromDouble(double value) {
+        if constexpr (std::is_floating_point_v<T>) {
+            return static_cast<T>(value);
+        } else {
+            return T::FromDouble(value);
+        }
+    }
+
+    // Prices are in ticks of 0.01, quantities in lots of 0.00001, as for BTCUSDT.
+    inline constexpr double TicksPerUnit = 100;
+    inline constexpr double LotsPerUnit = 100000;
+
+    // Convert a number of ticks or lots into the value the parser would produce for its decimal string,
+    // i.e. the nearest double (multiplying by 0.01 instead may give a neighbouring one).
+    template <typename T>
+    T FromUnits(std::int64_t units, double unitsPerValue) {
+        return FromDouble<T>(static_cast<double>(units) / unitsPerValue);
+    }
+
+    enum class Distribution {
+        Synthetic,    // independent random levels in every message
+        RecordedLike, // levels persist between messages with few changes, as in the recorded BTCUSDT stream
+    };
+
+    template <typename TPrice, typename TQuantity>
+    struct DepthMessage {
+        std::vector<Models::PriceQuantity<TPrice, TQuantity>> Bids;
+        std::vector<Models::PriceQuantity<TPrice, TQuantity>> Asks;
+    };
+
+    /*
+     * Synthetic partial depth stream similar to the BTCUSDT one: the mid price makes a random walk
+     * of a few ticks per message and levels are spread by random gaps of 1-8 ticks.
+    */
+    template <typename TPrice, typename TQuantity>
+    std::vector<DepthMessage<TPrice, TQuantity>> GenerateSyntheticDepthMessages(std::size_t count,
+                                                                                std::size_t levels,
+                                                                                std::uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> step(-3, 3);
+        std::uniform_int_distribution<int> gap(1, 8);
+        std::uniform_int_distribution<int> lots(1, 100000);
+
+        std::vector<DepthMessage<TPrice, TQuantity>> messages(count);
+        std::int64_t midTicks = 2007870;
+
+        for (auto& message : messages) {
+            midTicks += step(random);
+
+            message.Bids.reserve(levels);
+            message.Asks.reserve(levels);
+
+            std::int64_t bidTicks = midTicks - 1;
+            std::int64_t askTicks = midTicks + 1;
+
+            for (std::size_t level = 0; level < levels; ++level) {
+                message.Bids.push_back({
+                    .Price = FromUnits<TPrice>(bidTicks, TicksPerUnit),
+                    .Quantity = FromUnits<TQuantity>(lots(random), LotsPerUnit),
+                });
+                message.Asks.push_back({
+                    .Price = FromUnits<TPrice>(askTicks, TicksPerUnit),
+                    .Quantity = FromUnits<TQuantity>(lots(random), LotsPerUnit),
+                });
+
+                bidTicks -= gap(random);
+                askTicks += gap(random);
+            }
+        }
+
+        return messages;
+    }
+
+    /*
+     * Depth stream shaped after the recorded BTCUSDT messages: the mid price stays still in most messages,
+     * 60% of levels are 1 tick apart, quantities are heavy-tailed and only ~20% of them change between messages.
+    */
+    template <typename TPrice, typename TQuantity>
+    std::vector<DepthMessage<TPrice, TQuantity>> GenerateRecordedLikeDepthMessages(std::size_t count,
+                                                                                   std::size_t levels,
+                                                                                   std::uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<double> probability(0.0, 1.0);
+        std::uniform_int_distribution<int> step(-3, 3);
+        std::lognormal_distribution<double> quantity(-5.5, 1.5);
+
+        auto gap = [&]() -> std::int64_t {
+            const double p = probability(random);
+            if (p < 0.6) {
+                return 1;
+            }
+
+            return p < 0.85 ? 2 + random() % 2 : 4 + random() % 17;
+        };
+
+        struct Level {
+            std::int64_t Ticks;
+            std::int64_t Lots;
+        };
+
+        auto rebuild = [&](std::vector<Level>& side, std::int64_t best, std::int64_t direction) {
+            std::int64_t ticks = best;
+            for (auto& level : side) {
+                level.Ticks = ticks;
+                ticks += direction * gap();
+            }
+        };
+
+        std::vector<Level> bids(levels, Level{0, 100});
+        std::vector<Level> asks(levels, Level{0, 100});
+        std::int64_t midTicks = 2007870;
+
+        rebuild(bids, midTicks - 1, -1);
+        rebuild(asks, midTicks + 1, 1);
+
+        std::vector<DepthMessage<TPrice, TQuantity>> messages(count);
+
+        for (auto& message : messages) {
+            if (probability(random) < 0.3) {
+                midTicks += step(random);
+                rebuild(bids, midTicks - 1, -1);
+                rebuild(asks, midTicks + 1, 1);
+            }
+
+            for (auto* side : {&bids, &asks}) {
+                for (auto& level : *side) {
+                    if (probability(random) < 0.2) {
+                        level.Lots = std::max<std::int64_t>(1, std::llround(quantity(random) * LotsPerUnit));
+                    }
+                }
+            }
+
+            for (const auto& level : bids) {
+                message.Bids.push_back({
+                    .Price = FromUnits<TPrice>(level.Ticks, TicksPerUnit),
+                    .Quantity = FromUnits<TQuantity>(level.Lots, LotsPerUnit),
+                });
+            }
+
+            for (const auto& level : asks) {
+                message.Asks.push_back({
+                    .Price = FromUnits<TPrice>(level.Ticks, TicksPerUnit),
+                    .Quantity = FromUnits<TQuantity>(level.Lots, LotsPerUnit),
+                });
+            }
+        }
+
+        return messages;
+    }
+
+    template <typename TPrice, typename TQuantity>
+    std::vector<DepthMessage<TPrice, TQuantity>> GenerateDepthMessages(std::size_t count,
+                                                                       std::size_t levels,
+                                                                       std::uint32_t seed = 42,
+                                                                       Distribution distribution = Distribution::Synthetic) {
+        return distribution == Distribution::Synthetic
+               ? GenerateSyntheticDepthMessages<TPrice, TQuantity>(count, levels, seed)
+               : GenerateRecordedLikeDepthMessages<TPrice, TQuantity>(count, levels, seed);
+    }
+
+    // Synthetic book ticker stream around the same mid price as GenerateDepthMessages.
+    template <typename TPrice, typename TQuantity>
+    std::vector<Models::BookTicker<TPrice, TQuantity>> GenerateBookTickers(std::size_t count,
+                                                                           std::uint32_t seed = 42) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<int> step(-3, 3);
+        std::uniform_int_distribution<int> spread(1, 4);
+        std::uniform_int_distribution<int> lots(1, 100000);
+
+        std::vector<Models::BookTicker<TPrice, TQuantity>> tickers(count);
+        std::int64_t midTicks = 2007870;
+
+        for (auto& ticker : tickers) {
+            midTicks += step(random);
+
+            ticker = {
+                .BestBidPrice = FromUnits<TPrice>(midTicks - spread(random), TicksPerUnit),
+                .BestBidQty = FromUnits<TQuantity>(lots(random), LotsPerUnit),
+                .BestAskPrice = FromUnits<TPrice>(midTicks + spread(random), TicksPerUnit),
+                .BestAskQty = FromUnits<TQuantity>(lots(random), LotsPerUnit),
+            };
+        }
+
+        return tickers;
+    }
+
+}
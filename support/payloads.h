@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string_view>
+
+namespace OrderBook::Support {
+
+    // Payloads captured from the BTCUSDT streams (the same book as in main.cpp).
+
+    inline constexpr std::string_view DepthPayload = R"({"lastUpdateId":40265375413,"bids":[["20078.54000000","0.00431000"],["20078.39000000","0.00100000"],["20078.27000000","0.00070000"],["20078.21000000","0.00066000"],["20077.91000000","0.03781000"],["20077.90000000","0.00110000"],["20077.86000000","0.00070000"],["20077.80000000","0.00650000"],["20077.73000000","0.00055000"],["20077.71000000","0.00100000"],["20077.69000000","0.00984000"],["20077.66000000","0.00066000"],["20077.61000000","0.04000000"],["20077.60000000","0.02484000"],["20077.56000000","0.05481000"],["20077.52000000","0.28882000"],["20077.51000000","0.00064000"],["20077.45000000","0.00070000"],["20077.43000000","0.05181000"],["20077.39000000","0.00689000"]],"asks":[["20078.91000000","0.03437000"],["20078.95000000","0.00100000"],["20078.99000000","0.00498000"],["20079.01000000","0.04981000"],["20079.09000000","0.00070000"],["20079.15000000","0.24902000"],["20079.30000000","0.04110000"],["20079.31000000","0.00066000"],["20079.35000000","0.00864000"],["20079.42000000","0.00100000"],["20079.44000000","0.09402000"],["20079.46000000","0.09402000"],["20079.49000000","0.00100000"],["20079.50000000","0.00070000"],["20079.51000000","0.17430000"],["20079.53000000","0.09602000"],["20079.60000000","0.00100000"],["20079.61000000","0.22853000"],["20079.62000000","0.08741000"],["20079.66000000","0.00400000"]]})";
+
+    inline constexpr std::string_view CombinedDepthPayload = R"({"stream":"btcusdt@depth20@100ms","data":{"lastUpdateId":40265375413,"bids":[["20078.54000000","0.00431000"],["20078.39000000","0.00100000"],["20078.27000000","0.00070000"],["20078.21000000","0.00066000"],["20077.91000000","0.03781000"],["20077.90000000","0.00110000"],["20077.86000000","0.00070000"],["20077.80000000","0.00650000"],["20077.73000000","0.00055000"],["20077.71000000","0.00100000"],["20077.69000000","0.00984000"],["20077.66000000","0.00066000"],["20077.61000000","0.04000000"],["20077.60000000","0.02484000"],["20077.56000000","0.05481000"],["20077.52000000","0.28882000"],["20077.51000000","0.00064000"],["20077.45000000","0.00070000"],["20077.43000000","0.05181000"],["20077.39000000","0.00689000"]],"asks":[["20078.91000000","0.03437000"],["20078.95000000","0.00100000"],["20078.99000000","0.00498000"],["20079.01000000","0.04981000"],["20079.09000000","0.00070000"],["20079.15000000","0.24902000"],["20079.30000000","0.04110000"],["20079.31000000","0.00066000"],["20079.35000000","0.00864000"],["20079.42000000","0.00100000"],["20079.44000000","0.09402000"],["20079.46000000","0.09402000"],["20079.49000000","0.00100000"],["20079.50000000","0.00070000"],["20079.51000000","0.17430000"],["20079.53000000","0.09602000"],["20079.60000000","0.00100000"],["20079.61000000","0.22853000"],["20079.62000000","0.08741000"],["20079.66000000","0.00400000"]]}})";
+
+    inline constexpr std::string_view BookTickerPayload = R"({"u":40265375420,"s":"BTCUSDT","b":"20078.54000000","B":"0.00431000","a":"20078.91000000","A":"0.03437000"})";
+
+}
@@ -0,0 +1,182 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <string>
+
+#include "src/order_book.h"
+#include "src/utils/frame_pool.h"
+#include "src/utils/generator.h"
+#include "support/market_data.h"
+#include "check.h"
+
+/*
+ * Generators in the steady state: once the FramePool of the thread is warmed up, depth updates fed by generators
+ * and Extract must not make a single global allocation. Counted by replacing the global operator new.
+*/
+
+namespace {
+
+    std::atomic<std::uint64_t> GlobalAllocations{0};
+
+    void* Allocate(std::size_t size) {
+        GlobalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        if (void* pointer = std::malloc(size != 0 ? size : 1)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+    void* AllocateAligned(std::size_t size, std::align_val_t alignment) {
+        GlobalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        const auto align = static_cast<std::size_t>(alignment);
+        if (void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) {
+            return pointer;
+        }
+        throw std::bad_alloc();
+    }
+
+}
+
+void* operator new(std::size_t size) {
+    return Allocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return AllocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    constexpr std::size_t MessagesCount = 1000;
+    constexpr std::size_t WarmUpRounds = 100;
+    constexpr std::size_t Rounds = 100'000;
+
+    Utils::Generator<TPriceQuantity> Yield(std::span<const TPriceQuantity> levels) {
+        for (const auto& level : levels) {
+            co_yield level;
+        }
+    }
+
+    // One round: a depth update fed by generators and reading the whole book back through Extract.
+    double Round(BinanceBook<>& book, const Support::DepthMessage<double, double>& message) {
+        book.DepthUpdate(Yield(message.Bids), Yield(message.Asks));
+
+        double sum = 0;
+        auto [bids, asks] = book.Extract();
+        for (const auto& level : bids) {
+            sum += level.Quantity;
+        }
+        for (const auto& level : asks) {
+            sum += level.Quantity;
+        }
+
+        return sum;
+    }
+
+}
+
+int main() {
+    // The replacement must be the one in use, or the checks below would pass trivially.
+    {
+        const auto before = GlobalAllocations.load();
+        void* pointer = ::operator new(64);
+        ::operator delete(pointer);
+        Check(GlobalAllocations.load() == before + 1, "global operator new is counted");
+    }
+
+    const auto messages = Support::GenerateDepthMessages<double, double>(MessagesCount, 20);
+    BinanceBook<> book;
+
+    double sum = 0;
+    for (std::size_t round = 0; round < WarmUpRounds; ++round) {
+        sum += Round(book, messages[round % MessagesCount]);
+    }
+
+    const auto poolBefore = Utils::FramePool::Local().Counters();
+    const auto before = GlobalAllocations.load();
+
+    for (std::size_t round = 0; round < Rounds; ++round) {
+        sum += Round(book, messages[round % MessagesCount]);
+    }
+
+    const auto allocations = GlobalAllocations.load() - before;
+    const auto poolAfter = Utils::FramePool::Local().Counters();
+
+    Check(allocations == 0, "generator-fed DepthUpdate and Extract made " + std::to_string(allocations)
+                            + " global allocations in the steady state");
+    Check(poolAfter.Allocations - poolBefore.Allocations == 4 * Rounds, "every round takes its 4 frames from the pool");
+    Check(poolAfter.UpstreamAllocations == poolBefore.UpstreamAllocations, "the pool doesn't grow in the steady state");
+    Check(sum > 0, "books are read back");
+
+    // Frames of generators given another resource don't touch the pool.
+    {
+        std::pmr::monotonic_buffer_resource arena(64 * 1024);
+        const std::pmr::polymorphic_allocator<> allocator(&arena);
+        const auto poolAllocations = Utils::FramePool::Local().Counters().Allocations;
+
+        auto generator = [](std::allocator_arg_t, std::pmr::polymorphic_allocator<>,
+                            std::span<const TPriceQuantity> levels) -> Utils::Generator<TPriceQuantity> {
+            for (const auto& level : levels) {
+                co_yield level;
+            }
+        };
+
+        const auto& message = messages[0];
+        book.DepthUpdate(generator(std::allocator_arg, allocator, message.Bids),
+                         generator(std::allocator_arg, allocator, message.Asks));
+        Check(Utils::FramePool::Local().Counters().Allocations == poolAllocations, "arena frames bypass the pool");
+    }
+
+    return Tests::Result();
+}
@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "src/analytics.h"
+#include "src/models/fixed_point.h"
+#include "src/order_book.h"
+#include "src/simd_price_ladder.h"
+#include "src/tick_ladder.h"
+#include "support/market_data.h"
+#include "check.h"
+
+/*
+ * Analytics: the values maintained by the sides match the ones computed by walking Levels after any sequence
+ * of depth, BBO, replace, restore and clear updates for every storage, including a tick ladder narrow enough
+ * to drop levels on its own. Microprice and imbalance are std::nullopt when the best levels have no quantity.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TTicks = DecimalTicks<static_cast<std::int64_t>(Support::TicksPerUnit)>;
+
+    template <template <typename, typename, typename, std::size_t> class TStorage>
+    using TBook = BinanceBook<double, double, 20, TStorage, DisabledInstrumentation, EnabledAnalytics>;
+
+    constexpr std::size_t MessagesCount = 2000;
+    constexpr std::size_t MaxDepthLevels = 30;
+
+    // Values computed by walking the levels, as a consumer without the analytics would.
+    struct Expected {
+        std::optional<double> BestPrice;
+        double BestQuantity = 0;
+        std::array<double, MaxDepthLevels + 1> Depth{}; // quantity of the top i levels
+        std::optional<double> Vwap(double quantity) const;
+
+        std::array<double, MaxDepthLevels + 2> Prices{};
+        std::array<double, MaxDepthLevels + 2> Quantities{};
+        std::size_t Count = 0;
+    };
+
+    std::optional<double> Expected::Vwap(double quantity) const {
+        double remaining = quantity;
+        double notional = 0;
+        for (std::size_t index = 0; index < Count && remaining > 0; ++index) {
+            const double taken = std::min(remaining, Quantities[index]);
+            notional += taken * Prices[index];
+            remaining -= taken;
+        }
+
+        if (Count == 0 || quantity <= 0 || remaining > 1e-9 * quantity) {
+            return std::nullopt;
+        }
+
+        return notional / quantity;
+    }
+
+    Expected Walk(const auto& levels) {
+        Expected expected;
+        double depth = 0;
+
+        for (const auto level : levels) {
+            const double price = Details::ToDouble(level.Price);
+            const double quantity = Details::ToDouble(level.Quantity);
+            if (expected.Count == 0) {
+                expected.BestPrice = price;
+                expected.BestQuantity = quantity;
+            }
+
+            if (expected.Count < expected.Prices.size()) {
+                expected.Prices[expected.Count] = price;
+                expected.Quantities[expected.Count] = quantity;
+            }
+
+            depth += quantity;
+            ++expected.Count;
+            if (expected.Count <= MaxDepthLevels) {
+                expected.Depth[expected.Count] = depth;
+            }
+        }
+
+        for (std::size_t levelsCount = expected.Count + 1; levelsCount <= MaxDepthLevels; ++levelsCount) {
+            expected.Depth[levelsCount] = depth;
+        }
+
+        return expected;
+    }
+
+    bool Near(double lhs, double rhs) {
+        return std::abs(lhs - rhs) <= 1e-9 * std::max({1.0, std::abs(lhs), std::abs(rhs)});
+    }
+
+    bool Near(std::optional<double> lhs, std::optional<double> rhs) {
+        return lhs.has_value() == rhs.has_value() && (!lhs.has_value() || Near(*lhs, *rhs));
+    }
+
+    template <typename TBookType>
+    void CheckMatchesLevels(const TBookType& book, const std::string& what) {
+        const auto [bids, asks] = book.Levels();
+        const auto expectedBids = Walk(bids);
+        const auto expectedAsks = Walk(asks);
+        const auto analytics = book.Analytics();
+
+        const bool bothSides = expectedBids.BestPrice.has_value() && expectedAsks.BestPrice.has_value();
+        std::optional<double> mid, spread, microprice, imbalance;
+        if (bothSides) {
+            const double bid = *expectedBids.BestPrice;
+            const double ask = *expectedAsks.BestPrice;
+            const double quantities = expectedBids.BestQuantity + expectedAsks.BestQuantity;
+
+            mid = (bid + ask) / 2;
+            spread = ask - bid;
+            if (quantities != 0) {
+                microprice = (bid * expectedAsks.BestQuantity + ask * expectedBids.BestQuantity) / quantities;
+                imbalance = (expectedBids.BestQuantity - expectedAsks.BestQuantity) / quantities;
+            }
+        }
+
+        Check(Near(analytics.Mid(), mid), what + ": mid");
+        Check(Near(analytics.Spread(), spread), what + ": spread");
+        Check(Near(analytics.Microprice(), microprice), what + ": microprice");
+        Check(Near(analytics.Imbalance(), imbalance), what + ": imbalance");
+
+        for (const std::size_t levels : std::array<std::size_t, 6>{0, 1, 2, 5, 21, MaxDepthLevels}) {
+            Check(Near(analytics.CumulativeDepth(BookSide::Bids, levels), expectedBids.Depth[levels]),
+                  what + ": bids depth to " + std::to_string(levels));
+            Check(Near(analytics.CumulativeDepth(BookSide::Asks, levels), expectedAsks.Depth[levels]),
+                  what + ": asks depth to " + std::to_string(levels));
+        }
+
+        for (const double quantity : {0.0, 0.00001, 0.3, 1.0, 4.0, 1000.0}) {
+            Check(Near(analytics.VwapToSize(BookSide::Bids, quantity), expectedBids.Vwap(quantity)),
+                  what + ": bids VWAP to " + std::to_string(quantity));
+            Check(Near(analytics.VwapToSize(BookSide::Asks, quantity), expectedAsks.Vwap(quantity)),
+                  what + ": asks VWAP to " + std::to_string(quantity));
+        }
+    }
+
+    template <typename TBookType, typename TPrice, typename TQuantity>
+    void CheckUpdates(const std::string& name, Support::Distribution distribution) {
+        const auto messages = Support::GenerateDepthMessages<TPrice, TQuantity>(MessagesCount, 20, 7, distribution);
+        const auto tickers = Support::GenerateBookTickers<TPrice, TQuantity>(MessagesCount, 7);
+
+        TBookType book;
+        typename TBookType::TState state{};
+        CheckMatchesLevels(book, name + " empty");
+
+        for (std::size_t index = 0; index < MessagesCount; ++index) {
+            const auto& message = messages[index];
+            const auto what = name + " message " + std::to_string(index);
+
+            switch (index % 97) {
+                case 0:
+                    book.Replace(message.Bids, message.Asks);
+                    break;
+                case 10:
+                    book.SaveState(state);
+                    break;
+                case 20:
+                    book.Clear();
+                    CheckMatchesLevels(book, what + " cleared");
+                    book.BBOUpdate(tickers[index]);
+                    break;
+                case 30:
+                    book.RestoreState(state);
+                    break;
+                default:
+                    book.DepthUpdate(message.Bids, message.Asks);
+                    break;
+            }
+            CheckMatchesLevels(book, what);
+
+            // BBO updates move the best levels around the stored ones.
+            if (index % 3 == 0) {
+                book.BBOUpdate(tickers[index]);
+                CheckMatchesLevels(book, what + " after BBO");
+            }
+        }
+    }
+
+    template <typename TBookType, typename TPrice = double, typename TQuantity = double>
+    void CheckAllDistributions(const std::string& name) {
+        CheckUpdates<TBookType, TPrice, TQuantity>(name + " synthetic", Support::Distribution::Synthetic);
+        CheckUpdates<TBookType, TPrice, TQuantity>(name + " recorded-like", Support::Distribution::RecordedLike);
+    }
+
+    void CheckZeroQuantities() {
+        TBook<FlatMapStorage> book;
+        book.BBOUpdate({.BestBidPrice = 100, .BestBidQty = 0, .BestAskPrice = 101, .BestAskQty = 0});
+
+        const auto analytics = book.Analytics();
+        Check(analytics.Mid() == 100.5, "mid of the book without quantities");
+        Check(!analytics.Microprice().has_value(), "microprice without quantities");
+        Check(!analytics.Imbalance().has_value(), "imbalance without quantities");
+        Check(!analytics.VwapToSize(BookSide::Asks, 1).has_value(), "VWAP without quantities");
+
+        TBook<FlatMapStorage> oneSided;
+        const std::vector<Models::PriceQuantity<double, double>> bids{{.Price = 100, .Quantity = 2}};
+        const std::vector<Models::PriceQuantity<double, double>> asks;
+        oneSided.DepthUpdate(bids, asks);
+        Check(!oneSided.Analytics().Mid().has_value(), "mid of a one-sided book");
+        Check(oneSided.Analytics().CumulativeDepth(BookSide::Bids, 5) == 2, "depth of a one-sided book");
+        Check(oneSided.Analytics().VwapToSize(BookSide::Bids, 1) == 100, "VWAP of a one-sided book");
+    }
+
+}
+
+int main() {
+    CheckAllDistributions<TBook<FlatMapStorage>>("flat map");
+    CheckAllDistributions<TBook<SimdPriceLadder>>("SIMD ladder");
+    CheckAllDistributions<TBook<TickLadderStorage<TTicks>::Type>>("tick ladder");
+    CheckAllDistributions<TBook<TickLadderStorage<TTicks, 64>::Type>>("narrow tick ladder");
+    CheckAllDistributions<BinanceBook<Models::Price<2>, Models::Quantity<5>, 20, FlatMapStorage,
+                                      DisabledInstrumentation, EnabledAnalytics>,
+                          Models::Price<2>, Models::Quantity<5>>("fixed point");
+    CheckZeroQuantities();
+
+    return Tests::Result();
+}
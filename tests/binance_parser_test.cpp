@@ -0,0 +1,72 @@
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "src/models/fixed_point.h"
+#include "src/parsers/binance_parser.h"
+#include "check.h"
+
+/*
+ * Binance payloads: every level of valid depth payloads is yielded, and a malformed level anywhere in either array
+ * rejects the whole payload instead of truncating the levels.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    constexpr std::string_view Depth =
+        R"({"lastUpdateId":160,"bids":[["0.0024","10"], ["0.0023","0"]],"asks":[["0.0026","100"],["0.0027","1.5"],["0.0028","2"]]})";
+    constexpr std::string_view DiffDepth =
+        R"({"e":"depthUpdate","E":123456789,"s":"BNBBTC","U":157,"u":160,"b":[["0.0024","10"]],"a":[]})";
+
+    std::size_t Count(const auto& levels) {
+        std::size_t count = 0;
+        for ([[maybe_unused]] const auto& level : levels) {
+            ++count;
+        }
+
+        return count;
+    }
+
+    // The payload with `from` replaced by `to`.
+    std::string Damaged(std::string_view payload, std::string_view from, std::string_view to) {
+        std::string damaged(payload);
+        damaged.replace(damaged.find(from), from.size(), to);
+        return damaged;
+    }
+
+    template <typename TPrice, typename TQuantity>
+    void CheckDepth(std::string_view name) {
+        const std::string what(name);
+
+        const auto depth = Parsers::ParseDepth<TPrice, TQuantity>(Depth);
+        Check(depth && depth->LastUpdateId == 160, what + ": depth is parsed");
+        Check(depth && Count(depth->Bids) == 2 && Count(depth->Asks) == 3, what + ": every level is yielded");
+
+        const auto diff = Parsers::ParseDiffDepth<TPrice, TQuantity>(DiffDepth);
+        Check(diff && diff->FirstUpdateId == 157 && diff->FinalUpdateId == 160, what + ": diff is parsed");
+        Check(diff && Count(diff->Bids) == 1 && Count(diff->Asks) == 0, what + ": diff levels");
+
+        // Damage in the middle of the bids, in the last ask, an unclosed array and a truncated payload.
+        Check(!Parsers::ParseDepth<TPrice, TQuantity>(Damaged(Depth, R"("0.0023")", R"("0.00x3")")), what + ": bad price");
+        Check(!Parsers::ParseDepth<TPrice, TQuantity>(Damaged(Depth, R"("2"])", R"("2"})")), what + ": bad last level");
+        Check(!Parsers::ParseDepth<TPrice, TQuantity>(Damaged(Depth, R"(["0.0024","10"], )", R"(["0.0024"], )")),
+              what + ": level without quantity");
+        Check(!Parsers::ParseDepth<TPrice, TQuantity>(Depth.substr(0, Depth.size() - 10)), what + ": truncated payload");
+        Check(!Parsers::ParseDiffDepth<TPrice, TQuantity>(Damaged(DiffDepth, R"("a":[])", R"("a":[{}])")),
+              what + ": bad diff ask");
+    }
+
+}
+
+int main() {
+    CheckDepth<double, double>("double");
+    CheckDepth<Models::Price<4>, Models::Quantity<1>>("fixed point");
+
+    // A quantity which can't be represented by the fixed-point scale is malformed as well.
+    Check(!Parsers::ParseDepth<Models::Price<4>, Models::Quantity<0>>(Depth), "fixed point: unrepresentable quantity");
+
+    return Tests::Result();
+}
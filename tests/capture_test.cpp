@@ -0,0 +1,109 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/capture/capture_reader.h"
+#include "src/capture/capture_writer.h"
+#include "check.h"
+
+/*
+ * Captures: records come back as they were written, and the range ends before a truncated or damaged record
+ * (a BBO record without one level per side, an unknown type) instead of reading levels which aren't there.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+    using TReader = Capture::CaptureReader<double, double>;
+
+    const std::vector<TPriceQuantity> Bids = {{.Price = 10, .Quantity = 1}, {.Price = 9, .Quantity = 2}};
+    const std::vector<TPriceQuantity> Asks = {{.Price = 11, .Quantity = 3}};
+
+    // Depth, BBO, depth.
+    constexpr std::size_t DepthRecordSize = sizeof(Capture::RecordHeader) + 3 * sizeof(TPriceQuantity);
+    constexpr std::size_t BBORecordOffset = sizeof(Capture::FileHeader) + DepthRecordSize;
+
+    std::filesystem::path CapturePath(const std::string& name) {
+        return std::filesystem::temp_directory_path() / ("binance_book_capture_test_" + name + ".bin");
+    }
+
+    void WriteCapture(const std::filesystem::path& path) {
+        Capture::CaptureWriter<double, double> writer(path.string());
+        writer.WriteDepth(1, 7, Bids, Asks);
+        writer.WriteBBO(2, 7, {.BestBidPrice = 10, .BestBidQty = 4, .BestAskPrice = 11, .BestAskQty = 5});
+        writer.WriteDepth(3, 8, Bids, Asks);
+        writer.Flush();
+    }
+
+    std::vector<std::uint64_t> Timestamps(const TReader& reader) {
+        std::vector<std::uint64_t> timestamps;
+        for (const auto& record : reader) {
+            timestamps.push_back(record.Timestamp);
+        }
+
+        return timestamps;
+    }
+
+    template <typename T>
+    void Overwrite(const std::filesystem::path& path, std::size_t offset, T value) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void CheckRoundTrip() {
+        const auto path = CapturePath("round_trip");
+        WriteCapture(path);
+
+        const TReader reader(path.string());
+        Check(Timestamps(reader) == std::vector<std::uint64_t>{1, 2, 3}, "round trip: every record");
+
+        auto record = reader.begin();
+        Check(record->Type == Models::UpdateType::Depth && record->SymbolId == 7
+              && record->Bids.size() == 2 && record->Asks.size() == 1 && record->Bids[1].Quantity == 2, "round trip: depth");
+
+        ++record;
+        const auto ticker = record->Ticker();
+        Check(record->Type == Models::UpdateType::BBO && ticker.BestBidQty == 4 && ticker.BestAskQty == 5, "round trip: BBO");
+
+        std::filesystem::remove(path);
+    }
+
+    void CheckDamaged() {
+        const auto path = CapturePath("damaged");
+
+        // A BBO record without levels.
+        WriteCapture(path);
+        Overwrite<std::uint16_t>(path, BBORecordOffset + offsetof(Capture::RecordHeader, BidsCount), 0);
+        Check(Timestamps(TReader(path.string())) == std::vector<std::uint64_t>{1}, "damaged: BBO without a bid");
+
+        WriteCapture(path);
+        Overwrite<std::uint16_t>(path, BBORecordOffset + offsetof(Capture::RecordHeader, AsksCount), 2);
+        Check(Timestamps(TReader(path.string())) == std::vector<std::uint64_t>{1}, "damaged: BBO with two asks");
+
+        WriteCapture(path);
+        Overwrite<std::uint8_t>(path, BBORecordOffset + offsetof(Capture::RecordHeader, Type), 7);
+        Check(Timestamps(TReader(path.string())) == std::vector<std::uint64_t>{1}, "damaged: unknown type");
+
+        // The writer killed in the middle of the last record.
+        WriteCapture(path);
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+        Check(Timestamps(TReader(path.string())) == std::vector<std::uint64_t>{1, 2}, "damaged: truncated last record");
+
+        std::filesystem::remove(path);
+    }
+
+}
+
+int main() {
+    CheckRoundTrip();
+    CheckDamaged();
+
+    return Tests::Result();
+}
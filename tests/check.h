@@ -0,0 +1,34 @@
+#pragma once
+
+#include <iostream>
+#include <source_location>
+#include <string_view>
+
+namespace OrderBook::Tests {
+
+    /*
+     * Minimal checks for the test executables: a failed check is reported with its location and the test
+     * goes on, so one run shows every failure. main returns Result(), which ctest treats as the outcome.
+    */
+
+    inline int FailuresCount = 0;
+
+    inline void Check(bool condition, std::string_view what,
+                      const std::source_location location = std::source_location::current()) {
+        if (!condition) {
+            ++FailuresCount;
+            std::cerr << location.file_name() << ':' << location.line() << ": check failed: " << what << '\n';
+        }
+    }
+
+    // Exit code of the test, 0 if every check passed.
+    inline int Result() {
+        if (FailuresCount != 0) {
+            std::cerr << FailuresCount << " check(s) failed\n";
+            return 1;
+        }
+
+        return 0;
+    }
+
+}
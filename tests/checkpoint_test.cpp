@@ -0,0 +1,268 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "src/capture/checkpoint_reader.h"
+#include "src/capture/checkpoint_writer.h"
+#include "src/order_book.h"
+#include "src/simd_price_ladder.h"
+#include "src/tick_ladder.h"
+#include "src/utils/checksum.h"
+#include "support/market_data.h"
+#include "check.h"
+
+/*
+ * Checkpoints: books of every storage come back from a checkpoint unchanged, damaged records and headers
+ * are detected, and a writer created over an existing checkpoint continues it without losing the committed one.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TTicks = DecimalTicks<static_cast<std::int64_t>(Support::TicksPerUnit)>;
+
+    using TFlatMapBook = BinanceBook<double, double, 20, FlatMapStorage>;
+    using TSimdBook = BinanceBook<double, double, 20, SimdPriceLadder>;
+    using TTickLadderBook = BinanceBook<double, double, 20, TickLadderStorage<TTicks>::Type>;
+
+    constexpr std::size_t BooksCount = 16;
+
+    std::filesystem::path CheckpointPath(const std::string& name) {
+        return std::filesystem::temp_directory_path() / ("binance_book_checkpoint_test_" + name + ".bin");
+    }
+
+    template <typename TBook>
+    std::vector<std::unique_ptr<TBook>> MakeBooks() {
+        const auto messages = Support::GenerateDepthMessages<double, double>(BooksCount + 4, 20);
+        const auto tickers = Support::GenerateBookTickers<double, double>(BooksCount);
+
+        std::vector<std::unique_ptr<TBook>> books;
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            auto& book = *books.emplace_back(std::make_unique<TBook>());
+            for (std::size_t message = 0; message < 4; ++message) {
+                const auto& depth = messages[index + message];
+                book.DepthUpdate(depth.Bids, depth.Asks);
+            }
+            book.BBOUpdate(tickers[index]);
+        }
+
+        return books;
+    }
+
+    void FlipByte(const std::filesystem::path& path, std::size_t offset) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        char byte = 0;
+        file.seekg(static_cast<std::streamoff>(offset));
+        file.read(&byte, 1);
+        byte ^= 0x01;
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(&byte, 1);
+    }
+
+    template <typename TBook>
+    void CheckRoundTrip(const std::string& name) {
+        const auto path = CheckpointPath(name);
+        const auto books = MakeBooks<TBook>();
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), BooksCount);
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                writer.Save(index, "SYM" + std::to_string(index), *books[index], index + 1);
+            }
+            writer.Commit(42);
+        }
+
+        Check(!std::filesystem::exists(path.string() + ".tmp"), name + ": working file is removed");
+
+        const Capture::CheckpointReader<TBook> reader(path.string());
+        Check(reader.BooksCount() == BooksCount, name + ": books count");
+        Check(reader.Generation() == 1, name + ": generation");
+        Check(reader.Timestamp() == 42, name + ": commit timestamp");
+
+        std::vector<std::unique_ptr<TBook>> restored(BooksCount);
+        const auto counts = reader.RestoreAll([&](std::size_t index, std::string_view symbol) -> TBook& {
+            Check(symbol == "SYM" + std::to_string(index), name + ": symbol");
+            return *(restored[index] = std::make_unique<TBook>());
+        });
+        Check(counts.Restored == BooksCount && counts.Empty == 0 && counts.Corrupted == 0, name + ": restore counts");
+
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            Check(restored[index] != nullptr && !restored[index]->IsEmpty(), name + ": book is restored");
+            Check(restored[index] != nullptr
+                  && Utils::BookChecksum(*restored[index]) == Utils::BookChecksum(*books[index]), name + ": book content");
+            Check(reader.SaveTimestamp(index) == index + 1, name + ": save timestamp");
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    void CheckCorruptedRecord() {
+        using TBook = TFlatMapBook;
+
+        const auto path = CheckpointPath("corrupted");
+        const auto books = MakeBooks<TBook>();
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), BooksCount);
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                writer.Save(index, "SYM", *books[index]);
+            }
+            writer.Commit();
+        }
+
+        // A byte in the middle of the state of the record 5.
+        FlipByte(path, Capture::CheckpointRecordsOffset + Capture::CheckpointRecordSize<TBook::TState>() * 5 + 200);
+
+        const Capture::CheckpointReader<TBook> reader(path.string());
+        TBook book;
+        Check(reader.Restore(5, book) == Capture::RestoreStatus::Corrupted, "flipped byte: record is corrupted");
+        Check(book.IsEmpty(), "flipped byte: book is left as it is");
+
+        TBook neighbour;
+        Check(reader.Restore(4, neighbour) == Capture::RestoreStatus::Restored, "flipped byte: other records are intact");
+
+        std::vector<TBook> restored(BooksCount);
+        const auto counts = reader.RestoreAll([&](std::size_t index, std::string_view) -> TBook& {
+            return restored[index];
+        });
+        Check(counts.Restored == BooksCount - 1 && counts.Corrupted == 1, "flipped byte: restore counts");
+
+        std::filesystem::remove(path);
+    }
+
+    void CheckDamagedHeader() {
+        using TBook = TFlatMapBook;
+
+        const auto path = CheckpointPath("damaged_header");
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), BooksCount);
+            writer.Commit();
+        }
+
+        FlipByte(path, offsetof(Capture::CheckpointHeader, Generation));
+
+        bool thrown = false;
+        try {
+            const Capture::CheckpointReader<TBook> reader(path.string());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        Check(thrown, "damaged header: reader throws");
+
+        // A checkpoint of books of another type is rejected as well.
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), BooksCount);
+            writer.Commit();
+        }
+
+        thrown = false;
+        try {
+            const Capture::CheckpointReader<BinanceBook<double, double, 10>> reader(path.string());
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        Check(thrown, "other book type: reader throws");
+
+        std::filesystem::remove(path);
+    }
+
+    void CheckNeverSaved() {
+        using TBook = TFlatMapBook;
+
+        const auto path = CheckpointPath("never_saved");
+        const auto books = MakeBooks<TBook>();
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), 3);
+            writer.Save(0, "A", *books[0]);
+            writer.Save(2, "C", *books[2]);
+            writer.Commit();
+        }
+
+        const Capture::CheckpointReader<TBook> reader(path.string());
+        TBook book;
+        Check(reader.Restore(1, book) == Capture::RestoreStatus::Empty, "never saved: record is empty");
+        Check(book.IsEmpty(), "never saved: book is left as it is");
+        Check(reader.Symbol(1).empty(), "never saved: no symbol");
+
+        std::vector<TBook> restored(3);
+        const auto counts = reader.RestoreAll([&](std::size_t index, std::string_view) -> TBook& {
+            return restored[index];
+        });
+        Check(counts.Restored == 2 && counts.Empty == 1 && counts.Corrupted == 0, "never saved: restore counts");
+
+        std::filesystem::remove(path);
+    }
+
+    void CheckContinuation() {
+        using TBook = TFlatMapBook;
+
+        const auto path = CheckpointPath("continuation");
+        const auto books = MakeBooks<TBook>();
+        {
+            Capture::CheckpointWriter<TBook> writer(path.string(), 2);
+            writer.Save(0, "A", *books[0]);
+            writer.Save(1, "B", *books[1]);
+            writer.Commit(1);
+
+            // Not committed, discarded with the writer.
+            writer.Save(0, "X", *books[2]);
+        }
+
+        {
+            // Warm restart: the committed checkpoint is continued, not truncated.
+            Capture::CheckpointWriter<TBook> writer(path.string(), 2);
+            Check(writer.Generation() == 1, "continuation: generation is continued");
+
+            writer.Save(0, "A", *books[3]);
+            {
+                const Capture::CheckpointReader<TBook> reader(path.string());
+                TBook book;
+                Check(reader.Restore(0, book) == Capture::RestoreStatus::Restored
+                      && Utils::BookChecksum(book) == Utils::BookChecksum(*books[0]), "continuation: saves are invisible until commit");
+            }
+
+            writer.Commit(2);
+        }
+
+        {
+            const Capture::CheckpointReader<TBook> reader(path.string());
+            Check(reader.Generation() == 2, "continuation: next generation");
+
+            TBook first;
+            TBook second;
+            Check(reader.Restore(0, first) == Capture::RestoreStatus::Restored
+                  && Utils::BookChecksum(first) == Utils::BookChecksum(*books[3]), "continuation: saved book");
+            Check(reader.Restore(1, second) == Capture::RestoreStatus::Restored
+                  && Utils::BookChecksum(second) == Utils::BookChecksum(*books[1]), "continuation: book which wasn't saved again");
+        }
+
+        {
+            // A writer of another count starts over, but the checkpoint is kept until it commits.
+            Capture::CheckpointWriter<TBook> writer(path.string(), 3);
+            Check(writer.Generation() == 0, "continuation: incompatible checkpoint isn't continued");
+        }
+
+        const Capture::CheckpointReader<TBook> reader(path.string());
+        Check(reader.Generation() == 2 && reader.BooksCount() == 2, "continuation: kept until the next commit");
+
+        std::filesystem::remove(path);
+    }
+
+}
+
+int main() {
+    CheckRoundTrip<TFlatMapBook>("flat_map");
+    CheckRoundTrip<TSimdBook>("simd_price_ladder");
+    CheckRoundTrip<TTickLadderBook>("tick_ladder");
+    CheckCorruptedRecord();
+    CheckDamagedHeader();
+    CheckNeverSaved();
+    CheckContinuation();
+
+    return Tests::Result();
+}
@@ -0,0 +1,150 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/conflating_queue.h"
+#include "src/order_book.h"
+#include "check.h"
+
+/*
+ * ConflatingQueue: every symbol made dirty is applied with its latest state, including symbols queued again
+ * while the batch containing them is being applied, both when this is forced deterministically and under
+ * a burst from a producer thread. The counters add up to the received updates.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TBook = BinanceBook<double, double, 20>;
+    using TLevels = std::vector<Models::PriceQuantity<double, double>>;
+
+    constexpr std::size_t SymbolsCount = 8;
+
+    using TQueue = ConflatingQueue<double, double, 20, SymbolsCount>;
+
+    // The best bid of the n-th depth update of a symbol, unique across symbols.
+    double BidOf(SymbolId id, std::uint64_t update) {
+        return static_cast<double>(update * SymbolsCount + id + 1);
+    }
+
+    void PushDepth(TQueue& queue, SymbolId id, std::uint64_t update) {
+        const double bid = BidOf(id, update);
+        const TLevels bids{{.Price = bid, .Quantity = 1}, {.Price = bid - 0.5, .Quantity = 2}};
+        const TLevels asks{{.Price = bid + 0.5, .Quantity = 3}};
+        queue.PushDepth(id, bids, asks, update);
+    }
+
+    std::vector<std::unique_ptr<TBook>> MakeBooks() {
+        std::vector<std::unique_ptr<TBook>> books;
+        for (std::size_t symbol = 0; symbol < SymbolsCount; ++symbol) {
+            books.push_back(std::make_unique<TBook>());
+        }
+
+        return books;
+    }
+
+    double BestBid(const TBook& book) {
+        const auto [bids, asks] = book.Levels();
+        return bids.empty() ? 0 : bids.front().Price;
+    }
+
+    void CheckCounters(const TQueue& queue, const std::string& what) {
+        const auto counters = queue.Counters();
+        Check(counters.DepthApplied + counters.DepthConflated == counters.DepthReceived,
+              what + ": every depth update is applied or conflated");
+        Check(counters.BBOApplied + counters.BBOConflated == counters.BBOReceived,
+              what + ": every BBO update is applied or conflated");
+    }
+
+    // Every symbol of a full batch is queued again while the batch is applied, the ring must hold both rounds.
+    void CheckRequeueDuringBatch() {
+        auto queue = std::make_unique<TQueue>();
+        auto books = MakeBooks();
+
+        for (SymbolId id = 0; id < SymbolsCount; ++id) {
+            PushDepth(*queue, id, 1);
+        }
+
+        auto bookOf = [&](SymbolId id) -> TBook& {
+            return *books[id];
+        };
+
+        // The flag of the symbol is already cleared, so each push queues it again.
+        std::size_t applied = queue->Drain(bookOf, SymbolsCount, [&](SymbolId id, std::uint64_t timestamp) {
+            if (timestamp == 1) {
+                PushDepth(*queue, id, 2);
+            }
+        });
+        Check(applied == SymbolsCount, "first round applies every symbol");
+
+        applied = queue->Drain(bookOf);
+        Check(applied == SymbolsCount, "the symbols queued during the batch are applied");
+        Check(queue->Drain(bookOf) == 0, "nothing is left after both rounds");
+
+        for (SymbolId id = 0; id < SymbolsCount; ++id) {
+            Check(BestBid(*books[id]) == BidOf(id, 2), "symbol " + std::to_string(id) + " has the latest state");
+        }
+
+        CheckCounters(*queue, "requeue");
+    }
+
+    // A producer thread pushes bursts over all symbols while the consumer drains in small batches.
+    void CheckBurst() {
+        constexpr std::uint64_t UpdatesPerSymbol = 20000;
+
+        auto queue = std::make_unique<TQueue>();
+        auto books = MakeBooks();
+        std::atomic<bool> done = false;
+
+        std::jthread producer([&]() {
+            for (std::uint64_t update = 1; update <= UpdatesPerSymbol; ++update) {
+                for (SymbolId id = 0; id < SymbolsCount; ++id) {
+                    PushDepth(*queue, id, update);
+                    if (update % 3 == 0) {
+                        const double bid = BidOf(id, update);
+                        queue->PushBBO(id, {.BestBidPrice = bid, .BestBidQty = 5, .BestAskPrice = bid + 0.5, .BestAskQty = 5}, update);
+                    }
+                }
+            }
+
+            done.store(true, std::memory_order_release);
+        });
+
+        auto bookOf = [&](SymbolId id) -> TBook& {
+            return *books[id];
+        };
+
+        while (!done.load(std::memory_order_acquire)) {
+            queue->Drain(bookOf, 3);
+        }
+        producer.join();
+
+        while (queue->Drain(bookOf, 3) != 0) {
+        }
+
+        for (SymbolId id = 0; id < SymbolsCount; ++id) {
+            const auto& book = *books[id];
+            const auto [bids, asks] = book.Levels();
+            Check(BestBid(book) == BidOf(id, UpdatesPerSymbol),
+                  "burst: symbol " + std::to_string(id) + " has the latest depth");
+            Check(!bids.empty() && bids.front().Quantity == 1,
+                  "burst: symbol " + std::to_string(id) + " has no outdated BBO");
+        }
+
+        CheckCounters(*queue, "burst");
+    }
+
+}
+
+int main() {
+    CheckRequeueDuringBatch();
+    CheckBurst();
+
+    return Tests::Result();
+}
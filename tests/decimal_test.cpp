@@ -0,0 +1,40 @@
+#include <cstdint>
+#include <optional>
+
+#include "src/utils/decimal.h"
+#include "check.h"
+
+/*
+ * ParseDecimal: exact values, extra fractional zeros, leading zeros of any length and overflow at the exact limit.
+*/
+
+namespace {
+
+    using OrderBook::Utils::ParseDecimal;
+    using OrderBook::Tests::Check;
+
+}
+
+int main() {
+    Check(ParseDecimal("20078.54000000", 2) == 2007854, "price in ticks");
+    Check(ParseDecimal("-0.5", 1) == -5, "negative value");
+    Check(ParseDecimal("1.25", 1) == std::nullopt, "fractional digits which can't be represented");
+    Check(ParseDecimal("", 2) == std::nullopt && ParseDecimal(".", 2) == std::nullopt, "no digits");
+    Check(ParseDecimal("1.2x", 2) == std::nullopt, "unexpected character");
+
+    // Leading zeros don't count towards the limit.
+    Check(ParseDecimal("0000000000000000000.5", 1) == 5, "19 leading zeros");
+    Check(ParseDecimal("000000000000000000000000000001", 0) == 1, "30 leading zeros");
+
+    // The largest value is accepted whatever the number of digits, one more is rejected.
+    Check(ParseDecimal("9223372036854775807", 0) == INT64_MAX, "largest integer");
+    Check(ParseDecimal("9223372036854775808", 0) == std::nullopt, "integer overflow");
+    Check(ParseDecimal("9.223372036854775807", 18) == INT64_MAX, "largest value with 18 decimals");
+    Check(ParseDecimal("9.223372036854775808", 18) == std::nullopt, "fractional overflow");
+    Check(ParseDecimal("10", 18) == std::nullopt, "integral part overflow with 18 decimals");
+    Check(ParseDecimal("92233720368547758070", 0) == std::nullopt, "20 digits");
+
+    static_assert(ParseDecimal("00000000000000000000001.10", 2) == 110);
+
+    return OrderBook::Tests::Result();
+}
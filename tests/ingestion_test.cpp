@@ -0,0 +1,201 @@
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "src/ingest/ingestion_engine.h"
+#include "src/utils/task.h"
+#include "check.h"
+
+/*
+ * IngestionEngine: messages of several sockets and a file are delivered in order to the coroutines awaiting them,
+ * including bursts larger than the socket buffers, a file message longer than the file buffer is dropped and
+ * the last one without a new line is delivered. Closing the peer or reaching the end of the file completes
+ * the coroutines. A coroutine destroyed while awaiting is not resumed by later messages of its source.
+ * Skipped where io_uring isn't available.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    // CTest reports the test as skipped (see SKIP_RETURN_CODE).
+    constexpr int SkippedCode = 77;
+
+    using TMessages = std::vector<std::string>;
+
+    Ingest::IngestionOptions SmallOptions() {
+        return {
+            .QueueDepth = 64,
+            .BufferSize = 256,
+            .BuffersCount = 8,
+            .FileBufferSize = 64,
+            .MaxFiles = 2,
+        };
+    }
+
+    struct SocketPair {
+        int Fds[2] = {-1, -1};
+
+        SocketPair() {
+            if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, Fds) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to create a socket pair");
+            }
+        }
+
+        SocketPair(const SocketPair&) = delete;
+        SocketPair& operator=(const SocketPair&) = delete;
+
+        ~SocketPair() {
+            ClosePeer();
+            close(Fds[1]);
+        }
+
+        void Send(std::string_view message) const {
+            Check(write(Fds[0], message.data(), message.size()) == static_cast<ssize_t>(message.size()), "send a message");
+        }
+
+        void ClosePeer() {
+            if (Fds[0] != -1) {
+                close(Fds[0]);
+                Fds[0] = -1;
+            }
+        }
+    };
+
+    Utils::Task Collect(Ingest::IngestionEngine& engine, Ingest::SourceId source, TMessages& messages) {
+        while (auto message = co_await engine.Next(source)) {
+            messages.emplace_back(*message);
+        }
+    }
+
+    void CheckSockets() {
+        Ingest::IngestionEngine engine(SmallOptions());
+        SocketPair first;
+        SocketPair second;
+        TMessages expected, firstMessages, secondMessages;
+
+        auto firstTask = Collect(engine, engine.AddSocket(first.Fds[1]), firstMessages);
+        auto secondTask = Collect(engine, engine.AddSocket(second.Fds[1]), secondMessages);
+
+        // Bursts of more messages than socket buffers, the receives run out of buffers and are retried.
+        for (int round = 0; round < 50; ++round) {
+            for (int index = 0; index < 20; ++index) {
+                expected.push_back("message " + std::to_string(round * 20 + index));
+                first.Send(expected.back());
+                second.Send(expected.back());
+            }
+
+            while (firstMessages.size() < expected.size() || secondMessages.size() < expected.size()) {
+                engine.Poll(true);
+            }
+        }
+
+        first.ClosePeer();
+        second.ClosePeer();
+        engine.Run();
+
+        const auto& counters = engine.Counters();
+        Check(firstMessages == expected && secondMessages == expected, "sockets: every message in order");
+        Check(firstTask.Done() && secondTask.Done(), "sockets: closing the peers completes the coroutines");
+        Check(engine.OpenSources() == 0, "sockets: no source is left open");
+        Check(counters.Messages == 2 * expected.size() && counters.Dropped == 0 && counters.Errors == 0,
+              "sockets: counters");
+    }
+
+    void CheckFile() {
+        char path[] = "/tmp/ingestion_testXXXXXX";
+        const int fd = mkstemp(path);
+        Check(fd != -1, "file: create a temporary file");
+        unlink(path);
+
+        TMessages expected;
+        std::string contents;
+        for (int index = 0; index < 500; ++index) {
+            // The 100th line doesn't fit into the file buffer and is dropped.
+            const std::string line = "line " + std::to_string(index) + std::string(index == 100 ? 200 : index % 50, 'x');
+            if (index != 100) {
+                expected.push_back(line);
+            }
+            contents += line + '\n';
+        }
+        contents += "last line without a new line";
+        expected.emplace_back("last line without a new line");
+        Check(write(fd, contents.data(), contents.size()) == static_cast<ssize_t>(contents.size()), "file: write");
+
+        Ingest::IngestionEngine engine(SmallOptions());
+        TMessages messages;
+        auto task = Collect(engine, engine.AddFile(fd), messages);
+        engine.Run();
+        close(fd);
+
+        Check(messages == expected, "file: every message in order");
+        Check(task.Done(), "file: the end of the file completes the coroutine");
+        Check(engine.Counters().Truncated == 1, "file: the long message is counted as truncated");
+    }
+
+    void CheckDestroyedWhileAwaiting() {
+        Ingest::IngestionEngine engine(SmallOptions());
+        SocketPair pair;
+        const auto source = engine.AddSocket(pair.Fds[1]);
+        TMessages destroyedMessages, messages;
+
+        {
+            auto task = Collect(engine, source, destroyedMessages);
+            pair.Send("before");
+            engine.Poll(true);
+            Check(destroyedMessages.size() == 1 && !task.Done(), "destroyed: the coroutine awaits the next message");
+        }
+
+        pair.Send("dropped");
+        engine.Poll(true);
+        Check(destroyedMessages.size() == 1, "destroyed: the coroutine is not resumed");
+        Check(engine.Counters().Dropped == 1, "destroyed: the message without a coroutine is dropped");
+
+        auto task = Collect(engine, source, messages);
+        pair.Send("after");
+        engine.Poll(true);
+        pair.ClosePeer();
+        engine.Run();
+
+        Check(messages == TMessages{"after"} && task.Done(), "destroyed: a new coroutine takes over the source");
+    }
+
+    std::optional<int> UnavailableError() {
+        try {
+            Ingest::IngestionEngine engine(SmallOptions());
+        } catch (const std::system_error& error) {
+            const int code = error.code().value();
+            if (code == ENOSYS || code == EPERM || code == EACCES) {
+                return code;
+            }
+            throw;
+        }
+
+        return std::nullopt;
+    }
+
+}
+
+int main() {
+    if (const auto error = UnavailableError()) {
+        std::fprintf(stderr, "io_uring is not available: %s\n", std::strerror(*error));
+        return SkippedCode;
+    }
+
+    CheckSockets();
+    CheckFile();
+    CheckDestroyedWhileAwaiting();
+
+    return Tests::Result();
+}
@@ -0,0 +1,82 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "src/instrumentation.h"
+#include "src/order_book.h"
+#include "check.h"
+
+/*
+ * Instrumentation of BinanceBook: every operation lands in its own histogram, and Extract records the traversal
+ * of the levels rather than the creation of the lazy generators.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TBook = BinanceBook<double, double, 20, FlatMapStorage, EnabledInstrumentation>;
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    std::uint64_t Count(const TBook& book, BookOperation operation) {
+        return book.Statistics().Latency(operation).Count();
+    }
+
+    void BusyWait(std::chrono::microseconds duration) {
+        const auto until = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+}
+
+int main() {
+    const std::vector<TPriceQuantity> bids = {{.Price = 10, .Quantity = 1}, {.Price = 9, .Quantity = 2}};
+    const std::vector<TPriceQuantity> asks = {{.Price = 11, .Quantity = 1}};
+
+    TBook book;
+    book.DepthUpdate(bids, asks);
+    book.BBOUpdate({.BestBidPrice = 10, .BestBidQty = 3, .BestAskPrice = 11, .BestAskQty = 2});
+    book.Replace(bids, asks);
+
+    Check(Count(book, BookOperation::DepthUpdate) == 1, "depth update is measured");
+    Check(Count(book, BookOperation::BBOUpdate) == 1, "BBO update is measured");
+    Check(Count(book, BookOperation::Replace) == 1, "replace is measured apart from depth updates");
+
+    // Generators which are never iterated don't do anything to measure.
+    {
+        const auto levels = book.Extract();
+    }
+    Check(Count(book, BookOperation::Extract) == 0, "unused generators aren't measured");
+
+    // Each side is measured from its first level to the end, including the time spent on the levels.
+    constexpr auto Delay = std::chrono::microseconds(200);
+    std::size_t levelsCount = 0;
+    {
+        auto [bidLevels, askLevels] = book.Extract();
+        for ([[maybe_unused]] const auto& level : bidLevels) {
+            ++levelsCount;
+            BusyWait(Delay);
+        }
+        for ([[maybe_unused]] const auto& level : askLevels) {
+            ++levelsCount;
+        }
+    }
+
+    const auto extract = book.Statistics().Latency(BookOperation::Extract);
+    const auto delayTicks = static_cast<double>(2 * Delay.count()) * 1000 * Utils::TscTicksPerNanosecond();
+    Check(levelsCount == 3, "every level is yielded");
+    Check(extract.Count() == 2, "both sides are measured");
+    Check(static_cast<double>(extract.Max()) >= delayTicks, "the traversal is measured to its end");
+
+    // A side abandoned in the middle is measured up to the destruction of its generator.
+    {
+        auto [bidLevels, askLevels] = book.Extract();
+        auto level = bidLevels.begin();
+        Check((*level).Price == 10, "best bid first");
+    }
+    Check(Count(book, BookOperation::Extract) == 3, "abandoned traversal is measured");
+
+    return Tests::Result();
+}
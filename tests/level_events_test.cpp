@@ -0,0 +1,164 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/order_book.h"
+#include "src/simd_price_ladder.h"
+#include "src/tick_ladder.h"
+#include "check.h"
+
+/*
+ * Level events: a mirror of the levels kept only by applying the emitted events stays equal to Levels
+ * after random depth, BBO, replace and clear updates, for every storage and with books small enough
+ * to evict levels. Every event is consistent with the mirror before it. When the buffer asks for a resync
+ * (a tick ladder dropping levels on its own), the mirror is taken from Levels again.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+    using TMirror = std::map<double, double>;
+
+    constexpr int StepsCount = 50000;
+
+    template <typename TBook>
+    class Run {
+        using TLevelEvent = typename TBook::TLevelEventBuffer::TLevelEvent;
+
+        std::mt19937 Random_{42};
+        std::vector<TLevelEvent> Storage_ = std::vector<TLevelEvent>(4096);
+        typename TBook::TLevelEventBuffer Buffer_{Storage_};
+        TBook Book_;
+        TMirror Bids_;
+        TMirror Asks_;
+        std::string Name_;
+        std::size_t Mismatches_ = 0;
+        std::size_t Inconsistent_ = 0;
+
+    public:
+        explicit Run(std::string name) : Name_(std::move(name)) {
+            Book_.EmitLevelEventsTo(&Buffer_);
+        }
+
+        void Execute() {
+            for (int step = 0; step < StepsCount; ++step) {
+                Buffer_.Clear();
+                Update();
+                Apply();
+                Compare();
+            }
+
+            Check(Inconsistent_ == 0, Name_ + ": every event matches the mirror before it");
+            Check(Mismatches_ == 0, Name_ + ": the mirror equals the levels after every update");
+        }
+
+    private:
+        int Uniform(int from, int to) {
+            return std::uniform_int_distribution<int>(from, to)(Random_);
+        }
+
+        // Prices in ticks of 0.01 on both sides of 100, a quarter of the levels are deletions.
+        double BidPrice() {
+            return std::round((100 - Uniform(0, 120) * 0.01) * 100) / 100;
+        }
+
+        double AskPrice() {
+            return std::round((100.01 + Uniform(0, 120) * 0.01) * 100) / 100;
+        }
+
+        std::vector<TPriceQuantity> Levels(bool bids) {
+            std::vector<TPriceQuantity> levels(static_cast<std::size_t>(Uniform(0, 6)));
+            for (auto& level : levels) {
+                level = {
+                    .Price = bids ? BidPrice() : AskPrice(),
+                    .Quantity = Uniform(0, 3) == 0 ? 0.0 : static_cast<double>(Uniform(1, 9)),
+                };
+            }
+
+            return levels;
+        }
+
+        void Update() {
+            const int operation = Uniform(0, 99);
+            if (operation < 80) {
+                Book_.DepthUpdate(Levels(true), Levels(false));
+            } else if (operation < 95) {
+                Book_.BBOUpdate({
+                    .BestBidPrice = BidPrice(),
+                    .BestBidQty = static_cast<double>(Uniform(1, 9)),
+                    .BestAskPrice = AskPrice(),
+                    .BestAskQty = static_cast<double>(Uniform(1, 9)),
+                });
+            } else if (operation < 99) {
+                Book_.Replace(Levels(true), Levels(false));
+            } else {
+                Book_.Clear();
+            }
+        }
+
+        void Apply() {
+            // The events can't be relied on, Compare takes the levels as they are.
+            if (Buffer_.NeedsResync()) {
+                return;
+            }
+
+            for (const auto& event : Buffer_.Events()) {
+                auto& mirror = event.Side == BookSide::Bids ? Bids_ : Asks_;
+                const auto it = mirror.find(event.Price);
+
+                switch (event.Type) {
+                    case LevelEventType::Add:
+                        Inconsistent_ += it != mirror.end() || event.OldQuantity != 0;
+                        mirror[event.Price] = event.NewQuantity;
+                        break;
+                    case LevelEventType::Modify:
+                        Inconsistent_ += it == mirror.end() || it->second != event.OldQuantity;
+                        mirror[event.Price] = event.NewQuantity;
+                        break;
+                    case LevelEventType::Delete:
+                        Inconsistent_ += it == mirror.end() || it->second != event.OldQuantity;
+                        mirror.erase(event.Price);
+                        break;
+                    case LevelEventType::BestChanged:
+                        break;
+                }
+            }
+        }
+
+        void Compare() {
+            const auto [bids, asks] = Book_.Levels();
+            auto compare = [&](const auto& levels, TMirror& mirror) {
+                TMirror expected;
+                for (const auto level : levels) {
+                    expected[level.Price] = level.Quantity;
+                }
+
+                if (!Buffer_.NeedsResync()) {
+                    Mismatches_ += expected != mirror;
+                }
+                mirror = std::move(expected);
+            };
+
+            compare(bids, Bids_);
+            compare(asks, Asks_);
+        }
+    };
+
+}
+
+int main() {
+    Run<BinanceBook<>>("flat map").Execute();
+    Run<BinanceBook<double, double, 5>>("flat map of 5 levels").Execute();
+    Run<BinanceBook<double, double, 5, SimdPriceLadder>>("SIMD ladder of 5 levels").Execute();
+    Run<BinanceBook<double, double, 5, TickLadderStorage<DecimalTicks<100>, 64>::Type>>("narrow tick ladder").Execute();
+
+    return Tests::Result();
+}
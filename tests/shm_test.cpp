@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "src/order_book.h"
+#include "src/shm/shm_publisher.h"
+#include "src/shm/shm_reader.h"
+#include "check.h"
+
+/*
+ * Books shared through POSIX shared memory: a reader in another process rebuilds every book from the level events
+ * of the ring (reading the slots again after an overrun) and must end up with the content of the slots, both with
+ * a ring large enough to keep up and with a ring of 64 entries which the reader keeps losing. A reader which
+ * doesn't poll while the publisher laps a 64-entry ring is told about the overrun and continues from the oldest event.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TBook = BinanceBook<double, double, 20>;
+    using TPublisher = Shm::ShmPublisher<double, double, 20>;
+    using TReader = Shm::ShmReader<double, double, 20>;
+    using TLevelEvent = TBook::TLevelEventBuffer::TLevelEvent;
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    constexpr std::size_t BooksCount = 4;
+    constexpr std::size_t UpdatesCount = 200'000;
+
+    std::string SegmentName() {
+        return "/binance_book_shm_test_" + std::to_string(::getpid());
+    }
+
+    // State shared with the reader process through an anonymous shared mapping.
+    struct Handshake {
+        std::atomic<std::uint64_t> Attached;
+        std::atomic<std::uint64_t> Done;
+        std::atomic<std::uint64_t> Events;   // taken by the reader
+        std::atomic<std::uint64_t> Overruns; // seen by the reader
+    };
+
+    // Books of the publisher, attached to the slots and emitting level events.
+    struct PublishedBooks {
+        TPublisher Publisher;
+        std::vector<std::unique_ptr<TBook>> Books;
+        std::vector<TLevelEvent> Storage = std::vector<TLevelEvent>(256);
+        TBook::TLevelEventBuffer Events{Storage};
+
+        PublishedBooks(const std::string& name, std::size_t ringCapacity) : Publisher(name, BooksCount, ringCapacity) {
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                auto& book = *Books.emplace_back(std::make_unique<TBook>());
+                Publisher.Attach(index, "SYM" + std::to_string(index), book);
+                book.EmitLevelEventsTo(&Events);
+            }
+        }
+    };
+
+    // Random updates around 100.00 adding, changing and removing levels, with a book ticker once in a while.
+    class RandomUpdates {
+        std::mt19937 Random_{1};
+        std::vector<TPriceQuantity> Bids_;
+        std::vector<TPriceQuantity> Asks_;
+
+        int Uniform(int from, int to) {
+            return std::uniform_int_distribution<int>(from, to)(Random_);
+        }
+
+        double BidPrice() {
+            return static_cast<double>(10000 - Uniform(0, 40)) / 100;
+        }
+
+        double AskPrice() {
+            return static_cast<double>(10001 + Uniform(0, 40)) / 100;
+        }
+
+    public:
+        void Apply(PublishedBooks& published) {
+            const auto index = static_cast<std::size_t>(Uniform(0, BooksCount - 1));
+            auto& book = *published.Books[index];
+
+            published.Events.Clear();
+            if (Uniform(0, 20) == 0) {
+                book.BBOUpdate({.BestBidPrice = BidPrice(), .BestBidQty = 1, .BestAskPrice = AskPrice(), .BestAskQty = 1});
+            } else {
+                Bids_.clear();
+                Asks_.clear();
+                for (int level = Uniform(0, 5); level > 0; --level) {
+                    Bids_.push_back({.Price = BidPrice(), .Quantity = Uniform(0, 3) == 0 ? 0.0 : Uniform(1, 9)});
+                }
+                for (int level = Uniform(0, 5); level > 0; --level) {
+                    Asks_.push_back({.Price = AskPrice(), .Quantity = Uniform(0, 3) == 0 ? 0.0 : Uniform(1, 9)});
+                }
+                book.DepthUpdate(Bids_, Asks_);
+            }
+
+            published.Publisher.PublishEvents(index, published.Events.Events());
+        }
+    };
+
+    // Books rebuilt by a reader from the slots and the level events.
+    class MirroredBooks {
+        std::map<double, double> Sides_[BooksCount][2];
+
+    public:
+        void Load(const TReader& reader) {
+            for (std::size_t index = 0; index < BooksCount; ++index) {
+                const auto snapshot = reader.Load(index);
+                Sides_[index][0].clear();
+                Sides_[index][1].clear();
+                for (const auto& level : snapshot.GetBids()) {
+                    Sides_[index][0][level.Price] = level.Quantity;
+                }
+                for (const auto& level : snapshot.GetAsks()) {
+                    Sides_[index][1][level.Price] = level.Quantity;
+                }
+            }
+        }
+
+        void Apply(const TReader::TRingEvent& event) {
+            if (event.Event.Type == LevelEventType::BestChanged) {
+                return;
+            }
+
+            auto& side = Sides_[event.SlotIndex][event.Event.Side == BookSide::Bids ? 0 : 1];
+            if (event.Event.NewQuantity == 0) {
+                side.erase(event.Event.Price);
+            } else {
+                side[event.Event.Price] = event.Event.NewQuantity;
+            }
+        }
+
+        // Slots keep 20 levels, the events may also describe the extra level kept by the book (see OrderMap).
+        [[nodiscard]]
+        bool Matches(const TReader& reader, std::size_t index) const {
+            const auto snapshot = reader.Load(index);
+            auto bid = Sides_[index][0].rbegin();
+            auto ask = Sides_[index][1].begin();
+
+            for (const auto& level : snapshot.GetBids()) {
+                if (bid == Sides_[index][0].rend() || bid->first != level.Price || bid->second != level.Quantity) {
+                    return false;
+                }
+                ++bid;
+            }
+            for (const auto& level : snapshot.GetAsks()) {
+                if (ask == Sides_[index][1].end() || ask->first != level.Price || ask->second != level.Quantity) {
+                    return false;
+                }
+                ++ask;
+            }
+
+            return Sides_[index][0].size() <= snapshot.GetBids().size() + 1
+                   && Sides_[index][1].size() <= snapshot.GetAsks().size() + 1;
+        }
+    };
+
+    // The reader process: follows the ring and finally compares its books with the slots, returns the number of failures.
+    int FollowBooks(const std::string& name, std::size_t eventsCapacity, Handshake& handshake) {
+        TReader reader(name);
+        std::vector<TReader::TRingEvent> events(eventsCapacity);
+        MirroredBooks books;
+
+        auto drain = [&]() {
+            while (true) {
+                const auto result = reader.Poll(events);
+                if (result.Overrun) {
+                    handshake.Overruns.fetch_add(1, std::memory_order_relaxed);
+                    books.Load(reader);
+                }
+
+                for (std::size_t i = 0; i < result.Count; ++i) {
+                    books.Apply(events[i]);
+                }
+                handshake.Events.fetch_add(result.Count, std::memory_order_relaxed);
+
+                if (result.Count == 0 && !result.Overrun) {
+                    return;
+                }
+            }
+        };
+
+        books.Load(reader);
+        handshake.Attached.store(1, std::memory_order_release);
+
+        while (handshake.Done.load(std::memory_order_acquire) == 0) {
+            drain();
+            sched_yield();
+        }
+        drain();
+
+        int failures = 0;
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            failures += books.Matches(reader, index) ? 0 : 1;
+            failures += reader.Symbol(index) == "SYM" + std::to_string(index) ? 0 : 1;
+
+            const auto snapshot = reader.Load(index);
+            const bool viewed = reader.TryView(index, [&](auto bids, auto asks) {
+                failures += bids.size() == snapshot.GetBids().size() && asks.size() == snapshot.GetAsks().size() ? 0 : 1;
+            });
+            failures += viewed ? 0 : 1;
+        }
+
+        return std::min(failures, 100);
+    }
+
+    void CheckCrossProcess(std::size_t ringCapacity, std::size_t eventsCapacity) {
+        const auto name = SegmentName();
+        const auto what = "ring of " + std::to_string(ringCapacity) + ": ";
+        PublishedBooks published(name, ringCapacity);
+
+        void* shared = ::mmap(nullptr, sizeof(Handshake), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (shared == MAP_FAILED) {
+            Check(false, what + "handshake is mapped");
+            return;
+        }
+        auto& handshake = *::new (shared) Handshake{};
+
+        const pid_t child = ::fork();
+        if (child == 0) {
+            ::_exit(FollowBooks(name, eventsCapacity, handshake));
+        }
+
+        while (handshake.Attached.load(std::memory_order_acquire) == 0) {
+            sched_yield();
+        }
+
+        RandomUpdates updates;
+        for (std::size_t update = 0; update < UpdatesCount; ++update) {
+            updates.Apply(published);
+            if (update % 64 == 0) {
+                sched_yield();
+            }
+        }
+
+        handshake.Done.store(1, std::memory_order_release);
+        int status = 0;
+        ::waitpid(child, &status, 0);
+
+        Check(WIFEXITED(status) && WEXITSTATUS(status) == 0, what + "reader rebuilt the published books");
+        Check(handshake.Events.load() > 0, what + "reader took events");
+        Check(handshake.Overruns.load() > 0 || handshake.Events.load() == published.Publisher.PublishedEvents(),
+              what + "reader took every event unless it was overrun");
+
+        ::munmap(shared, sizeof(Handshake));
+    }
+
+    void CheckOverrun() {
+        constexpr std::size_t RingCapacity = 64;
+
+        const auto name = SegmentName();
+        PublishedBooks published(name, RingCapacity);
+        Check(published.Publisher.RingCapacity() == RingCapacity, "overrun: ring capacity");
+
+        TReader reader(name);
+        std::vector<TReader::TRingEvent> events(2 * RingCapacity);
+
+        // Lap the ring before the reader polls.
+        RandomUpdates updates;
+        while (published.Publisher.PublishedEvents() <= 3 * RingCapacity) {
+            updates.Apply(published);
+        }
+
+        Check(reader.Lag() == published.Publisher.PublishedEvents(), "overrun: lag counts every published event");
+
+        auto result = reader.Poll(events);
+        Check(result.Overrun, "overrun: reported");
+        Check(result.Count == RingCapacity, "overrun: the whole ring is taken");
+        Check(reader.Lag() == 0, "overrun: caught up");
+
+        result = reader.Poll(events);
+        Check(!result.Overrun && result.Count == 0, "overrun: reported once");
+
+        // After reading the slots again, the events which follow keep the books in sync.
+        MirroredBooks books;
+        books.Load(reader);
+
+        const auto before = published.Publisher.PublishedEvents();
+        while (published.Publisher.PublishedEvents() - before < RingCapacity / 2) {
+            updates.Apply(published);
+        }
+
+        result = reader.Poll(events);
+        Check(!result.Overrun && result.Count == published.Publisher.PublishedEvents() - before,
+              "overrun: following events are taken");
+        for (std::size_t i = 0; i < result.Count; ++i) {
+            books.Apply(events[i]);
+        }
+        for (std::size_t index = 0; index < BooksCount; ++index) {
+            Check(books.Matches(reader, index), "overrun: books are in sync after reading the slots");
+        }
+
+        // A buffer smaller than the lag takes the events in several calls without an overrun.
+        const auto lapped = published.Publisher.PublishedEvents();
+        while (published.Publisher.PublishedEvents() - lapped < RingCapacity - 8) {
+            updates.Apply(published);
+        }
+
+        std::vector<TReader::TRingEvent> small(16);
+        std::uint64_t taken = 0;
+        bool overrun = false;
+        do {
+            result = reader.Poll(small);
+            overrun = overrun || result.Overrun;
+            taken += result.Count;
+        } while (result.Count != 0);
+        Check(!overrun && taken == published.Publisher.PublishedEvents() - lapped, "overrun: small buffer takes every event");
+    }
+
+}
+
+int main() {
+    CheckOverrun();
+    CheckCrossProcess(1 << 16, 1024);
+    CheckCrossProcess(64, 16);
+
+    return Tests::Result();
+}
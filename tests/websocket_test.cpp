@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "src/ingest/websocket_decoder.h"
+#include "src/ingest/websocket_frame.h"
+#include "src/ingest/websocket_stream.h"
+#include "check.h"
+
+/*
+ * WebSocket: a stream of plain, masked, extended-length and fragmented frames with control frames between
+ * the fragments decodes to the same messages whether it arrives byte by byte or in random chunks, nothing is
+ * delivered after a Close. Every malformed frame is a protocol error and messages longer than the buffer are
+ * too big. WebSocketStream answers pings and the Close of a server over a socket pair and closes the connection
+ * with the right status on errors.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using namespace OrderBook::Ingest;
+    using Tests::Check;
+
+    using TBytes = std::vector<std::byte>;
+    using TMessages = std::vector<std::string>;
+
+    constexpr WebSocketMask Mask = {std::byte{0x01}, std::byte{0x7F}, std::byte{0x80}, std::byte{0xFF}};
+
+    TBytes Bytes(std::string_view text) {
+        TBytes bytes(text.size());
+        std::transform(text.begin(), text.end(), bytes.begin(), [](char c) {
+            return static_cast<std::byte>(c);
+        });
+        return bytes;
+    }
+
+    void AddFrame(TBytes& out, WebSocketOpcode opcode, std::string_view payload, bool final = true, bool masked = false) {
+        const std::size_t position = out.size();
+        out.resize(position + MaxWebSocketHeaderSize + payload.size());
+
+        const std::size_t size = EncodeWebSocketFrame(out.data() + position, opcode, Bytes(payload), final,
+                                                      masked ? std::optional(Mask) : std::nullopt);
+        out.resize(position + size);
+    }
+
+    std::string Describe(const WebSocketMessage& message) {
+        return std::to_string(static_cast<int>(message.Opcode)) + ":" + std::string(message.Text());
+    }
+
+    // Decodes `stream` passed in chunks of the given sizes, as a receive loop would.
+    class ChunkedDecode {
+        TBytes Fragments_;
+        WebSocketDecoder Decoder_;
+
+    public:
+        TMessages Messages;
+        WebSocketError Error = WebSocketError::None;
+
+        explicit ChunkedDecode(std::size_t fragmentsSize = 1 << 17) : Fragments_(fragmentsSize), Decoder_(Fragments_) {
+        }
+
+        template <typename TChunkSize>
+        void Run(TBytes stream, TChunkSize&& chunkSize) {
+            std::size_t received = 0;
+            std::size_t consumed = 0;
+
+            while (received < stream.size() && !Decoder_.IsClosed() && Error == WebSocketError::None) {
+                received = std::min(stream.size(), received + chunkSize());
+                const auto result = Decoder_.Decode(std::span(stream).subspan(consumed, received - consumed),
+                                                    [&](const WebSocketMessage& message) {
+                                                        Messages.push_back(Describe(message));
+                                                    });
+                consumed += result.Consumed;
+                Error = result.Error;
+            }
+        }
+
+        void Run(TBytes stream) {
+            const std::size_t size = stream.size();
+            Run(std::move(stream), [size]() {
+                return size;
+            });
+        }
+    };
+
+    void CheckChunking() {
+        std::string large(70000, 'z');
+        large.front() = 'a';
+        large.back() = 'b';
+        const std::string medium(300, 'm');
+
+        TBytes stream;
+        AddFrame(stream, WebSocketOpcode::Text, "hello");
+        AddFrame(stream, WebSocketOpcode::Text, medium);
+        AddFrame(stream, WebSocketOpcode::Binary, large);
+        AddFrame(stream, WebSocketOpcode::Text, "first-", false);
+        AddFrame(stream, WebSocketOpcode::Ping, "ping");
+        AddFrame(stream, WebSocketOpcode::Continuation, "second-", false, true);
+        AddFrame(stream, WebSocketOpcode::Continuation, "third", true, true);
+        AddFrame(stream, WebSocketOpcode::Binary, large, false, true);
+        AddFrame(stream, WebSocketOpcode::Continuation, medium, true, true);
+        AddFrame(stream, WebSocketOpcode::Text, "masked text", true, true);
+        AddFrame(stream, WebSocketOpcode::Text, "");
+        AddFrame(stream, WebSocketOpcode::Close, std::string_view("\x03\xE8" "bye", 5));
+        AddFrame(stream, WebSocketOpcode::Text, "after the close");
+
+        const TMessages expected = {
+            "1:hello",
+            "1:" + medium,
+            "2:" + large,
+            "9:ping",
+            "1:first-second-third",
+            "2:" + large + medium,
+            "1:masked text",
+            "1:",
+            std::string("8:\x03\xE8" "bye", 7),
+        };
+
+        // Masks are removed in place, so every run decodes its own copy.
+        ChunkedDecode byteByByte;
+        byteByByte.Run(stream, []() {
+            return std::size_t{1};
+        });
+        Check(byteByByte.Error == WebSocketError::None && byteByByte.Messages == expected, "byte by byte");
+
+        std::mt19937 random(1);
+        std::size_t mismatches = 0;
+        for (int run = 0; run < 200; ++run) {
+            ChunkedDecode chunks;
+            chunks.Run(stream, [&]() {
+                return std::uniform_int_distribution<std::size_t>(1, 5000)(random);
+            });
+            mismatches += chunks.Error != WebSocketError::None || chunks.Messages != expected;
+        }
+        Check(mismatches == 0, "random chunks");
+
+        TBytes close;
+        AddFrame(close, WebSocketOpcode::Close, std::string_view("\x03\xE8" "bye", 5));
+        TBytes fragments(16);
+        WebSocketDecoder decoder(fragments);
+        decoder.Decode(close, [](const WebSocketMessage& message) {
+            Check(message.CloseCode() == 1000 && message.CloseReason() == "bye", "status and reason of a Close");
+        });
+        Check(decoder.IsClosed(), "a Close closes the decoder");
+
+        TBytes empty;
+        AddFrame(empty, WebSocketOpcode::Close, "");
+        decoder.Reset();
+        decoder.Decode(empty, [](const WebSocketMessage& message) {
+            Check(message.CloseCode() == static_cast<std::uint16_t>(WebSocketCloseCode::NoStatus),
+                  "a Close without a status");
+        });
+    }
+
+    std::pair<WebSocketError, TMessages> Decode(TBytes stream, std::size_t fragmentsSize = 1 << 17) {
+        ChunkedDecode decode(fragmentsSize);
+        decode.Run(std::move(stream));
+        return {decode.Error, decode.Messages};
+    }
+
+    TBytes Raw(std::string_view bytes) {
+        return Bytes(bytes);
+    }
+
+    void CheckErrors() {
+        using namespace std::string_view_literals;
+
+        auto isProtocolError = [](TBytes stream) {
+            const auto [error, messages] = Decode(std::move(stream));
+            return error == WebSocketError::ProtocolError && messages.empty();
+        };
+
+        Check(isProtocolError(Raw("\xC1\x00"sv)), "RSV1 set");
+        Check(isProtocolError(Raw("\xA1\x00"sv)), "RSV2 set");
+        Check(isProtocolError(Raw("\x91\x00"sv)), "RSV3 set");
+        Check(isProtocolError(Raw("\x83\x00"sv)), "reserved data opcode");
+        Check(isProtocolError(Raw("\x8B\x00"sv)), "reserved control opcode");
+        // The highest bit of a 64-bit length must be 0.
+        Check(isProtocolError(Raw("\x82\x7F\x80\x00\x00\x00\x00\x00\x00\x00"sv)), "64-bit length with the highest bit");
+
+        TBytes stream;
+        AddFrame(stream, WebSocketOpcode::Ping, "x", false);
+        Check(isProtocolError(stream), "fragmented control frame");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Pong, std::string(MaxControlPayloadSize + 1, 'x'));
+        Check(isProtocolError(stream), "control frame longer than 125 bytes");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Continuation, "x");
+        Check(isProtocolError(stream), "continuation without a fragmented message");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Close, "x");
+        Check(isProtocolError(stream), "Close with a 1-byte payload");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, "x", false);
+        AddFrame(stream, WebSocketOpcode::Binary, "y");
+        Check(isProtocolError(stream), "data frame in the middle of a fragmented message");
+
+        // Messages before the error are delivered, nothing after it.
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, "before");
+        AddFrame(stream, WebSocketOpcode::Continuation, "x");
+        AddFrame(stream, WebSocketOpcode::Text, "after");
+        const auto [error, messages] = Decode(stream);
+        Check(error == WebSocketError::ProtocolError && messages == TMessages{"1:before"}, "nothing after an error");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, std::string(100, 'x'));
+        Check(Decode(stream, 99).first == WebSocketError::MessageTooBig, "message longer than the buffer");
+        Check(Decode(stream, 100).first == WebSocketError::None, "message as long as the buffer");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, std::string(60, 'x'), false);
+        AddFrame(stream, WebSocketOpcode::Continuation, std::string(60, 'x'));
+        Check(Decode(stream, 100).first == WebSocketError::MessageTooBig, "fragments longer than the buffer");
+
+        // Rejected by the header alone, the payload never arrives.
+        Check(Decode(Raw("\x82\x7F\x00\x00\x00\x01\x00\x00\x00\x00"sv)).first == WebSocketError::MessageTooBig,
+              "huge length");
+    }
+
+    struct SocketPair {
+        int Fds[2] = {-1, -1};
+
+        SocketPair() {
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, Fds) != 0) {
+                throw std::system_error(errno, std::generic_category(), "Failed to create a socket pair");
+            }
+        }
+
+        SocketPair(const SocketPair&) = delete;
+        SocketPair& operator=(const SocketPair&) = delete;
+
+        ~SocketPair() {
+            close(Fds[0]);
+            close(Fds[1]);
+        }
+    };
+
+    void WriteAll(int fd, const TBytes& bytes) {
+        std::size_t written = 0;
+        while (written < bytes.size()) {
+            const ssize_t result = write(fd, bytes.data() + written, bytes.size() - written);
+            if (result <= 0) {
+                return;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+    }
+
+    // The server side: reads the frames of the client until its Close, all of them must be masked.
+    TMessages ReadClientFrames(int fd) {
+        TMessages messages;
+        TBytes received(1 << 16);
+        TBytes fragments(1 << 10);
+        WebSocketDecoder decoder(fragments);
+        std::size_t size = 0;
+
+        while (!decoder.IsClosed() && decoder.Error() == WebSocketError::None) {
+            const ssize_t result = read(fd, received.data() + size, received.size() - size);
+            if (result <= 0) {
+                break;
+            }
+
+            size += static_cast<std::size_t>(result);
+
+            // The buffer always starts with a frame, its second byte has the MASK bit.
+            const std::span<std::byte> input(received.data(), size);
+            Check(size < 2 || (std::to_integer<int>(input[1]) & 0x80) != 0, "frames of the client are masked");
+
+            const auto decoded = decoder.Decode(input, [&](const WebSocketMessage& message) {
+                messages.push_back(Describe(message));
+            });
+            std::memmove(received.data(), received.data() + decoded.Consumed, size - decoded.Consumed);
+            size -= decoded.Consumed;
+        }
+
+        return messages;
+    }
+
+    void CheckLoopback() {
+        constexpr int MessagesCount = 2000;
+
+        SocketPair pair;
+        TMessages expected;
+        TMessages replies;
+
+        std::jthread server([&]() {
+            TBytes stream;
+            for (int index = 0; index < MessagesCount; ++index) {
+                AddFrame(stream, WebSocketOpcode::Text, "message " + std::to_string(index));
+                if (index % 100 == 0) {
+                    AddFrame(stream, WebSocketOpcode::Ping, std::to_string(index));
+                    expected.push_back("10:" + std::to_string(index));
+                }
+            }
+            AddFrame(stream, WebSocketOpcode::Close, "\x03\xE8");
+            expected.emplace_back("8:\x03\xE8");
+
+            WriteAll(pair.Fds[0], stream);
+            replies = ReadClientFrames(pair.Fds[0]);
+        });
+
+        WebSocketStream client(pair.Fds[1], 4096);
+        int received = 0;
+        bool ordered = true;
+        while (client.Poll([&](const WebSocketMessage& message) {
+            ordered &= message.Text() == "message " + std::to_string(received++);
+        })) {
+        }
+        server.join();
+
+        Check(received == MessagesCount && ordered, "loopback: every message in order");
+        Check(replies == expected, "loopback: pongs and the echoed Close");
+        Check(!client.IsOpen(), "loopback: closed after the Close of the server");
+    }
+
+    // The server sends `stream` and closes its side, returns the frames of the client.
+    TMessages RunClient(const TBytes& stream, WebSocketError expectedError, const std::string& what) {
+        SocketPair pair;
+        WriteAll(pair.Fds[0], stream);
+        shutdown(pair.Fds[0], SHUT_WR);
+
+        WebSocketStream client(pair.Fds[1], 256);
+        std::size_t delivered = 0;
+        while (client.Poll([&](const WebSocketMessage&) {
+            ++delivered;
+        })) {
+        }
+
+        Check(!client.IsOpen() && client.Error() == expectedError, what + ": closed with the error");
+        Check(delivered == 1, what + ": only the message before the error is delivered");
+
+        shutdown(pair.Fds[1], SHUT_WR);
+        return ReadClientFrames(pair.Fds[0]);
+    }
+
+    void CheckStreamErrors() {
+        TBytes stream;
+        AddFrame(stream, WebSocketOpcode::Text, "fine");
+        AddFrame(stream, WebSocketOpcode::Text, std::string(300, 'x'));
+        Check(RunClient(stream, WebSocketError::MessageTooBig, "too big") == TMessages{"8:\x03\xF1"},
+              "too big: closed with status 1009");
+
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, "fine");
+        AddFrame(stream, WebSocketOpcode::Continuation, "x");
+        Check(RunClient(stream, WebSocketError::ProtocolError, "protocol error") == TMessages{"8:\x03\xEA"},
+              "protocol error: closed with status 1002");
+
+        // The server goes away without a Close.
+        stream.clear();
+        AddFrame(stream, WebSocketOpcode::Text, "fine");
+        Check(RunClient(stream, WebSocketError::None, "end of stream").empty(), "end of stream: nothing is sent");
+    }
+
+}
+
+int main() {
+    CheckChunking();
+    CheckErrors();
+    CheckLoopback();
+    CheckStreamErrors();
+
+    return Tests::Result();
+}
@@ -0,0 +1,241 @@
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "src/order_book.h"
+#include "src/tick_ladder.h"
+#include "src/utils/varint.h"
+#include "src/wire/wire_decoder.h"
+#include "src/wire/wire_encoder.h"
+#include "check.h"
+
+/*
+ * Wire format: varints and zigzag encoding round trip and overlong or truncated varints are rejected.
+ * A book rebuilt from snapshots and deltas of a random stream equals the encoded one whenever the decoder
+ * is in sync, lost messages are detected as gaps and healed by the next snapshot, duplicates are stale,
+ * and every truncation of a message is malformed and leaves the book untouched.
+*/
+
+namespace {
+
+    using namespace OrderBook;
+    using Tests::Check;
+
+    using TPriceTicks = DecimalTicks<100>;
+    using TQuantityLots = DecimalTicks<1000>;
+    using TProducer = BinanceBook<>;
+    // Levels of a side are the best order and up to PriceLevels + 1 stored orders under it.
+    using TConsumer = BinanceBook<double, double, 21>;
+    using TPriceQuantity = Models::PriceQuantity<double, double>;
+
+    void CheckVarints() {
+        for (std::int64_t value = -300; value <= 300; ++value) {
+            Check(Utils::ZigZagDecode(Utils::ZigZagEncode(value)) == value, "zigzag round trip of " + std::to_string(value));
+        }
+
+        for (const std::uint64_t value : {0ULL, 127ULL, 128ULL, 300ULL, 1ULL << 63, ~0ULL}) {
+            std::array<std::byte, Utils::MaxVarintSize> buffer{};
+            const auto* end = Utils::WriteVarint(buffer.data(), value);
+            const std::byte* position = buffer.data();
+            Check(Utils::ReadVarint(position, end) == value && position == end, "varint round trip of " + std::to_string(value));
+
+            for (const std::byte* cut = buffer.data(); cut != end; ++cut) {
+                position = buffer.data();
+                Check(!Utils::ReadVarint(position, cut).has_value(), "truncated varint of " + std::to_string(value));
+            }
+        }
+
+        // The 10th byte may carry only the highest bit, anything else doesn't fit into 64 bits.
+        std::array<std::byte, Utils::MaxVarintSize + 1> overlong{};
+        overlong.fill(std::byte{0xFF});
+        for (const auto last : {std::byte{0x02}, std::byte{0x7F}, std::byte{0x81}}) {
+            overlong[Utils::MaxVarintSize - 1] = last;
+            overlong[Utils::MaxVarintSize] = std::byte{0x00};
+            const std::byte* position = overlong.data();
+            Check(!Utils::ReadVarint(position, overlong.data() + overlong.size()).has_value(),
+                  "varint with the 10th byte " + std::to_string(std::to_integer<int>(last)));
+        }
+    }
+
+    template <typename TLhs, typename TRhs>
+    bool Equal(const TLhs& lhs, const TRhs& rhs) {
+        auto left = lhs.begin();
+        auto right = rhs.begin();
+        for (; left != lhs.end() && right != rhs.end(); ++left, ++right) {
+            if ((*left).Price != (*right).Price || (*left).Quantity != (*right).Quantity) {
+                return false;
+            }
+        }
+
+        return left == lhs.end() && right == rhs.end();
+    }
+
+    bool SameBooks(const TProducer& producer, const TConsumer& consumer) {
+        const auto [producerBids, producerAsks] = producer.Levels();
+        const auto [consumerBids, consumerAsks] = consumer.Levels();
+        return Equal(producerBids, consumerBids) && Equal(producerAsks, consumerAsks);
+    }
+
+    class Stream {
+        std::mt19937 Random_{7};
+
+    public:
+        int Uniform(int from, int to) {
+            return std::uniform_int_distribution<int>(from, to)(Random_);
+        }
+
+        double BidPrice() {
+            return std::round((100 - Uniform(0, 40) * 0.01) * 100) / 100;
+        }
+
+        double AskPrice() {
+            return std::round((100.01 + Uniform(0, 40) * 0.01) * 100) / 100;
+        }
+
+        std::vector<TPriceQuantity> Levels(bool bids) {
+            std::vector<TPriceQuantity> levels(static_cast<std::size_t>(Uniform(0, 6)));
+            for (auto& level : levels) {
+                level = {
+                    .Price = bids ? BidPrice() : AskPrice(),
+                    .Quantity = Uniform(0, 3) == 0 ? 0.0 : Uniform(1, 9000) / 1000.0,
+                };
+            }
+
+            return levels;
+        }
+
+        void Update(TProducer& book) {
+            const int operation = Uniform(0, 99);
+            if (operation < 85) {
+                book.DepthUpdate(Levels(true), Levels(false));
+            } else if (operation < 97) {
+                book.BBOUpdate({
+                    .BestBidPrice = BidPrice(),
+                    .BestBidQty = static_cast<double>(Uniform(1, 9)),
+                    .BestAskPrice = AskPrice(),
+                    .BestAskQty = static_cast<double>(Uniform(1, 9)),
+                });
+            } else if (operation < 99) {
+                book.Replace(Levels(true), Levels(false));
+            } else {
+                book.Clear();
+            }
+        }
+    };
+
+    void CheckRoundTrip() {
+        constexpr int StepsCount = 50000;
+        constexpr int SnapshotInterval = 500;
+
+        Stream stream;
+        TProducer producer;
+        TConsumer consumer;
+        std::vector<TProducer::TLevelEventBuffer::TLevelEvent> storage(256);
+        TProducer::TLevelEventBuffer events(storage);
+        producer.EmitLevelEventsTo(&events);
+
+        Wire::WireEncoder<double, double, TPriceTicks, TQuantityLots> encoder;
+        Wire::WireDecoder<double, double, TPriceTicks, TQuantityLots> decoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(256));
+
+        std::size_t mismatches = 0;
+        std::size_t malformed = 0;
+        std::size_t lost = 0;
+        std::size_t gaps = 0;
+        std::size_t unexpectedStatuses = 0;
+        bool missedSinceSnapshot = false;
+
+        for (int step = 0; step < StepsCount; ++step) {
+            events.Clear();
+            stream.Update(producer);
+
+            const bool snapshot = events.NeedsResync() || step % SnapshotInterval == 0;
+            const std::size_t size = snapshot ? encoder.EncodeSnapshot(producer, buffer)
+                                              : encoder.EncodeDelta(producer, events.Events(), buffer);
+            const std::span<const std::byte> message(buffer.data(), size);
+            missedSinceSnapshot &= !snapshot;
+
+            // Lose a message now and then, the decoder must notice it at the next delta.
+            if (stream.Uniform(0, 999) == 0) {
+                ++lost;
+                missedSinceSnapshot = true;
+                continue;
+            }
+
+            const auto status = decoder.Apply(message, consumer);
+            malformed += status == Wire::DecodeStatus::Malformed;
+            gaps += status == Wire::DecodeStatus::Gap;
+            unexpectedStatuses += missedSinceSnapshot ? status == Wire::DecodeStatus::Applied
+                                                      : status != Wire::DecodeStatus::Applied;
+
+            if (status == Wire::DecodeStatus::Applied) {
+                Check(decoder.Apply(message, consumer) == Wire::DecodeStatus::Stale, "a duplicate message is stale");
+            }
+
+            if (decoder.IsSynced()) {
+                mismatches += !SameBooks(producer, consumer);
+            }
+        }
+
+        Check(lost != 0 && gaps != 0, "some messages are lost and detected as gaps");
+        Check(malformed == 0, "no message of the stream is malformed");
+        Check(unexpectedStatuses == 0, "deltas are applied exactly until a message is lost and again after a snapshot");
+        Check(mismatches == 0, "the decoded book equals the encoded one while in sync");
+    }
+
+    void CheckTruncated() {
+        Stream stream;
+        TProducer producer;
+        std::vector<TProducer::TLevelEventBuffer::TLevelEvent> storage(256);
+        TProducer::TLevelEventBuffer events(storage);
+        producer.EmitLevelEventsTo(&events);
+        producer.DepthUpdate(stream.Levels(true), stream.Levels(false));
+
+        Wire::WireEncoder<double, double, TPriceTicks, TQuantityLots> encoder;
+        Wire::WireDecoder<double, double, TPriceTicks, TQuantityLots> decoder;
+        std::vector<std::byte> buffer(Wire::MaxMessageSize(256));
+        TConsumer consumer;
+
+        const std::size_t snapshotSize = encoder.EncodeSnapshot(producer, buffer);
+        for (std::size_t cut = 0; cut < snapshotSize; ++cut) {
+            Check(decoder.Apply(std::span<const std::byte>(buffer.data(), cut), consumer) == Wire::DecodeStatus::Malformed,
+                  "snapshot truncated to " + std::to_string(cut) + " bytes is malformed");
+        }
+        Check(consumer.IsEmpty(), "truncated snapshots leave the book untouched");
+        Check(decoder.Apply(std::span<const std::byte>(buffer.data(), snapshotSize), consumer) == Wire::DecodeStatus::Applied,
+              "the whole snapshot is applied");
+
+        events.Clear();
+        producer.DepthUpdate(std::vector<TPriceQuantity>{{.Price = 99.5, .Quantity = 1.5}, {.Price = 99.4, .Quantity = 2}},
+                             std::vector<TPriceQuantity>{{.Price = 100.5, .Quantity = 3}});
+        const std::size_t deltaSize = encoder.EncodeDelta(producer, events.Events(), buffer);
+        const auto [bidsBefore, asksBefore] = consumer.Levels();
+        const std::vector<TPriceQuantity> bids(bidsBefore.begin(), bidsBefore.end());
+        const std::vector<TPriceQuantity> asks(asksBefore.begin(), asksBefore.end());
+
+        for (std::size_t cut = 0; cut < deltaSize; ++cut) {
+            Check(decoder.Apply(std::span<const std::byte>(buffer.data(), cut), consumer) == Wire::DecodeStatus::Malformed,
+                  "delta truncated to " + std::to_string(cut) + " bytes is malformed");
+        }
+
+        const auto [bidsAfter, asksAfter] = consumer.Levels();
+        Check(Equal(bids, bidsAfter) && Equal(asks, asksAfter), "truncated deltas leave the book untouched");
+        Check(decoder.Apply(std::span<const std::byte>(buffer.data(), deltaSize), consumer) == Wire::DecodeStatus::Applied,
+              "the whole delta is applied after the truncated ones");
+        Check(SameBooks(producer, consumer), "the book equals the encoded one after the delta");
+    }
+
+}
+
+int main() {
+    CheckVarints();
+    CheckRoundTrip();
+    CheckTruncated();
+
+    return Tests::Result();
+}
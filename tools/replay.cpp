@@ -0,0 +1,182 @@
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include "src/order_book.h"
+#include "src/capture/capture_reader.h"
+#include "src/capture/capture_writer.h"
+#include "src/utils/checksum.h"
+
+/*
+ * Replays a capture of book updates as fast as possible and reports the throughput together with
+ * the checksum of the final books, so runs over the same capture can be compared.
+ *
+ *   BinanceBook_replay <capture> [passes]
+ *   BinanceBook_replay --synthesize <capture> [records] [symbols]
+ *
+ * Every pass replays the whole capture into empty books, the checksum is taken after the last pass.
+ * --synthesize writes a random-walk capture to have something to replay without a recorded stream.
+*/
+
+namespace {
+
+    using TPrice = double;
+    using TQuantity = double;
+    using TBook = OrderBook::BinanceBook<TPrice, TQuantity, 20>;
+    using TPriceQuantity = OrderBook::Models::PriceQuantity<TPrice, TQuantity>;
+
+    constexpr std::size_t PriceLevels = 20;
+    constexpr double TickSize = 0.01;
+
+    int Synthesize(const std::string& path, std::uint64_t recordsCount, std::uint32_t symbolsCount) {
+        OrderBook::Capture::CaptureWriter<TPrice, TQuantity> writer(path);
+
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> step(-2, 2);
+        std::uniform_int_distribution<int> gap(1, 4);
+        std::uniform_int_distribution<int> lots(1, 100000);
+        std::uniform_int_distribution<std::uint32_t> symbol(0, symbolsCount - 1);
+        std::uniform_int_distribution<int> kind(0, 4);
+
+        std::vector<std::int64_t> midTicks(symbolsCount, 2007870);
+        std::vector<TPriceQuantity> bids(PriceLevels);
+        std::vector<TPriceQuantity> asks(PriceLevels);
+        std::uint64_t timestamp = 0;
+
+        for (std::uint64_t record = 0; record < recordsCount; ++record) {
+            const auto id = symbol(random);
+            auto& mid = midTicks[id];
+            mid += step(random);
+            timestamp += 50'000;
+
+            // Book tickers come several times more often than depth updates.
+            if (kind(random) != 0) {
+                writer.WriteBBO(timestamp, id, {
+                    .BestBidPrice = static_cast<double>(mid - 1) * TickSize,
+                    .BestBidQty = lots(random) * 1e-5,
+                    .BestAskPrice = static_cast<double>(mid + 1) * TickSize,
+                    .BestAskQty = lots(random) * 1e-5,
+                });
+                continue;
+            }
+
+            std::int64_t bidTicks = mid - 1;
+            std::int64_t askTicks = mid + 1;
+            for (std::size_t level = 0; level < PriceLevels; ++level) {
+                bids[level] = {.Price = static_cast<double>(bidTicks) * TickSize, .Quantity = lots(random) * 1e-5};
+                asks[level] = {.Price = static_cast<double>(askTicks) * TickSize, .Quantity = lots(random) * 1e-5};
+                bidTicks -= gap(random);
+                askTicks += gap(random);
+            }
+
+            writer.WriteDepth(timestamp, id, bids, asks);
+        }
+
+        writer.Flush();
+        std::cout << boost::format("Written %d records for %d symbols to %s\n") % writer.RecordsCount() % symbolsCount % path;
+
+        return 0;
+    }
+
+    int Replay(const std::string& path, std::uint64_t passes) {
+        const OrderBook::Capture::CaptureReader<TPrice, TQuantity> reader(path);
+
+        std::vector<std::unique_ptr<TBook>> books;
+        std::uint64_t depthCount = 0;
+        std::uint64_t bboCount = 0;
+
+        // Books are created up front, so the timed loop only applies updates.
+        for (const auto& record : reader) {
+            if (record.SymbolId >= books.size()) {
+                books.resize(record.SymbolId + 1);
+            }
+            if (books[record.SymbolId] == nullptr) {
+                books[record.SymbolId] = std::make_unique<TBook>();
+            }
+
+            (record.Type == OrderBook::Models::UpdateType::Depth ? depthCount : bboCount) += 1;
+        }
+
+        std::chrono::steady_clock::duration elapsed{};
+
+        for (std::uint64_t pass = 0; pass < passes; ++pass) {
+            for (auto& book : books) {
+                if (book != nullptr) {
+                    book->Clear();
+                }
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            for (const auto& record : reader) {
+                OrderBook::Capture::ApplyRecord(*books[record.SymbolId], record);
+            }
+            elapsed += std::chrono::steady_clock::now() - start;
+        }
+
+        std::uint64_t checksum = OrderBook::Utils::Fnv1aOffsetBasis;
+        for (const auto& book : books) {
+            checksum = OrderBook::Utils::Fnv1a(book != nullptr ? OrderBook::Utils::BookChecksum(*book) : 0, checksum);
+        }
+
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        const double updates = static_cast<double>((depthCount + bboCount) * passes);
+
+        std::cout << boost::format("Records:  %d (%d depth, %d BBO), %d symbols, %.1f MB\n")
+                     % (depthCount + bboCount) % depthCount % bboCount % books.size() % (reader.Size() / 1e6);
+        std::cout << boost::format("Passes:   %d in %.3f s\n") % passes % seconds;
+        std::cout << boost::format("Rate:     %.0f updates/s, %.1f ns/update\n")
+                     % (updates / seconds) % (seconds * 1e9 / updates);
+        std::cout << boost::format("Checksum: %016x\n") % checksum;
+
+        return 0;
+    }
+
+    int Usage() {
+        std::cerr << "Usage: BinanceBook_replay <capture> [passes]\n"
+                     "       BinanceBook_replay --synthesize <capture> [records] [symbols]\n";
+        return 2;
+    }
+
+}
+
+int main(int argc, char* argv[]) {
+    const std::vector<std::string> args(argv + 1, argv + argc);
+
+    try {
+        if (!args.empty() && args[0] == "--synthesize") {
+            if (args.size() < 2) {
+                return Usage();
+            }
+
+            const std::uint64_t records = args.size() > 2 ? std::stoull(args[2]) : 1'000'000;
+            const auto symbols = static_cast<std::uint32_t>(args.size() > 3 ? std::stoul(args[3]) : 16);
+            if (symbols == 0) {
+                return Usage();
+            }
+
+            return Synthesize(args[1], records, symbols);
+        }
+
+        if (args.empty()) {
+            return Usage();
+        }
+
+        const std::uint64_t passes = args.size() > 1 ? std::stoull(args[1]) : 1;
+        if (passes == 0) {
+            return Usage();
+        }
+
+        return Replay(args[0], passes);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}